@@ -0,0 +1,53 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef ASSET_HANDLE_HPP
+#define ASSET_HANDLE_HPP
+
+#include <limits>
+
+namespace m2g {
+
+const unsigned int INVALID_ASSET_INDEX = std::numeric_limits< unsigned int >::max();
+
+// Stable reference to a library entry, resolved from its name once (see
+// GraphicsLibrary::tilesetHandle()). It is just an index into the library
+// tables, typed so tileset and animation handles can't be mixed up.
+template < class Asset >
+struct AssetHandle
+{
+    AssetHandle() : index( INVALID_ASSET_INDEX ) {}
+    explicit AssetHandle( unsigned int index ) : index( index ) {}
+
+    bool valid() const { return index != INVALID_ASSET_INDEX; }
+    bool operator == ( const AssetHandle& b ) const { return index == b.index; }
+    bool operator != ( const AssetHandle& b ) const { return index != b.index; }
+
+    unsigned int index;
+};
+
+class Tileset;
+class AnimationData;
+
+typedef AssetHandle< Tileset > TilesetHandle;
+typedef AssetHandle< AnimationData > AnimationHandle;
+
+} // namespace m2g
+
+#endif // ASSET_HANDLE_HPP
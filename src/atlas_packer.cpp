@@ -0,0 +1,281 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "atlas_packer.hpp"
+#include "utilities/path.hpp"
+#include "utilities/skyline_packer.hpp"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace m2g {
+
+const unsigned int AtlasPacker::UNPACKED_PAGE =
+        std::numeric_limits< unsigned int >::max();
+
+
+/***
+ * 1. Construction
+ ***/
+
+AtlasPacker::AtlasPacker( unsigned int pageSize, unsigned int padding ) :
+    pageSize_( pageSize ),
+    padding_( padding )
+{}
+
+
+/***
+ * 2. Packing
+ ***/
+
+unsigned int AtlasPacker::pack( const std::string& libraryPath,
+                                const std::string& outputLibraryPath )
+{
+    tinyxml2::XMLDocument libraryFile;
+    if( libraryFile.LoadFile( libraryPath.c_str() ) != tinyxml2::XML_SUCCESS ){
+        throw std::runtime_error( "Couldn't load library [" + libraryPath + "]" );
+    }
+
+    tinyxml2::XMLElement* rootElement =
+            libraryFile.FirstChildElement( "library" );
+    if( rootElement == nullptr ){
+        throw std::runtime_error( "Library [" + libraryPath + "] has no <library> root" );
+    }
+
+    std::vector< tinyxml2::XMLElement* > tilesets;
+    collectTilesets( rootElement, tilesets );
+
+    std::vector< AtlasImage > images;
+    loadImages( tilesets, libraryPath, images );
+
+    const unsigned int nPages = packImages( images );
+
+    // Pages are named after the output library.
+    std::string outputName = outputLibraryPath;
+    const std::size_t slashPos = outputName.find_last_of( '/' );
+    if( slashPos != std::string::npos ){
+        outputName = outputName.substr( slashPos + 1 );
+    }
+    const std::size_t dotPos = outputName.find_last_of( '.' );
+    if( dotPos != std::string::npos ){
+        outputName = outputName.substr( 0, dotPos );
+    }
+    const std::string pagesSrcPrefix = outputName + "_atlas_";
+
+    savePages( images,
+               nPages,
+               getDirPath( outputLibraryPath ) + '/' + pagesSrcPrefix );
+    writeAtlasElements( libraryFile, tilesets, images, nPages, pagesSrcPrefix );
+
+    if( libraryFile.SaveFile( outputLibraryPath.c_str() ) != tinyxml2::XML_SUCCESS ){
+        throw std::runtime_error( "Couldn't save library [" + outputLibraryPath + "]" );
+    }
+
+    return nPages;
+}
+
+
+/***
+ * 3. Auxiliar methods
+ ***/
+
+void AtlasPacker::collectTilesets( tinyxml2::XMLElement* rootElement,
+                                   std::vector< tinyxml2::XMLElement* >& tilesets ) const
+{
+    tinyxml2::XMLElement* xmlElement =
+            rootElement->FirstChildElement( "tileset" );
+    while( xmlElement != nullptr ){
+        tilesets.push_back( xmlElement );
+        xmlElement = xmlElement->NextSiblingElement( "tileset" );
+    }
+
+    xmlElement = rootElement->FirstChildElement( "animation" );
+    while( xmlElement != nullptr ){
+        tinyxml2::XMLElement* tilesetElement =
+                xmlElement->FirstChildElement( "tileset" );
+        if( tilesetElement != nullptr ){
+            tilesets.push_back( tilesetElement );
+        }
+        xmlElement = xmlElement->NextSiblingElement( "animation" );
+    }
+}
+
+
+void AtlasPacker::loadImages( const std::vector< tinyxml2::XMLElement* >& tilesets,
+                              const std::string& libraryPath,
+                              std::vector< AtlasImage >& images ) const
+{
+    std::map< std::string, bool > loadedImages;
+
+    for( tinyxml2::XMLElement* tilesetElement : tilesets ){
+        const tinyxml2::XMLElement* srcElement =
+                tilesetElement->FirstChildElement( "src" );
+        if( srcElement == nullptr || srcElement->GetText() == nullptr ){
+            throw std::runtime_error( "<tileset> without <src>" );
+        }
+
+        // Tilesets sharing an image share its place in the atlas too.
+        const std::string src = srcElement->GetText();
+        if( loadedImages.count( src ) ){
+            continue;
+        }
+        loadedImages[src] = true;
+
+        AtlasImage atlasImage;
+        atlasImage.src = src;
+        if( !atlasImage.image.loadFromFile( resolvePath( libraryPath, src ) ) ){
+            throw std::runtime_error( "Couldn't load image [" + src + "]" );
+        }
+        images.push_back( atlasImage );
+    }
+}
+
+
+unsigned int AtlasPacker::packImages( std::vector< AtlasImage >& images ) const
+{
+    // Tallest images first: keeps the skyline flat.
+    std::stable_sort( images.begin(), images.end(),
+                      []( const AtlasImage& a, const AtlasImage& b ){
+                          return a.image.getSize().y > b.image.getSize().y;
+                      });
+
+    std::vector< SkylinePacker > pages;
+
+    for( AtlasImage& atlasImage : images ){
+        const sf::Vector2u size = atlasImage.image.getSize();
+        const unsigned int paddedWidth = std::min( size.x + padding_, pageSize_ );
+        const unsigned int paddedHeight = std::min( size.y + padding_, pageSize_ );
+
+        // Images bigger than a page are left out of the atlas.
+        atlasImage.page = UNPACKED_PAGE;
+        if( size.x > pageSize_ || size.y > pageSize_ ){
+            continue;
+        }
+
+        for( unsigned int page = 0; page < pages.size(); page++ ){
+            if( pages[page].insert( paddedWidth, paddedHeight, atlasImage.position ) ){
+                atlasImage.page = page;
+                break;
+            }
+        }
+
+        if( atlasImage.page == UNPACKED_PAGE ){
+            pages.push_back( SkylinePacker( pageSize_, pageSize_ ) );
+            pages.back().insert( paddedWidth, paddedHeight, atlasImage.position );
+            atlasImage.page = pages.size() - 1;
+        }
+    }
+
+    return pages.size();
+}
+
+
+void AtlasPacker::savePages( const std::vector< AtlasImage >& images,
+                             unsigned int nPages,
+                             const std::string& pagesPathPrefix ) const
+{
+    for( unsigned int page = 0; page < nPages; page++ ){
+        // Crop every page to its used area.
+        sf::Vector2u pageDimensions( 0, 0 );
+        for( const AtlasImage& atlasImage : images ){
+            if( atlasImage.page == page ){
+                pageDimensions.x = std::max( pageDimensions.x,
+                                             atlasImage.position.x + atlasImage.image.getSize().x );
+                pageDimensions.y = std::max( pageDimensions.y,
+                                             atlasImage.position.y + atlasImage.image.getSize().y );
+            }
+        }
+
+        sf::Image pageImage;
+        pageImage.create( pageDimensions.x, pageDimensions.y, sf::Color( 0, 0, 0, 0 ) );
+        for( const AtlasImage& atlasImage : images ){
+            if( atlasImage.page == page ){
+                pageImage.copy( atlasImage.image,
+                                atlasImage.position.x,
+                                atlasImage.position.y );
+            }
+        }
+
+        const std::string pagePath =
+                pagesPathPrefix + std::to_string( page ) + ".png";
+        if( !pageImage.saveToFile( pagePath ) ){
+            throw std::runtime_error( "Couldn't save atlas page [" + pagePath + "]" );
+        }
+    }
+}
+
+
+void AtlasPacker::writeAtlasElements( tinyxml2::XMLDocument& libraryFile,
+                                      const std::vector< tinyxml2::XMLElement* >& tilesets,
+                                      const std::vector< AtlasImage >& images,
+                                      unsigned int nPages,
+                                      const std::string& pagesSrcPrefix ) const
+{
+    tinyxml2::XMLElement* rootElement =
+            libraryFile.FirstChildElement( "library" );
+
+    // Drop the results of any previous packing.
+    tinyxml2::XMLElement* xmlElement =
+            rootElement->FirstChildElement( "atlas_page" );
+    while( xmlElement != nullptr ){
+        tinyxml2::XMLElement* nextElement =
+                xmlElement->NextSiblingElement( "atlas_page" );
+        rootElement->DeleteChild( xmlElement );
+        xmlElement = nextElement;
+    }
+
+    for( unsigned int page = nPages; page > 0; page-- ){
+        tinyxml2::XMLElement* pageElement =
+                libraryFile.NewElement( "atlas_page" );
+        pageElement->SetAttribute( "index", page - 1 );
+        pageElement->SetAttribute( "src",
+                                   ( pagesSrcPrefix + std::to_string( page - 1 ) + ".png" ).c_str() );
+        rootElement->InsertFirstChild( pageElement );
+    }
+
+    std::map< std::string, const AtlasImage* > imagesBySrc;
+    for( const AtlasImage& atlasImage : images ){
+        imagesBySrc[atlasImage.src] = &atlasImage;
+    }
+
+    for( tinyxml2::XMLElement* tilesetElement : tilesets ){
+        tinyxml2::XMLElement* atlasElement =
+                tilesetElement->FirstChildElement( "atlas" );
+        if( atlasElement != nullptr ){
+            tilesetElement->DeleteChild( atlasElement );
+        }
+
+        const AtlasImage& atlasImage =
+                *( imagesBySrc.at( tilesetElement->FirstChildElement( "src" )->GetText() ) );
+        if( atlasImage.page == UNPACKED_PAGE ){
+            continue;
+        }
+
+        atlasElement = libraryFile.NewElement( "atlas" );
+        atlasElement->SetAttribute( "page", atlasImage.page );
+        atlasElement->SetAttribute( "x", atlasImage.position.x );
+        atlasElement->SetAttribute( "y", atlasImage.position.y );
+        atlasElement->SetAttribute( "width", atlasImage.image.getSize().x );
+        atlasElement->SetAttribute( "height", atlasImage.image.getSize().y );
+        tilesetElement->InsertEndChild( atlasElement );
+    }
+}
+
+} // namespace m2g
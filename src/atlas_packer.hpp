@@ -0,0 +1,100 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef ATLAS_PACKER_HPP
+#define ATLAS_PACKER_HPP
+
+#include <tinyxml2.h>
+#include <SFML/Graphics/Image.hpp>
+#include <string>
+#include <vector>
+
+namespace m2g {
+
+const unsigned int DEFAULT_ATLAS_PAGE_SIZE = 2048;
+const unsigned int DEFAULT_ATLAS_PADDING = 1;
+
+// Offline packer which merges all the tileset images referenced by a library
+// into a few atlas pages. The output library is a copy of the input one where
+// every packed <tileset> has an <atlas page="" x="" y="" width="" height=""/>
+// child, and the <library> root lists the generated pages as
+// <atlas_page index="" src=""/> elements.
+class AtlasPacker
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        AtlasPacker( unsigned int pageSize = DEFAULT_ATLAS_PAGE_SIZE,
+                     unsigned int padding = DEFAULT_ATLAS_PADDING );
+
+
+        /***
+         * 2. Packing
+         ***/
+        // Packs the library at libraryPath and writes the result to
+        // outputLibraryPath. Atlas pages are saved next to the output library
+        // as <output_name>_atlas_<n>.png. The output library must be in the
+        // same directory as the input one so <src> paths keep resolving.
+        // Returns the number of atlas pages generated.
+        unsigned int pack( const std::string& libraryPath,
+                           const std::string& outputLibraryPath );
+
+
+    private:
+        static const unsigned int UNPACKED_PAGE;
+
+        struct AtlasImage
+        {
+            std::string src;
+            sf::Image image;
+            unsigned int page;
+            sf::Vector2u position;
+        };
+
+
+        /***
+         * 3. Auxiliar methods
+         ***/
+        void collectTilesets( tinyxml2::XMLElement* rootElement,
+                              std::vector< tinyxml2::XMLElement* >& tilesets ) const;
+        void loadImages( const std::vector< tinyxml2::XMLElement* >& tilesets,
+                         const std::string& libraryPath,
+                         std::vector< AtlasImage >& images ) const;
+        unsigned int packImages( std::vector< AtlasImage >& images ) const;
+        void savePages( const std::vector< AtlasImage >& images,
+                        unsigned int nPages,
+                        const std::string& pagesPathPrefix ) const;
+        void writeAtlasElements( tinyxml2::XMLDocument& libraryFile,
+                                 const std::vector< tinyxml2::XMLElement* >& tilesets,
+                                 const std::vector< AtlasImage >& images,
+                                 unsigned int nPages,
+                                 const std::string& pagesSrcPrefix ) const;
+
+
+        /***
+         * Attributes
+         ***/
+        unsigned int pageSize_;
+        unsigned int padding_;
+};
+
+} // namespace m2g
+
+#endif // ATLAS_PACKER_HPP
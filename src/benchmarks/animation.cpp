@@ -0,0 +1,52 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include "../drawables/animation.hpp"
+
+namespace m2g {
+
+const unsigned int N_ANIMATIONS = 100000;
+
+void addAnimationBenchmarks( BenchmarkRunner& runner )
+{
+    runner.add( "Animation/update/100k", N_ANIMATIONS, [](){
+        std::shared_ptr< AnimationData > animationData(
+                    new AnimationData( Tileset( BENCHMARK_IMAGE_PATH, 32, 32 ), 10 ) );
+        animationData->addState( AnimationState( 0, 3, 0 ) );
+
+        std::shared_ptr< std::vector< AnimationPtr > > animations( new std::vector< AnimationPtr > );
+        animations->reserve( N_ANIMATIONS );
+        for( unsigned int i = 0; i < N_ANIMATIONS; i++ ){
+            animations->emplace_back( new Animation( *animationData ) );
+        }
+
+        // 16 ms per frame at 60 fps.
+        return BenchmarkBody( [=]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                for( const AnimationPtr& animation : *animations ){
+                    animation->update( 16 );
+                }
+            }
+            doNotOptimize( animations->back()->currentFrame() );
+        });
+    });
+}
+
+} // namespace m2g
@@ -0,0 +1,212 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+#ifndef M2G_BENCHMARKS_DATA_DIR
+#define M2G_BENCHMARKS_DATA_DIR "../tests/data"
+#endif
+
+namespace m2g {
+
+const char* BENCHMARK_IMAGE_PATH = M2G_BENCHMARKS_DATA_DIR "/tileset_w64_h64.png";
+
+
+/***
+ * 1. Construction
+ ***/
+
+BenchmarkRunner::BenchmarkRunner( double minSampleTime, unsigned int nSamples ) :
+    minSampleTime_( minSampleTime ),
+    nSamples_( nSamples )
+{}
+
+
+/***
+ * 2. Registration
+ ***/
+
+void BenchmarkRunner::add( const std::string& name,
+                           unsigned int itemsPerIteration,
+                           BenchmarkSetup setup )
+{
+    benchmarks_.push_back( { name, itemsPerIteration, setup } );
+}
+
+
+/***
+ * 3. Running
+ ***/
+
+std::vector< BenchmarkResult > BenchmarkRunner::run( const std::string& filter,
+                                                     std::ostream& log )
+{
+    typedef std::chrono::steady_clock Clock;
+    std::vector< BenchmarkResult > results;
+
+    for( const Benchmark& benchmark : benchmarks_ ){
+        if( benchmark.name.find( filter ) == std::string::npos ){
+            continue;
+        }
+
+        BenchmarkBody body = benchmark.setup();
+        auto measure = [&]( unsigned int nIterations ){
+            const Clock::time_point start = Clock::now();
+            body( nIterations );
+            return std::chrono::duration< double >( Clock::now() - start ).count();
+        };
+
+        // Calibration: grow the number of iterations until a sample lasts
+        // long enough.
+        unsigned int nIterations = 1;
+        double elapsed = measure( nIterations );
+        while( elapsed < minSampleTime_ && nIterations < ( 1u << 30 ) ){
+            const double factor =
+                    ( elapsed > 0.0 ) ? std::min( 10.0, 1.5 * minSampleTime_ / elapsed ) : 10.0;
+            nIterations = std::max( nIterations + 1,
+                                    static_cast< unsigned int >( nIterations * factor ) );
+            elapsed = measure( nIterations );
+        }
+
+        std::vector< double > samples;
+        for( unsigned int i = 0; i < nSamples_; i++ ){
+            samples.push_back( measure( nIterations ) * 1e9 / nIterations );
+        }
+
+        BenchmarkResult result;
+        result.name = benchmark.name;
+        result.itemsPerIteration = benchmark.itemsPerIteration;
+        result.iterationsPerSample = nIterations;
+        result.nSamples = nSamples_;
+        result.meanNs = 0.0;
+        result.minNs = samples.front();
+        for( double sample : samples ){
+            result.meanNs += sample / samples.size();
+            result.minNs = std::min( result.minNs, sample );
+        }
+        result.stddevNs = 0.0;
+        for( double sample : samples ){
+            result.stddevNs += ( sample - result.meanNs ) * ( sample - result.meanNs ) / samples.size();
+        }
+        result.stddevNs = std::sqrt( result.stddevNs );
+
+        log << std::left << std::setw( 56 ) << result.name
+            << std::right << std::setw( 14 ) << std::fixed << std::setprecision( 1 )
+            << result.meanNs << " ns/iter"
+            << std::setw( 12 ) << result.meanNs / result.itemsPerIteration << " ns/item"
+            << " (+/- " << result.stddevNs << ")" << std::endl;
+
+        results.push_back( result );
+    }
+
+    return results;
+}
+
+
+/***
+ * 4. Output
+ ***/
+
+void BenchmarkRunner::writeJSON( const std::vector< BenchmarkResult >& results,
+                                 std::ostream& out )
+{
+    out << "{" << std::endl
+        << "  \"benchmarks\": [" << std::endl;
+
+    for( unsigned int i = 0; i < results.size(); i++ ){
+        const BenchmarkResult& result = results[i];
+        out << std::fixed << std::setprecision( 3 )
+            << "    {"
+            << " \"name\": \"" << result.name << "\","
+            << " \"items_per_iteration\": " << result.itemsPerIteration << ","
+            << " \"iterations_per_sample\": " << result.iterationsPerSample << ","
+            << " \"samples\": " << result.nSamples << ","
+            << " \"mean_ns\": " << result.meanNs << ","
+            << " \"min_ns\": " << result.minNs << ","
+            << " \"stddev_ns\": " << result.stddevNs << ","
+            << " \"mean_ns_per_item\": " << result.meanNs / result.itemsPerIteration
+            << " }" << ( ( i + 1 < results.size() ) ? "," : "" ) << std::endl;
+    }
+
+    out << "  ]" << std::endl
+        << "}" << std::endl;
+}
+
+
+/***
+ * Benchmark data
+ ***/
+
+void generateLibrary( const std::string& libraryPath,
+                      unsigned int nTilesets,
+                      unsigned int nAnimations )
+{
+    std::string dirPath = ".";
+    const std::size_t slashPos = libraryPath.find_last_of( '/' );
+    if( slashPos != std::string::npos ){
+        dirPath = libraryPath.substr( 0, slashPos );
+    }
+
+    // The library references the image by a path relative to itself.
+    std::ifstream srcImage( BENCHMARK_IMAGE_PATH, std::ios::binary );
+    std::ofstream dstImage( dirPath + "/benchmark_tileset.png", std::ios::binary );
+    if( !srcImage.is_open() || !dstImage.is_open() ){
+        throw std::runtime_error( "Couldn't copy the benchmark image" );
+    }
+    dstImage << srcImage.rdbuf();
+
+    std::ofstream file( libraryPath );
+    if( !file.is_open() ){
+        throw std::runtime_error( "Couldn't write [" + libraryPath + "]" );
+    }
+
+    file << "<?xml version=\"1.0\"?>" << std::endl
+         << "<library>" << std::endl;
+    for( unsigned int i = 0; i < nTilesets; i++ ){
+        file << "\t<tileset>" << std::endl
+             << "\t\t<name>tileset_" << i << "</name>" << std::endl
+             << "\t\t<src>benchmark_tileset.png</src>" << std::endl
+             << "\t\t<tile_dimensions width=\"32\" height=\"32\"/>" << std::endl
+             << "\t\t<collision_rects>" << std::endl
+             << "\t\t\t<collision_rect tiles=\"all\" x=\"4\" y=\"4\" width=\"24\" height=\"24\" />" << std::endl
+             << "\t\t\t<collision_rect tiles=\"1-2\" x=\"0\" y=\"0\" width=\"8\" height=\"8\" />" << std::endl
+             << "\t\t</collision_rects>" << std::endl
+             << "\t</tileset>" << std::endl;
+    }
+    for( unsigned int i = 0; i < nAnimations; i++ ){
+        file << "\t<animation fps=\"10\">" << std::endl
+             << "\t\t<tileset>" << std::endl
+             << "\t\t\t<name>animation_" << i << "</name>" << std::endl
+             << "\t\t\t<src>benchmark_tileset.png</src>" << std::endl
+             << "\t\t\t<tile_dimensions width=\"32\" height=\"32\"/>" << std::endl
+             << "\t\t</tileset>" << std::endl
+             << "\t\t<animation_states>" << std::endl
+             << "\t\t\t<animation_state first_frame=\"0\" last_frame=\"3\" back_frame=\"0\" />" << std::endl
+             << "\t\t</animation_states>" << std::endl
+             << "\t</animation>" << std::endl;
+    }
+    file << "</library>" << std::endl;
+}
+
+} // namespace m2g
@@ -0,0 +1,134 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace m2g {
+
+// Measured body of a benchmark: runs the measured operation nIterations
+// times.
+typedef std::function< void( unsigned int nIterations ) > BenchmarkBody;
+
+// Prepares the benchmark data (not measured) and returns its body.
+typedef std::function< BenchmarkBody() > BenchmarkSetup;
+
+struct BenchmarkResult
+{
+    std::string name;
+    unsigned int itemsPerIteration;
+    unsigned int iterationsPerSample;
+    unsigned int nSamples;
+    double meanNs;
+    double minNs;
+    double stddevNs;
+};
+
+
+// Minimal microbenchmark runner. Every benchmark is calibrated so each
+// sample lasts at least minSampleTime, then measured nSamples times. Results
+// are given in nanoseconds per iteration and written as JSON, so they can be
+// compared across commits.
+class BenchmarkRunner
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        BenchmarkRunner( double minSampleTime = 0.1,
+                         unsigned int nSamples = 5 );
+
+
+        /***
+         * 2. Registration
+         ***/
+        void add( const std::string& name,
+                  unsigned int itemsPerIteration,
+                  BenchmarkSetup setup );
+
+
+        /***
+         * 3. Running
+         ***/
+        // Runs the benchmarks whose name contains filter.
+        std::vector< BenchmarkResult > run( const std::string& filter,
+                                            std::ostream& log );
+
+
+        /***
+         * 4. Output
+         ***/
+        static void writeJSON( const std::vector< BenchmarkResult >& results,
+                               std::ostream& out );
+
+
+    private:
+        struct Benchmark
+        {
+            std::string name;
+            unsigned int itemsPerIteration;
+            BenchmarkSetup setup;
+        };
+
+        double minSampleTime_;
+        unsigned int nSamples_;
+        std::vector< Benchmark > benchmarks_;
+};
+
+
+/***
+ * Benchmark registration functions
+ ***/
+void addGraphicsLibraryBenchmarks( BenchmarkRunner& runner );
+void addTilesetBenchmarks( BenchmarkRunner& runner );
+void addTileSpriteBenchmarks( BenchmarkRunner& runner );
+void addSpriteStoreBenchmarks( BenchmarkRunner& runner );
+void addRectBatchBenchmarks( BenchmarkRunner& runner );
+void addCollisionWorldBenchmarks( BenchmarkRunner& runner );
+void addTileLayerBenchmarks( BenchmarkRunner& runner );
+void addAnimationBenchmarks( BenchmarkRunner& runner );
+
+
+/***
+ * Benchmark data
+ ***/
+// Test image used by every benchmark (64x64 pixels).
+extern const char* BENCHMARK_IMAGE_PATH;
+
+// Writes a library with nTilesets tilesets and nAnimations animations to
+// libraryPath, along with a copy of the benchmark image.
+void generateLibrary( const std::string& libraryPath,
+                      unsigned int nTilesets,
+                      unsigned int nAnimations );
+
+// Prevents the compiler from optimizing away a computed value.
+template < class T >
+void doNotOptimize( const T& value )
+{
+    __asm__ __volatile__( "" : : "g"( &value ) : "memory" );
+}
+
+} // namespace m2g
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,129 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include "../collision/collision_world.hpp"
+#include "../collision/sweep_and_prune.hpp"
+
+namespace m2g {
+
+const unsigned int N_COLLIDERS = 100000;
+const unsigned int N_BULLETS = 1000;
+
+// Dense crowd: sprites in a grid, 17 px apart, so the collision rect of
+// each one overlaps those of its 8 neighbours.
+std::shared_ptr< std::vector< TileSpritePtr > > generateColliders( const Tileset& tileset )
+{
+    std::shared_ptr< std::vector< TileSpritePtr > > sprites( new std::vector< TileSpritePtr > );
+    sprites->reserve( N_COLLIDERS );
+    for( unsigned int i = 0; i < N_COLLIDERS; i++ ){
+        TileSpritePtr sprite( new TileSprite( tileset ) );
+        sprite->setPosition( ( i % 500 ) * 17, ( i / 500 ) * 17 );
+        sprites->push_back( std::move( sprite ) );
+    }
+    return sprites;
+}
+
+
+// Runs CollisionWorld::findCollisions() over generateColliders()
+// sprites with the given number of threads. Unless moving is true, the
+// sprites stay still and previous results are reused. The broadphase is the
+// default one unless sweepAndPrune is true.
+BenchmarkSetup collisionWorldBenchmark( unsigned int nThreads,
+                                        bool moving,
+                                        bool sweepAndPrune = false )
+{
+    return [=](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 32, 32 ) );
+        tileset->addCollisionRect( sf::IntRect( 4, 4, 24, 24 ) );
+        std::shared_ptr< std::vector< TileSpritePtr > > sprites = generateColliders( *tileset );
+        std::shared_ptr< CollisionWorld > world( new CollisionWorld( nThreads ) );
+        if( sweepAndPrune ){
+            world->setBroadphase( BroadphasePtr( new SweepAndPrune ) );
+        }
+        for( const TileSpritePtr& sprite : *sprites ){
+            world->add( *sprite );
+        }
+
+        // Sprites only reference their tileset, so the body keeps it alive.
+        return BenchmarkBody( [tileset, sprites, world, moving]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                if( moving ){
+                    const float offset = ( i % 2 ) ? 1.0f : -1.0f;
+                    for( const TileSpritePtr& sprite : *sprites ){
+                        sprite->move( offset, 0.0f );
+                    }
+                }
+                doNotOptimize( world->findCollisions() );
+            }
+        });
+    };
+}
+
+
+void addCollisionWorldBenchmarks( BenchmarkRunner& runner )
+{
+    runner.add( "CollisionWorld/findCollisions/100k/1thread", N_COLLIDERS,
+                collisionWorldBenchmark( 1, true ) );
+    runner.add( "CollisionWorld/findCollisions/100k/4threads", N_COLLIDERS,
+                collisionWorldBenchmark( 4, true ) );
+    runner.add( "CollisionWorld/findCollisions/100k/static", N_COLLIDERS,
+                collisionWorldBenchmark( 4, false ) );
+    runner.add( "CollisionWorld/findCollisions/100k/sweepAndPrune", N_COLLIDERS,
+                collisionWorldBenchmark( 1, true, true ) );
+
+    // Bullets crossing 10 rows of the crowd in a single step.
+    runner.add( "CollisionWorld/sweep/1k", N_BULLETS, [](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 32, 32 ) );
+        tileset->addCollisionRect( sf::IntRect( 4, 4, 24, 24 ) );
+        std::shared_ptr< std::vector< TileSpritePtr > > sprites = generateColliders( *tileset );
+        std::shared_ptr< CollisionWorld > world( new CollisionWorld );
+        for( const TileSpritePtr& sprite : *sprites ){
+            world->add( *sprite );
+        }
+        world->findCollisions();
+
+        std::shared_ptr< std::vector< TileSpritePtr > > bullets( new std::vector< TileSpritePtr > );
+        std::shared_ptr< std::vector< sf::Transform > > previousTransforms( new std::vector< sf::Transform > );
+        for( unsigned int i = 0; i < N_BULLETS; i++ ){
+            TileSpritePtr bullet( new TileSprite( *tileset ) );
+            bullet->setPosition( ( i * 37 ) % 8500, ( i * 91 ) % 3400 );
+            previousTransforms->push_back( bullet->getTransform() );
+            bullet->move( 0.0f, 170.0f );
+            bullets->push_back( std::move( bullet ) );
+        }
+
+        // Sprites only reference their tileset, so the body keeps it alive.
+        return BenchmarkBody( [tileset, sprites, world, bullets, previousTransforms](
+                              unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                unsigned int nHits = 0;
+                unsigned int collider;
+                SweepHit hit;
+                for( unsigned int j = 0; j < N_BULLETS; j++ ){
+                    nHits += world->sweep( *( ( *bullets )[j] ), ( *previousTransforms )[j],
+                                           collider, hit );
+                }
+                doNotOptimize( nHits );
+            }
+        });
+    });
+}
+
+} // namespace m2g
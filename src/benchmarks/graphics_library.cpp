@@ -0,0 +1,88 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include "../graphics_library.hpp"
+
+namespace m2g {
+
+const unsigned int N_LIBRARY_TILESETS = 10000;
+const unsigned int N_LIBRARY_ANIMATIONS = 10000;
+const char* BENCHMARK_LIBRARY_PATH = "benchmark_graphics_library.xml";
+
+void addGraphicsLibraryBenchmarks( BenchmarkRunner& runner )
+{
+    // Lookups are done on the last entries of a big library, which is the
+    // worst case for a linear search.
+    runner.add( "GraphicsLibrary/getTilesetByName/10k", 1, [](){
+        generateLibrary( BENCHMARK_LIBRARY_PATH, N_LIBRARY_TILESETS, N_LIBRARY_ANIMATIONS );
+        std::shared_ptr< GraphicsLibrary > library( new GraphicsLibrary( BENCHMARK_LIBRARY_PATH ) );
+        const std::string name = "tileset_" + std::to_string( N_LIBRARY_TILESETS - 1 );
+
+        return BenchmarkBody( [=]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                TilesetPtr tileset = library->getTilesetByName( name );
+                doNotOptimize( tileset );
+            }
+        });
+    });
+
+    runner.add( "GraphicsLibrary/getAnimationDataByName/10k", 1, [](){
+        generateLibrary( BENCHMARK_LIBRARY_PATH, N_LIBRARY_TILESETS, N_LIBRARY_ANIMATIONS );
+        std::shared_ptr< GraphicsLibrary > library( new GraphicsLibrary( BENCHMARK_LIBRARY_PATH ) );
+        const std::string name = "animation_" + std::to_string( N_LIBRARY_ANIMATIONS - 1 );
+
+        return BenchmarkBody( [=]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                AnimationDataPtr animationData = library->getAnimationDataByName( name );
+                doNotOptimize( animationData );
+            }
+        });
+    });
+
+    runner.add( "GraphicsLibrary/getTileset(handle)/10k", 1, [](){
+        generateLibrary( BENCHMARK_LIBRARY_PATH, N_LIBRARY_TILESETS, N_LIBRARY_ANIMATIONS );
+        std::shared_ptr< GraphicsLibrary > library( new GraphicsLibrary( BENCHMARK_LIBRARY_PATH ) );
+        const TilesetHandle handle =
+                library->tilesetHandle( "tileset_" + std::to_string( N_LIBRARY_TILESETS - 1 ) );
+
+        return BenchmarkBody( [=]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                std::shared_ptr< const Tileset > tileset = library->getTileset( handle );
+                doNotOptimize( tileset );
+            }
+        });
+    });
+
+    runner.add( "GraphicsLibrary/getAnimationData(handle)/10k", 1, [](){
+        generateLibrary( BENCHMARK_LIBRARY_PATH, N_LIBRARY_TILESETS, N_LIBRARY_ANIMATIONS );
+        std::shared_ptr< GraphicsLibrary > library( new GraphicsLibrary( BENCHMARK_LIBRARY_PATH ) );
+        const AnimationHandle handle =
+                library->animationHandle( "animation_" + std::to_string( N_LIBRARY_ANIMATIONS - 1 ) );
+
+        return BenchmarkBody( [=]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                std::shared_ptr< const AnimationData > animationData = library->getAnimationData( handle );
+                doNotOptimize( animationData );
+            }
+        });
+    });
+}
+
+} // namespace m2g
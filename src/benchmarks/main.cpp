@@ -0,0 +1,71 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Usage: benchmarks [--filter <substring>] [--output <results.json>]
+int main( int argc, char** argv )
+{
+    std::string filter;
+    std::string outputPath;
+
+    for( int i = 1; i < argc; i++ ){
+        if( !strcmp( argv[i], "--filter" ) && ( i + 1 < argc ) ){
+            filter = argv[++i];
+        }else if( !strcmp( argv[i], "--output" ) && ( i + 1 < argc ) ){
+            outputPath = argv[++i];
+        }else{
+            std::cerr << "Usage: " << argv[0]
+                      << " [--filter <substring>] [--output <results.json>]" << std::endl;
+            return 1;
+        }
+    }
+
+    try{
+        m2g::BenchmarkRunner runner;
+        m2g::addGraphicsLibraryBenchmarks( runner );
+        m2g::addTilesetBenchmarks( runner );
+        m2g::addTileSpriteBenchmarks( runner );
+        m2g::addSpriteStoreBenchmarks( runner );
+        m2g::addRectBatchBenchmarks( runner );
+        m2g::addCollisionWorldBenchmarks( runner );
+        m2g::addTileLayerBenchmarks( runner );
+        m2g::addAnimationBenchmarks( runner );
+
+        const std::vector< m2g::BenchmarkResult > results =
+                runner.run( filter, std::cout );
+
+        if( !outputPath.empty() ){
+            std::ofstream output( outputPath );
+            if( !output.is_open() ){
+                std::cerr << "Couldn't write [" << outputPath << "]" << std::endl;
+                return 1;
+            }
+            m2g::BenchmarkRunner::writeJSON( results, output );
+        }
+    }catch( std::exception& e ){
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
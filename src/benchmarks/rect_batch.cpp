@@ -0,0 +1,74 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include "../utilities/rect_batch.hpp"
+
+namespace m2g {
+
+const unsigned int N_RECTS = 1000;
+
+// Rects spread over a 1000x1000 px area, and a query rect intersecting
+// only the last one, so every rect is tested.
+std::vector< sf::FloatRect > generateRects()
+{
+    std::vector< sf::FloatRect > rects;
+    for( unsigned int i = 0; i < N_RECTS - 1; i++ ){
+        rects.push_back( sf::FloatRect( ( i * 37 ) % 1000, 100 + ( i * 91 ) % 900, 16, 16 ) );
+    }
+    rects.push_back( sf::FloatRect( 0, 0, 16, 16 ) );
+    return rects;
+}
+
+
+void addRectBatchBenchmarks( BenchmarkRunner& runner )
+{
+    runner.add( "RectBatch/findIntersection/1k", N_RECTS, [](){
+        std::shared_ptr< RectBatch > rects( new RectBatch );
+        for( const sf::FloatRect& rect : generateRects() ){
+            rects->push_back( rect );
+        }
+
+        return BenchmarkBody( [=]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                unsigned int index = findIntersection( sf::FloatRect( 8, 8, 4, 4 ), *rects );
+                doNotOptimize( index );
+            }
+        });
+    });
+
+    // Scalar loop the kernels replace, for comparison.
+    runner.add( "RectBatch/FloatRectIntersects/1k", N_RECTS, [](){
+        std::shared_ptr< std::vector< sf::FloatRect > > rects(
+                    new std::vector< sf::FloatRect >( generateRects() ) );
+
+        return BenchmarkBody( [=]( unsigned int nIterations ){
+            const sf::FloatRect query( 8, 8, 4, 4 );
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                unsigned int index = 0;
+                while( index < rects->size() && !query.intersects( ( *rects )[index] ) ){
+                    index++;
+                }
+                doNotOptimize( index );
+            }
+        });
+    });
+}
+
+} // namespace m2g
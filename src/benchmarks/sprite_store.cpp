@@ -0,0 +1,95 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include "../drawables/sprite_store.hpp"
+
+namespace m2g {
+
+const unsigned int N_STORED_SPRITES = 100000;
+
+// Same layout as the TileSprite benchmarks, so both can be compared.
+std::shared_ptr< SpriteStore > generateSpriteStore( const Tileset& tileset )
+{
+    std::shared_ptr< SpriteStore > store( new SpriteStore );
+    const unsigned int tilesetId = store->addTileset( tileset );
+    store->reserve( N_STORED_SPRITES );
+    for( unsigned int i = 0; i < N_STORED_SPRITES; i++ ){
+        store->create( tilesetId,
+                       i % tileset.nTiles(),
+                       sf::Vector2f( ( i * 37 ) % 1000, ( i * 91 ) % 1000 ) );
+    }
+    store->updateBounds();
+    return store;
+}
+
+
+void addSpriteStoreBenchmarks( BenchmarkRunner& runner )
+{
+    runner.add( "SpriteStore/findCollisions/100k", N_STORED_SPRITES, [](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 32, 32 ) );
+        tileset->addCollisionRect( sf::IntRect( 4, 4, 24, 24 ) );
+        std::shared_ptr< SpriteStore > store = generateSpriteStore( *tileset );
+        const SpriteHandle player = store->create( 0, 0, sf::Vector2f( 500, 500 ) );
+        store->updateBounds();
+
+        // The store only references the tileset, so the body keeps it alive.
+        return BenchmarkBody( [tileset, store, player]( unsigned int nIterations ){
+            std::vector< SpriteHandle > collisions;
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                collisions.clear();
+                store->findCollisions( player, collisions );
+                doNotOptimize( collisions );
+            }
+        });
+    });
+
+    runner.add( "SpriteStore/updateBounds/100k", N_STORED_SPRITES, [](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 32, 32 ) );
+        std::shared_ptr< SpriteStore > store = generateSpriteStore( *tileset );
+        for( unsigned int i = 0; i < store->size(); i += 2 ){
+            store->setRotation( store->handle( i ), i % 360 );
+        }
+
+        // The store only references the tileset, so the body keeps it alive.
+        return BenchmarkBody( [tileset, store]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                store->updateBounds();
+                doNotOptimize( *store );
+            }
+        });
+    });
+
+    runner.add( "SpriteStore/cull/100k", N_STORED_SPRITES, [](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 32, 32 ) );
+        std::shared_ptr< SpriteStore > store = generateSpriteStore( *tileset );
+
+        // The store only references the tileset, so the body keeps it alive.
+        return BenchmarkBody( [tileset, store]( unsigned int nIterations ){
+            std::vector< SpriteHandle > visibleSprites;
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                visibleSprites.clear();
+                store->cull( sf::FloatRect( 200, 200, 640, 480 ), visibleSprites );
+                doNotOptimize( visibleSprites );
+            }
+        });
+    });
+}
+
+} // namespace m2g
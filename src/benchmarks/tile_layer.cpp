@@ -0,0 +1,67 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include "../drawables/tile_layer.hpp"
+
+namespace m2g {
+
+const unsigned int N_LAYER_QUERIES = 10000;
+
+// Random looking level of 1000x1000 tiles, most of them solid.
+BenchmarkSetup tileLayerBenchmark( bool sweep )
+{
+    return [=](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 32, 32 ) );
+        tileset->addCollisionRect( sf::IntRect( 0, 0, 32, 32 ), 0, 2 );
+        std::shared_ptr< TileLayer > layer( new TileLayer( *tileset, 1000, 1000 ) );
+        for( unsigned int row = 0; row < layer->nRows(); row++ ){
+            for( unsigned int column = 0; column < layer->nColumns(); column++ ){
+                layer->setTile( column, row, ( row * 7 + column * 13 ) % tileset->nTiles() );
+            }
+        }
+
+        // The layer only references the tileset, so the body keeps it alive.
+        return BenchmarkBody( [tileset, layer, sweep]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                unsigned int nCollisions = 0;
+                sf::Vector2u cell;
+                SweepHit hit;
+                for( unsigned int j = 0; j < N_LAYER_QUERIES; j++ ){
+                    const sf::FloatRect actor( ( j * 37 ) % 32000, ( j * 91 ) % 32000, 24, 24 );
+                    if( sweep ){
+                        nCollisions += layer->sweep( actor, sf::Vector2f( 100, 50 ), cell, hit );
+                    }else{
+                        nCollisions += layer->collide( actor );
+                    }
+                }
+                doNotOptimize( nCollisions );
+            }
+        });
+    };
+}
+
+
+void addTileLayerBenchmarks( BenchmarkRunner& runner )
+{
+    runner.add( "TileLayer/collide/1M", N_LAYER_QUERIES, tileLayerBenchmark( false ) );
+    runner.add( "TileLayer/sweep/1M", N_LAYER_QUERIES, tileLayerBenchmark( true ) );
+}
+
+} // namespace m2g
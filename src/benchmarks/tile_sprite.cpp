@@ -0,0 +1,95 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include "../drawables/tile_sprite.hpp"
+
+namespace m2g {
+
+const unsigned int N_SPRITES = 100000;
+
+// Creates N_SPRITES sprites spread over a 1000x1000 px area, so only a
+// few of them overlap.
+std::shared_ptr< std::vector< TileSpritePtr > > generateSprites( const Tileset& tileset )
+{
+    std::shared_ptr< std::vector< TileSpritePtr > > sprites( new std::vector< TileSpritePtr > );
+    sprites->reserve( N_SPRITES );
+    for( unsigned int i = 0; i < N_SPRITES; i++ ){
+        TileSpritePtr sprite( new TileSprite( tileset ) );
+        sprite->setTile( i % tileset.nTiles() );
+        sprite->setPosition( ( i * 37 ) % 1000, ( i * 91 ) % 1000 );
+        sprites->push_back( std::move( sprite ) );
+    }
+    return sprites;
+}
+
+
+// Player against every sprite, with all of them rotated (projectiles)
+// if rotation isn't 0.
+BenchmarkSetup collideSetup( float rotation, bool orientedCollision )
+{
+    return [=](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 32, 32 ) );
+        tileset->addCollisionRect( sf::IntRect( 4, 4, 24, 24 ) );
+        std::shared_ptr< std::vector< TileSpritePtr > > sprites = generateSprites( *tileset );
+        for( const TileSpritePtr& sprite : *sprites ){
+            sprite->setRotation( rotation );
+            sprite->setOrientedCollision( orientedCollision );
+        }
+        std::shared_ptr< TileSprite > player( new TileSprite( *tileset ) );
+        player->setPosition( 500, 500 );
+
+        // Sprites only reference their tileset, so the body keeps it alive.
+        return BenchmarkBody( [tileset, sprites, player]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                unsigned int nCollisions = 0;
+                for( const TileSpritePtr& sprite : *sprites ){
+                    nCollisions += player->collide( *sprite );
+                }
+                doNotOptimize( nCollisions );
+            }
+        });
+    };
+}
+
+
+void addTileSpriteBenchmarks( BenchmarkRunner& runner )
+{
+    runner.add( "TileSprite/collide/100k", N_SPRITES, collideSetup( 0.0f, false ) );
+    runner.add( "TileSprite/collide/rotated/100k", N_SPRITES, collideSetup( 30.0f, false ) );
+    runner.add( "TileSprite/collide/oriented/100k", N_SPRITES, collideSetup( 30.0f, true ) );
+
+    runner.add( "TileSprite/collisionRects/100k", N_SPRITES, [](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 32, 32 ) );
+        tileset->addCollisionRect( sf::IntRect( 4, 4, 24, 24 ) );
+        std::shared_ptr< std::vector< TileSpritePtr > > sprites = generateSprites( *tileset );
+
+        // Sprites only reference their tileset, so the body keeps it alive.
+        return BenchmarkBody( [tileset, sprites]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                for( const TileSpritePtr& sprite : *sprites ){
+                    const std::list< sf::FloatRect >& rects = sprite->collisionRects();
+                    doNotOptimize( rects );
+                }
+            }
+        });
+    });
+}
+
+} // namespace m2g
@@ -0,0 +1,59 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "benchmark.hpp"
+#include "../drawables/tileset.hpp"
+
+namespace m2g {
+
+const unsigned int N_TILESET_QUERIES = 1000;
+
+void addTilesetBenchmarks( BenchmarkRunner& runner )
+{
+    runner.add( "Tileset/tileRect", N_TILESET_QUERIES, [](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 16, 16 ) );
+
+        return BenchmarkBody( [=]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                for( unsigned int j = 0; j < N_TILESET_QUERIES; j++ ){
+                    sf::IntRect rect = tileset->tileRect( j % tileset->nTiles() );
+                    doNotOptimize( rect );
+                }
+            }
+        });
+    });
+
+    runner.add( "Tileset/collisionRects", N_TILESET_QUERIES, [](){
+        std::shared_ptr< Tileset > tileset( new Tileset( BENCHMARK_IMAGE_PATH, 16, 16 ) );
+        tileset->addCollisionRect( sf::IntRect( 2, 2, 12, 12 ) );
+        tileset->addCollisionRect( sf::IntRect( 0, 0, 4, 4 ), 0, tileset->nTiles() / 2 );
+
+        return BenchmarkBody( [=]( unsigned int nIterations ){
+            for( unsigned int i = 0; i < nIterations; i++ ){
+                for( unsigned int j = 0; j < N_TILESET_QUERIES; j++ ){
+                    std::list< sf::IntRect > rects =
+                            tileset->collisionRects( j % tileset->nTiles() );
+                    doNotOptimize( rects );
+                }
+            }
+        });
+    });
+}
+
+} // namespace m2g
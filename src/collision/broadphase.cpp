@@ -0,0 +1,45 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "broadphase.hpp"
+
+namespace m2g {
+
+/***
+ * CollisionPair
+ ***/
+
+bool CollisionPair::operator == ( const CollisionPair& pair ) const
+{
+    return a == pair.a && b == pair.b;
+}
+
+
+bool CollisionPair::operator != ( const CollisionPair& pair ) const
+{
+    return !( *this == pair );
+}
+
+
+bool CollisionPair::operator < ( const CollisionPair& pair ) const
+{
+    return ( a < pair.a ) || ( a == pair.a && b < pair.b );
+}
+
+} // namespace m2g
@@ -0,0 +1,78 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef BROADPHASE_HPP
+#define BROADPHASE_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+#include <memory>
+#include <vector>
+
+namespace m2g {
+
+// Pair of colliders, identified by their ids in a CollisionWorld (a < b).
+struct CollisionPair
+{
+    unsigned int a;
+    unsigned int b;
+
+    bool operator == ( const CollisionPair& pair ) const;
+    bool operator != ( const CollisionPair& pair ) const;
+    bool operator < ( const CollisionPair& pair ) const;
+};
+
+
+// Finds the pairs of colliders whose boxes overlap, so only those get the
+// expensive narrowphase test.
+class Broadphase
+{
+    public:
+        /***
+         * 1. Destruction
+         ***/
+        virtual ~Broadphase() = default;
+
+
+        /***
+         * 2. Updating
+         ***/
+        // Called once per frame, before the queries below. boxes[id] is the
+        // box of collider id, and colliders lists (in increasing order) the
+        // ids of the colliders to consider. Other boxes must be ignored.
+        // Implementations may keep a reference to boxes instead of copying
+        // them, so it must stay alive and unchanged until the next update.
+        virtual void update( const std::vector< sf::FloatRect >& boxes,
+                             const std::vector< unsigned int >& colliders ) = 0;
+
+
+        /***
+         * 3. Queries
+         ***/
+        // Appends every pair of colliders whose boxes intersect, once.
+        virtual void findPairs( std::vector< CollisionPair >& pairs ) const = 0;
+        // Appends every collider whose box intersects the given area, once.
+        virtual void query( const sf::FloatRect& area,
+                            std::vector< unsigned int >& colliders ) const = 0;
+};
+
+typedef std::unique_ptr< Broadphase > BroadphasePtr;
+
+} // namespace m2g
+
+#endif // BROADPHASE_HPP
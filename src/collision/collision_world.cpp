@@ -0,0 +1,381 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "collision_world.hpp"
+#include "uniform_grid.hpp"
+#include "../utilities/stats.hpp"
+#include "../utilities/trace.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace m2g {
+
+// Work items per thread pool task. Fixed, so tasks (and the order their
+// results are merged in) don't depend on the number of threads.
+const unsigned int SPRITES_PER_TASK = 512;
+const unsigned int PAIRS_PER_TASK = 256;
+
+/***
+ * 1. Construction
+ ***/
+
+CollisionWorld::CollisionWorld( unsigned int nThreads, BroadphasePtr broadphase ) :
+    nSprites_( 0 ),
+    threadPool_( nThreads ),
+    nNarrowphaseTests_( 0 )
+{
+    setBroadphase( std::move( broadphase ) );
+}
+
+
+/***
+ * 2. Colliders
+ ***/
+
+unsigned int CollisionWorld::add( const TileSprite& sprite )
+{
+    if( colliderIds_.count( &sprite ) ){
+        throw std::invalid_argument( "CollisionWorld::add - sprite already added" );
+    }
+
+    unsigned int collider;
+    if( freeIds_.size() ){
+        collider = freeIds_.back();
+        freeIds_.pop_back();
+        sprites_[collider] = &sprite;
+    }else{
+        collider = sprites_.size();
+        sprites_.push_back( &sprite );
+        boxes_.push_back( sf::FloatRect() );
+        hasCollisionRects_.push_back( false );
+        categories_.push_back( 0 );
+        masks_.push_back( 0 );
+        revisions_.push_back( 0 );
+        changed_.push_back( true );
+    }
+
+    // No revision is 0, so cached results of a previous sprite with the
+    // same id are never reused.
+    revisions_[collider] = 0;
+    colliderIds_[&sprite] = collider;
+    nSprites_++;
+    return collider;
+}
+
+
+void CollisionWorld::remove( unsigned int collider )
+{
+    if( !contains( collider ) ){
+        throw std::out_of_range( "Unknown collider" );
+    }
+    colliderIds_.erase( sprites_[collider] );
+    sprites_[collider] = nullptr;
+    freeIds_.push_back( collider );
+    nSprites_--;
+
+    // Its contacts end in the next findCollisions() call.
+    auto involvesCollider = [collider]( const CollisionPair& pair ){
+        return pair.a == collider || pair.b == collider;
+    };
+    std::copy_if( pairs_.begin(), pairs_.end(),
+                  std::back_inserter( removedPairs_ ), involvesCollider );
+    pairs_.erase( std::remove_if( pairs_.begin(), pairs_.end(), involvesCollider ),
+                  pairs_.end() );
+}
+
+
+bool CollisionWorld::contains( unsigned int collider ) const
+{
+    return collider < sprites_.size() && sprites_[collider] != nullptr;
+}
+
+
+const TileSprite& CollisionWorld::sprite( unsigned int collider ) const
+{
+    if( !contains( collider ) ){
+        throw std::out_of_range( "Unknown collider" );
+    }
+    return *( sprites_[collider] );
+}
+
+
+unsigned int CollisionWorld::size() const
+{
+    return nSprites_;
+}
+
+
+/***
+ * 3. Setters
+ ***/
+
+void CollisionWorld::setBroadphase( BroadphasePtr broadphase )
+{
+    if( broadphase == nullptr ){
+        broadphase.reset( new UniformGrid );
+    }
+    broadphase_ = std::move( broadphase );
+}
+
+
+/***
+ * 4. Collision detection
+ ***/
+
+const std::vector< CollisionPair >& CollisionWorld::findCollisions()
+{
+    M2G_TRACE_SCOPE( "CollisionWorld::findCollisions" );
+    updateBroadphase();
+
+    candidatePairs_.clear();
+    broadphase_->findPairs( candidatePairs_ );
+    filterCandidatePairs();
+
+    // Sorted, so results come out sorted too and previous results can be
+    // found by binary search.
+    std::sort( candidatePairs_.begin(), candidatePairs_.end() );
+
+    previousPairs_.swap( pairs_ );
+    runNarrowphase();
+    updateContacts();
+    return pairs_;
+}
+
+
+const std::vector< CollisionPair >& CollisionWorld::begunContacts() const
+{
+    return begunContacts_;
+}
+
+
+const std::vector< CollisionPair >& CollisionWorld::persistingContacts() const
+{
+    return persistingContacts_;
+}
+
+
+const std::vector< CollisionPair >& CollisionWorld::endedContacts() const
+{
+    return endedContacts_;
+}
+
+
+unsigned int CollisionWorld::nNarrowphaseTests() const
+{
+    return nNarrowphaseTests_;
+}
+
+
+bool CollisionWorld::sweep( const TileSprite& sprite,
+                            const sf::Transform& previousTransform,
+                            unsigned int& collider,
+                            SweepHit& hit ) const
+{
+    M2G_TRACE_SCOPE( "CollisionWorld::sweep" );
+    const std::list< sf::FloatRect >& rects = sprite.collisionRects();
+    if( rects.empty() ){
+        return false;
+    }
+
+    // Bounds of the whole movement.
+    const std::list< sf::FloatRect > previousRects = sprite.collisionRects( previousTransform );
+    float left = rects.front().left;
+    float top = rects.front().top;
+    float right = left + rects.front().width;
+    float bottom = top + rects.front().height;
+    auto extend = [&]( const std::list< sf::FloatRect >& sweptRects ){
+        for( const sf::FloatRect& rect : sweptRects ){
+            left = std::min( left, rect.left );
+            top = std::min( top, rect.top );
+            right = std::max( right, rect.left + rect.width );
+            bottom = std::max( bottom, rect.top + rect.height );
+        }
+    };
+    extend( rects );
+    extend( previousRects );
+
+    std::vector< unsigned int > candidates;
+    broadphase_->query( sf::FloatRect( left, top, right - left, bottom - top ), candidates );
+
+    bool found = false;
+    for( unsigned int candidate : candidates ){
+        SweepHit candidateHit;
+        if( sprites_[candidate] == nullptr || sprites_[candidate] == &sprite ||
+                !sprite.sweep( previousRects, *( sprites_[candidate] ), candidateHit ) ){
+            continue;
+        }
+        if( !found || candidateHit.time < hit.time ||
+                ( candidateHit.time == hit.time && candidate < collider ) ){
+            collider = candidate;
+            hit = candidateHit;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+
+/***
+ * 5. Auxiliar methods
+ ***/
+
+void CollisionWorld::updateBroadphase()
+{
+    M2G_TRACE_SCOPE( "CollisionWorld::updateBroadphase" );
+    const unsigned int nIds = sprites_.size();
+    const unsigned int nTasks = ( nIds + SPRITES_PER_TASK - 1 ) / SPRITES_PER_TASK;
+
+    // Every sprite is touched by a single task.
+    threadPool_.run( nTasks, [&]( unsigned int task ){
+        const unsigned int end = std::min( nIds, ( task + 1 ) * SPRITES_PER_TASK );
+        for( unsigned int id = task * SPRITES_PER_TASK; id < end; id++ ){
+            hasCollisionRects_[id] = false;
+            if( sprites_[id] == nullptr ){
+                continue;
+            }
+
+            const std::list< sf::FloatRect >& rects = sprites_[id]->collisionRects();
+            const unsigned int revision = sprites_[id]->collisionRectsRevision();
+            changed_[id] = ( revision != revisions_[id] );
+            revisions_[id] = revision;
+            categories_[id] = sprites_[id]->collisionCategory();
+            masks_[id] = sprites_[id]->collisionMask();
+            if( rects.empty() ){
+                continue;
+            }
+
+            float left = rects.front().left;
+            float top = rects.front().top;
+            float right = left + rects.front().width;
+            float bottom = top + rects.front().height;
+            for( const sf::FloatRect& rect : rects ){
+                left = std::min( left, rect.left );
+                top = std::min( top, rect.top );
+                right = std::max( right, rect.left + rect.width );
+                bottom = std::max( bottom, rect.top + rect.height );
+            }
+            boxes_[id] = sf::FloatRect( left, top, right - left, bottom - top );
+            hasCollisionRects_[id] = true;
+        }
+    });
+
+    colliders_.clear();
+    for( unsigned int id = 0; id < nIds; id++ ){
+        if( hasCollisionRects_[id] ){
+            colliders_.push_back( id );
+        }
+    }
+
+    broadphase_->update( boxes_, colliders_ );
+}
+
+
+void CollisionWorld::filterCandidatePairs()
+{
+    auto filteredOut = [this]( const CollisionPair& pair ){
+        return !( categories_[pair.a] & masks_[pair.b] ) ||
+               !( categories_[pair.b] & masks_[pair.a] );
+    };
+    candidatePairs_.erase( std::remove_if( candidatePairs_.begin(),
+                                           candidatePairs_.end(),
+                                           filteredOut ),
+                           candidatePairs_.end() );
+}
+
+
+void CollisionWorld::runNarrowphase()
+{
+    M2G_TRACE_SCOPE( "CollisionWorld::runNarrowphase" );
+    previousTestedPairs_.swap( testedPairs_ );
+    const unsigned int nCandidates = candidatePairs_.size();
+    const unsigned int nTasks = ( nCandidates + PAIRS_PER_TASK - 1 ) / PAIRS_PER_TASK;
+    if( taskPairs_.size() < nTasks ){
+        taskPairs_.resize( nTasks );
+    }
+    taskTests_.assign( nTasks, 0 );
+
+    // Each task writes only to its own buffers, so no locks are needed.
+    threadPool_.run( nTasks, [&]( unsigned int task ){
+        std::vector< TestedPair >& pairs = taskPairs_[task];
+        pairs.clear();
+        const unsigned int end = std::min( nCandidates, ( task + 1 ) * PAIRS_PER_TASK );
+        for( unsigned int i = task * PAIRS_PER_TASK; i < end; i++ ){
+            const CollisionPair& pair = candidatePairs_[i];
+
+            if( !changed_[pair.a] && !changed_[pair.b] ){
+                auto previous = std::lower_bound(
+                            previousTestedPairs_.begin(),
+                            previousTestedPairs_.end(),
+                            pair,
+                            []( const TestedPair& tested, const CollisionPair& pair ){
+                                return tested.pair < pair;
+                            });
+                if( previous != previousTestedPairs_.end() && previous->pair == pair ){
+                    pairs.push_back( *previous );
+                    continue;
+                }
+            }
+
+            pairs.push_back( TestedPair{ pair, sprites_[pair.a]->collideUncounted( *( sprites_[pair.b] ) ) } );
+            taskTests_[task]++;
+        }
+    });
+
+    testedPairs_.clear();
+    pairs_.clear();
+    nNarrowphaseTests_ = 0;
+    for( unsigned int task = 0; task < nTasks; task++ ){
+        for( const TestedPair& tested : taskPairs_[task] ){
+            testedPairs_.push_back( tested );
+            if( tested.colliding ){
+                pairs_.push_back( tested.pair );
+            }
+        }
+        nNarrowphaseTests_ += taskTests_[task];
+    }
+    Stats::increment( STAT_SPRITE_COLLIDES, nNarrowphaseTests_ );
+}
+
+
+void CollisionWorld::updateContacts()
+{
+    begunContacts_.clear();
+    persistingContacts_.clear();
+    endedContacts_.clear();
+
+    std::set_difference( pairs_.begin(), pairs_.end(),
+                         previousPairs_.begin(), previousPairs_.end(),
+                         std::back_inserter( begunContacts_ ) );
+    std::set_intersection( pairs_.begin(), pairs_.end(),
+                           previousPairs_.begin(), previousPairs_.end(),
+                           std::back_inserter( persistingContacts_ ) );
+    std::set_difference( previousPairs_.begin(), previousPairs_.end(),
+                         pairs_.begin(), pairs_.end(),
+                         std::back_inserter( endedContacts_ ) );
+
+    if( removedPairs_.size() ){
+        endedContacts_.insert( endedContacts_.end(), removedPairs_.begin(), removedPairs_.end() );
+        std::sort( endedContacts_.begin(), endedContacts_.end() );
+        removedPairs_.clear();
+    }
+}
+
+} // namespace m2g
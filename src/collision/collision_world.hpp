@@ -0,0 +1,170 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef COLLISION_WORLD_HPP
+#define COLLISION_WORLD_HPP
+
+#include "broadphase.hpp"
+#include "../drawables/tile_sprite.hpp"
+#include "../utilities/thread_pool.hpp"
+#include <cstdint>
+#include <unordered_map>
+
+namespace m2g {
+
+// Finds the colliding pairs among a set of registered TileSprites. A
+// broadphase selects the pairs whose boxes overlap, and the narrowphase
+// (TileSprite::collide()) is split across a thread pool. Results don't
+// depend on the number of threads.
+//
+// Results are kept between calls: a pair is only tested again when any of
+// its sprites changed (moved, changed its tile...), and contacts are
+// reported as they begin, persist and end.
+//
+// Sprites are referenced, not copied, so they must outlive the world (or
+// be removed from it), and they must not be modified while the world is
+// looking for collisions.
+class CollisionWorld
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        // nThreads as in ThreadPool (0 means one per hardware thread). The
+        // default broadphase is a UniformGrid.
+        explicit CollisionWorld( unsigned int nThreads = 1,
+                                 BroadphasePtr broadphase = nullptr );
+
+
+        /***
+         * 2. Colliders
+         ***/
+        // Returns the id identifying the sprite in collision pairs. Ids of
+        // removed sprites are reused. Throws std::invalid_argument if the
+        // sprite is already in the world.
+        unsigned int add( const TileSprite& sprite );
+        void remove( unsigned int collider );
+        bool contains( unsigned int collider ) const;
+        const TileSprite& sprite( unsigned int collider ) const;
+        unsigned int size() const;
+
+
+        /***
+         * 3. Setters
+         ***/
+        void setBroadphase( BroadphasePtr broadphase );
+
+
+        /***
+         * 4. Collision detection
+         ***/
+        // Returns every pair of colliding sprites, sorted by ids. The
+        // returned vector is valid until the next call.
+        const std::vector< CollisionPair >& findCollisions();
+
+        // Contacts found by the last findCollisions() call which weren't
+        // found by the previous one, were found by both, and were only
+        // found by the previous one (or involve sprites removed since then,
+        // whose ids may already be reused), respectively.
+        const std::vector< CollisionPair >& begunContacts() const;
+        const std::vector< CollisionPair >& persistingContacts() const;
+        const std::vector< CollisionPair >& endedContacts() const;
+
+        // Narrowphase tests run by the last findCollisions() call.
+        unsigned int nNarrowphaseTests() const;
+
+        // Finds the first sprite hit by the given one while moving from
+        // previousTransform to its current transform (see
+        // TileSprite::sweep()), so fast sprites don't go through thin ones.
+        // The swept sprite doesn't need to be in the world (it's ignored if
+        // it is), but the other ones are found by the broadphase of the
+        // last findCollisions() call, so they shouldn't have moved since.
+        // Ties are solved in favor of the lowest id.
+        bool sweep( const TileSprite& sprite,
+                    const sf::Transform& previousTransform,
+                    unsigned int& collider,
+                    SweepHit& hit ) const;
+
+
+    private:
+        // Narrowphase result of a broadphase pair.
+        struct TestedPair
+        {
+            CollisionPair pair;
+            bool colliding;
+        };
+
+        /***
+         * 5. Auxiliar methods
+         ***/
+        // Refreshes the box around the collision rects and the collision
+        // filter of every sprite (also warming up their collision rect
+        // caches, so the narrowphase only reads them from several threads)
+        // and the broadphase.
+        void updateBroadphase();
+        // Drops the broadphase pairs whose collision filters don't match.
+        void filterCandidatePairs();
+        // Tests the broadphase pairs, reusing the previous result of pairs
+        // whose sprites didn't change.
+        void runNarrowphase();
+        void updateContacts();
+
+
+        /***
+         * Attributes
+         ***/
+        std::vector< const TileSprite* > sprites_;
+        std::unordered_map< const TileSprite*, unsigned int > colliderIds_;
+        std::vector< unsigned int > freeIds_;
+        unsigned int nSprites_;
+
+        BroadphasePtr broadphase_;
+        ThreadPool threadPool_;
+
+        std::vector< sf::FloatRect > boxes_;
+        std::vector< char > hasCollisionRects_;
+        // Collision filters of every sprite, so pairs which can't interact
+        // are dropped before the narrowphase.
+        std::vector< std::uint32_t > categories_;
+        std::vector< std::uint32_t > masks_;
+        // Collision rect revisions of every sprite in the last call (0 for
+        // sprites added since then) and whether they changed in this one.
+        std::vector< unsigned int > revisions_;
+        std::vector< char > changed_;
+        std::vector< unsigned int > colliders_;
+        std::vector< CollisionPair > candidatePairs_;
+        // Pairs tested by each narrowphase task, merged in task order.
+        std::vector< std::vector< TestedPair > > taskPairs_;
+        std::vector< unsigned int > taskTests_;
+        // Broadphase pairs of the last call, sorted.
+        std::vector< TestedPair > testedPairs_;
+        std::vector< TestedPair > previousTestedPairs_;
+        unsigned int nNarrowphaseTests_;
+
+        std::vector< CollisionPair > pairs_;
+        std::vector< CollisionPair > previousPairs_;
+        std::vector< CollisionPair > removedPairs_;
+        std::vector< CollisionPair > begunContacts_;
+        std::vector< CollisionPair > persistingContacts_;
+        std::vector< CollisionPair > endedContacts_;
+};
+
+} // namespace m2g
+
+#endif // COLLISION_WORLD_HPP
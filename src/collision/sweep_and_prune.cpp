@@ -0,0 +1,252 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "sweep_and_prune.hpp"
+#include "../utilities/trace.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace m2g {
+
+/***
+ * 1. Construction
+ ***/
+
+SweepAndPrune::SweepAndPrune( SweepAxis axis ) :
+    axis_( axis ),
+    boxes_( nullptr ),
+    nSwaps_( 0 )
+{}
+
+
+/***
+ * 2. Getters
+ ***/
+
+SweepAxis SweepAndPrune::axis() const
+{
+    return axis_;
+}
+
+
+unsigned int SweepAndPrune::nSwaps() const
+{
+    return nSwaps_;
+}
+
+
+/***
+ * 3. Updating
+ ***/
+
+void SweepAndPrune::update( const std::vector< sf::FloatRect >& boxes,
+                            const std::vector< unsigned int >& colliders )
+{
+    M2G_TRACE_SCOPE( "SweepAndPrune::update" );
+    boxes_ = &boxes;
+
+    std::vector< char > included( boxes.size(), false );
+    overflow_.clear();
+    for( unsigned int collider : colliders ){
+        if( hasNaNInterval( boxes[collider] ) ){
+            overflow_.push_back( collider );
+        }else{
+            included[collider] = true;
+        }
+    }
+    inEndpoints_.resize( boxes.size(), false );
+
+    // Drop the colliders not given anymore and refresh the others' values,
+    // keeping the order of the previous frame.
+    unsigned int nEndpoints = 0;
+    for( const Endpoint& endpoint : endpoints_ ){
+        if( endpoint.collider < included.size() && included[endpoint.collider] ){
+            const sf::FloatRect& box = boxes[endpoint.collider];
+            endpoints_[nEndpoints] = endpoint;
+            endpoints_[nEndpoints].value =
+                    endpoint.isMax ? maxValue( box ) : minValue( box );
+            nEndpoints++;
+        }else if( endpoint.collider < inEndpoints_.size() ){
+            inEndpoints_[endpoint.collider] = false;
+        }
+    }
+    endpoints_.resize( nEndpoints );
+
+    unsigned int nNewColliders = 0;
+    for( unsigned int collider : colliders ){
+        if( included[collider] && !inEndpoints_[collider] ){
+            const sf::FloatRect& box = boxes[collider];
+            endpoints_.push_back( Endpoint{ minValue( box ), collider, false } );
+            endpoints_.push_back( Endpoint{ maxValue( box ), collider, true } );
+            inEndpoints_[collider] = true;
+            nNewColliders++;
+        }
+    }
+
+    // Insertion sort is only worth it when few endpoints are out of place
+    // (new colliders are appended at the end).
+    nSwaps_ = 0;
+    if( nNewColliders > colliders.size() / 4 ){
+        std::sort( endpoints_.begin(), endpoints_.end() );
+        return;
+    }
+    for( unsigned int i = 1; i < endpoints_.size(); i++ ){
+        const Endpoint endpoint = endpoints_[i];
+        unsigned int j = i;
+        while( j > 0 && endpoint < endpoints_[j - 1] ){
+            endpoints_[j] = endpoints_[j - 1];
+            j--;
+        }
+        endpoints_[j] = endpoint;
+        nSwaps_ += i - j;
+    }
+}
+
+
+/***
+ * 4. Queries
+ ***/
+
+void SweepAndPrune::findPairs( std::vector< CollisionPair >& pairs ) const
+{
+    M2G_TRACE_SCOPE( "SweepAndPrune::findPairs" );
+    if( boxes_ == nullptr ){
+        return;
+    }
+    const std::vector< sf::FloatRect >& boxes = *boxes_;
+    activeColliders_.clear();
+    activePositions_.resize( boxes.size() );
+
+    for( const Endpoint& endpoint : endpoints_ ){
+        const unsigned int collider = endpoint.collider;
+        if( endpoint.isMax ){
+            // Swap-remove from the active colliders.
+            const unsigned int position = activePositions_[collider];
+            activeColliders_[position] = activeColliders_.back();
+            activePositions_[activeColliders_[position]] = position;
+            activeColliders_.pop_back();
+            continue;
+        }
+
+        // Every active collider overlaps (or touches) this one along the
+        // sweep axis.
+        const sf::FloatRect& box = boxes[collider];
+        for( unsigned int other : activeColliders_ ){
+            if( box.intersects( boxes[other] ) ){
+                pairs.push_back( CollisionPair{ std::min( collider, other ),
+                                                std::max( collider, other ) } );
+            }
+        }
+        activePositions_[collider] = activeColliders_.size();
+        activeColliders_.push_back( collider );
+    }
+
+    // Overflowing colliders are tested against each other and against the
+    // sorted colliders.
+    for( unsigned int i = 0; i < overflow_.size(); i++ ){
+        const unsigned int a = overflow_[i];
+        const sf::FloatRect& boxA = boxes[a];
+        for( unsigned int j = i + 1; j < overflow_.size(); j++ ){
+            if( boxA.intersects( boxes[overflow_[j]] ) ){
+                pairs.push_back( CollisionPair{ std::min( a, overflow_[j] ),
+                                                std::max( a, overflow_[j] ) } );
+            }
+        }
+        for( const Endpoint& endpoint : endpoints_ ){
+            const unsigned int b = endpoint.collider;
+            if( !endpoint.isMax && boxA.intersects( boxes[b] ) ){
+                pairs.push_back( CollisionPair{ std::min( a, b ), std::max( a, b ) } );
+            }
+        }
+    }
+}
+
+
+void SweepAndPrune::query( const sf::FloatRect& area,
+                           std::vector< unsigned int >& colliders ) const
+{
+    if( boxes_ == nullptr ){
+        return;
+    }
+    const std::vector< sf::FloatRect >& boxes = *boxes_;
+
+    // Boxes starting after the area ends along the sweep axis can't
+    // intersect it.
+    const float areaMax = maxValue( area );
+    for( const Endpoint& endpoint : endpoints_ ){
+        if( endpoint.value >= areaMax ){
+            break;
+        }
+        if( !endpoint.isMax && boxes[endpoint.collider].intersects( area ) ){
+            colliders.push_back( endpoint.collider );
+        }
+    }
+
+    for( unsigned int collider : overflow_ ){
+        if( boxes[collider].intersects( area ) ){
+            colliders.push_back( collider );
+        }
+    }
+}
+
+
+/***
+ * 5. Auxiliar methods
+ ***/
+
+bool SweepAndPrune::Endpoint::operator < ( const Endpoint& endpoint ) const
+{
+    // Ties are broken so the order is total (and so deterministic) and
+    // min endpoints go before max ones (boxes without width work too).
+    if( value != endpoint.value ){
+        return value < endpoint.value;
+    }
+    if( isMax != endpoint.isMax ){
+        return !isMax;
+    }
+    return collider < endpoint.collider;
+}
+
+
+float SweepAndPrune::minValue( const sf::FloatRect& box ) const
+{
+    return ( axis_ == SWEEP_AXIS_X ) ?
+                std::min( box.left, box.left + box.width ) :
+                std::min( box.top, box.top + box.height );
+}
+
+
+float SweepAndPrune::maxValue( const sf::FloatRect& box ) const
+{
+    return ( axis_ == SWEEP_AXIS_X ) ?
+                std::max( box.left, box.left + box.width ) :
+                std::max( box.top, box.top + box.height );
+}
+
+
+bool SweepAndPrune::hasNaNInterval( const sf::FloatRect& box ) const
+{
+    // std::min() and std::max() may hide a NaN end, so the edges are checked
+    // instead.
+    const float start = ( axis_ == SWEEP_AXIS_X ) ? box.left : box.top;
+    const float end = ( axis_ == SWEEP_AXIS_X ) ? ( box.left + box.width ) : ( box.top + box.height );
+    return std::isnan( start ) || std::isnan( end );
+}
+
+} // namespace m2g
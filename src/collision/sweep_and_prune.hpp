@@ -0,0 +1,117 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef SWEEP_AND_PRUNE_HPP
+#define SWEEP_AND_PRUNE_HPP
+
+#include "broadphase.hpp"
+
+namespace m2g {
+
+enum SweepAxis
+{
+    SWEEP_AXIS_X = 0,
+    SWEEP_AXIS_Y
+};
+
+
+// Broadphase keeping the box endpoints along one axis sorted between
+// frames. Colliders move little from one frame to the next, so insertion
+// sort restores the order in near linear time, and a sweep over the sorted
+// endpoints finds the overlapping pairs. Needs no tuning, and suits scenes
+// spread along the sweep axis (like side-scrolling levels). Colliders with
+// NaN coordinates along the sweep axis can't be sorted, so they are kept in
+// an overflow list and tested against every other collider instead.
+class SweepAndPrune : public Broadphase
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        explicit SweepAndPrune( SweepAxis axis = SWEEP_AXIS_X );
+
+
+        /***
+         * 2. Getters
+         ***/
+        SweepAxis axis() const;
+        // Endpoint swaps made by insertion sort in the last update (a
+        // measure of how much the order changed).
+        unsigned int nSwaps() const;
+
+
+        /***
+         * 3. Updating
+         ***/
+        virtual void update( const std::vector< sf::FloatRect >& boxes,
+                             const std::vector< unsigned int >& colliders );
+
+
+        /***
+         * 4. Queries
+         ***/
+        virtual void findPairs( std::vector< CollisionPair >& pairs ) const;
+        virtual void query( const sf::FloatRect& area,
+                            std::vector< unsigned int >& colliders ) const;
+
+
+    private:
+        struct Endpoint
+        {
+            float value;
+            unsigned int collider;
+            bool isMax;
+
+            bool operator < ( const Endpoint& endpoint ) const;
+        };
+
+
+        /***
+         * 5. Auxiliar methods
+         ***/
+        // Box interval along the sweep axis (boxes with negative sizes give
+        // the same interval as their positive counterparts).
+        float minValue( const sf::FloatRect& box ) const;
+        float maxValue( const sf::FloatRect& box ) const;
+        bool hasNaNInterval( const sf::FloatRect& box ) const;
+
+
+        /***
+         * Attributes
+         ***/
+        SweepAxis axis_;
+        // Given to the last update() (see Broadphase::update()).
+        const std::vector< sf::FloatRect >* boxes_;
+        // Sorted by value; a box's min endpoint always goes before its max
+        // one.
+        std::vector< Endpoint > endpoints_;
+        std::vector< char > inEndpoints_;
+        unsigned int nSwaps_;
+        // Colliders whose interval has NaN ends.
+        std::vector< unsigned int > overflow_;
+
+        // Colliders whose min endpoint the sweep passed, but not their max
+        // one (kept between calls to reuse memory).
+        mutable std::vector< unsigned int > activeColliders_;
+        mutable std::vector< unsigned int > activePositions_;
+};
+
+} // namespace m2g
+
+#endif // SWEEP_AND_PRUNE_HPP
@@ -0,0 +1,256 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "uniform_grid.hpp"
+#include "../utilities/trace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace m2g {
+
+namespace {
+
+// Cell coordinates are clamped to this range, so they fit in an int and
+// the number of cells between them fits in 64 bits.
+const float MAX_CELL_COORDINATE = 536870912.0f; // 2^29
+
+std::int64_t nCells( int left, int top, int right, int bottom )
+{
+    return ( static_cast< std::int64_t >( right ) - left + 1 ) *
+            ( static_cast< std::int64_t >( bottom ) - top + 1 );
+}
+
+} // namespace
+
+
+/***
+ * 1. Construction
+ ***/
+
+UniformGrid::UniformGrid( float cellSize ) :
+    cellSize_( cellSize ),
+    boxes_( nullptr )
+{
+    if( !( cellSize > 0.0f ) ){
+        throw std::invalid_argument( "Grid cell size must be positive" );
+    }
+}
+
+
+/***
+ * 2. Getters
+ ***/
+
+float UniformGrid::cellSize() const
+{
+    return cellSize_;
+}
+
+
+/***
+ * 3. Updating
+ ***/
+
+void UniformGrid::update( const std::vector< sf::FloatRect >& boxes,
+                          const std::vector< unsigned int >& colliders )
+{
+    M2G_TRACE_SCOPE( "UniformGrid::update" );
+    boxes_ = &boxes;
+
+    for( auto& cell : cells_ ){
+        cell.second.clear();
+    }
+    overflow_.clear();
+
+    for( unsigned int collider : colliders ){
+        const sf::FloatRect& box = boxes[collider];
+        const int left = cellCoordinate( box.left );
+        const int top = cellCoordinate( box.top );
+        const int right = cellCoordinate( box.left + box.width );
+        const int bottom = cellCoordinate( box.top + box.height );
+
+        // Boxes with negative sizes are rare enough to go there too.
+        const std::int64_t nBoxCells = nCells( left, top, right, bottom );
+        if( nBoxCells < 1 || nBoxCells > MAX_GRID_CELLS_PER_COLLIDER ){
+            overflow_.push_back( collider );
+            continue;
+        }
+
+        for( int y = top; y <= bottom; y++ ){
+            for( int x = left; x <= right; x++ ){
+                cells_[cellKey( x, y )].push_back( collider );
+            }
+        }
+    }
+
+    // Cells left empty are dropped, so the map doesn't grow forever with
+    // moving colliders.
+    for( auto it = cells_.begin(); it != cells_.end(); ){
+        if( it->second.empty() ){
+            it = cells_.erase( it );
+        }else{
+            it++;
+        }
+    }
+}
+
+
+/***
+ * 4. Queries
+ ***/
+
+void UniformGrid::findPairs( std::vector< CollisionPair >& pairs ) const
+{
+    M2G_TRACE_SCOPE( "UniformGrid::findPairs" );
+    if( boxes_ == nullptr ){
+        return;
+    }
+    const std::vector< sf::FloatRect >& boxes = *boxes_;
+
+    for( const auto& cell : cells_ ){
+        const std::vector< unsigned int >& colliders = cell.second;
+
+        for( unsigned int i = 0; i < colliders.size(); i++ ){
+            const sf::FloatRect& boxA = boxes[colliders[i]];
+            for( unsigned int j = i + 1; j < colliders.size(); j++ ){
+                const sf::FloatRect& boxB = boxes[colliders[j]];
+                if( !boxA.intersects( boxB ) ){
+                    continue;
+                }
+
+                // Pairs sharing several cells are reported only by the cell
+                // containing the top left corner of their intersection.
+                const int x = cellCoordinate( std::max( boxA.left, boxB.left ) );
+                const int y = cellCoordinate( std::max( boxA.top, boxB.top ) );
+                if( cellKey( x, y ) == cell.first ){
+                    pairs.push_back( CollisionPair{ std::min( colliders[i], colliders[j] ),
+                                                    std::max( colliders[i], colliders[j] ) } );
+                }
+            }
+        }
+    }
+
+    // Overflowing colliders are tested against each other and against the
+    // colliders in the grid.
+    for( unsigned int i = 0; i < overflow_.size(); i++ ){
+        const unsigned int a = overflow_[i];
+        const sf::FloatRect& boxA = boxes[a];
+        for( unsigned int j = i + 1; j < overflow_.size(); j++ ){
+            if( boxA.intersects( boxes[overflow_[j]] ) ){
+                pairs.push_back( CollisionPair{ a, overflow_[j] } );
+            }
+        }
+        for( const auto& cell : cells_ ){
+            for( unsigned int b : cell.second ){
+                if( homeCellKey( boxes[b] ) == cell.first && boxA.intersects( boxes[b] ) ){
+                    pairs.push_back( CollisionPair{ std::min( a, b ), std::max( a, b ) } );
+                }
+            }
+        }
+    }
+}
+
+
+void UniformGrid::query( const sf::FloatRect& area,
+                         std::vector< unsigned int >& colliders ) const
+{
+    if( boxes_ == nullptr ){
+        return;
+    }
+    const std::vector< sf::FloatRect >& boxes = *boxes_;
+    const unsigned int firstResult = colliders.size();
+    const int left = cellCoordinate( area.left );
+    const int top = cellCoordinate( area.top );
+    const int right = cellCoordinate( area.left + area.width );
+    const int bottom = cellCoordinate( area.top + area.height );
+
+    const std::int64_t nAreaCells = nCells( left, top, right, bottom );
+    if( nAreaCells >= 1 && nAreaCells <= static_cast< std::int64_t >( cells_.size() ) ){
+        for( int y = top; y <= bottom; y++ ){
+            for( int x = left; x <= right; x++ ){
+                const auto cell = cells_.find( cellKey( x, y ) );
+                if( cell == cells_.end() ){
+                    continue;
+                }
+                for( unsigned int collider : cell->second ){
+                    if( boxes[collider].intersects( area ) ){
+                        colliders.push_back( collider );
+                    }
+                }
+            }
+        }
+    }else{
+        // Areas spanning more cells than the grid has visit the grid
+        // instead.
+        for( const auto& cell : cells_ ){
+            for( unsigned int collider : cell.second ){
+                if( homeCellKey( boxes[collider] ) == cell.first &&
+                        boxes[collider].intersects( area ) ){
+                    colliders.push_back( collider );
+                }
+            }
+        }
+    }
+
+    for( unsigned int collider : overflow_ ){
+        if( boxes[collider].intersects( area ) ){
+            colliders.push_back( collider );
+        }
+    }
+
+    // Colliders spanning several cells were found several times.
+    std::sort( colliders.begin() + firstResult, colliders.end() );
+    colliders.erase( std::unique( colliders.begin() + firstResult, colliders.end() ),
+                     colliders.end() );
+}
+
+
+/***
+ * 5. Auxiliar methods
+ ***/
+
+int UniformGrid::cellCoordinate( float coordinate ) const
+{
+    const float cell = std::floor( coordinate / cellSize_ );
+
+    // NaN fails the first comparison.
+    if( !( cell > -MAX_CELL_COORDINATE ) ){
+        return -static_cast< int >( MAX_CELL_COORDINATE );
+    }
+    if( cell > MAX_CELL_COORDINATE ){
+        return static_cast< int >( MAX_CELL_COORDINATE );
+    }
+    return static_cast< int >( cell );
+}
+
+
+std::uint64_t UniformGrid::cellKey( int x, int y )
+{
+    return ( static_cast< std::uint64_t >( static_cast< std::uint32_t >( x ) ) << 32 ) |
+            static_cast< std::uint32_t >( y );
+}
+
+
+std::uint64_t UniformGrid::homeCellKey( const sf::FloatRect& box ) const
+{
+    return cellKey( cellCoordinate( box.left ), cellCoordinate( box.top ) );
+}
+
+} // namespace m2g
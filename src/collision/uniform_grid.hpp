@@ -0,0 +1,94 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef UNIFORM_GRID_HPP
+#define UNIFORM_GRID_HPP
+
+#include "broadphase.hpp"
+#include <cstdint>
+#include <unordered_map>
+
+namespace m2g {
+
+// Colliders spanning more cells than this are kept out of the grid.
+const unsigned int MAX_GRID_CELLS_PER_COLLIDER = 64;
+
+// Broadphase hashing colliders into square cells. Cheap to rebuild every
+// frame; works best when the cell size is around the size of most
+// colliders. Colliders much bigger than the cells (or with infinite or NaN
+// coordinates) are kept in an overflow list and tested against every other
+// collider instead.
+class UniformGrid : public Broadphase
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        explicit UniformGrid( float cellSize = 64.0f );
+
+
+        /***
+         * 2. Getters
+         ***/
+        float cellSize() const;
+
+
+        /***
+         * 3. Updating
+         ***/
+        virtual void update( const std::vector< sf::FloatRect >& boxes,
+                             const std::vector< unsigned int >& colliders );
+
+
+        /***
+         * 4. Queries
+         ***/
+        virtual void findPairs( std::vector< CollisionPair >& pairs ) const;
+        virtual void query( const sf::FloatRect& area,
+                            std::vector< unsigned int >& colliders ) const;
+
+
+    private:
+        /***
+         * 5. Auxiliar methods
+         ***/
+        // Clamped to a range where cell keys don't overflow (NaN gives the
+        // lowest coordinate).
+        int cellCoordinate( float coordinate ) const;
+        static std::uint64_t cellKey( int x, int y );
+        // Cell holding the top left corner of the box. Colliders found in
+        // several cells are only taken from this one.
+        std::uint64_t homeCellKey( const sf::FloatRect& box ) const;
+
+
+        /***
+         * Attributes
+         ***/
+        float cellSize_;
+        // Given to the last update() (see Broadphase::update()).
+        const std::vector< sf::FloatRect >* boxes_;
+        // Cells kept from previous frames, to reuse their memory.
+        std::unordered_map< std::uint64_t, std::vector< unsigned int > > cells_;
+        // Colliders spanning too many cells, sorted.
+        std::vector< unsigned int > overflow_;
+};
+
+} // namespace m2g
+
+#endif // UNIFORM_GRID_HPP
@@ -18,6 +18,8 @@
 ***/
 
 #include "animation.hpp"
+#include "../utilities/trace.hpp"
+#include "../utilities/stats.hpp"
 
 namespace m2g {
 
@@ -75,6 +77,7 @@ void Animation::setAnimationData( const AnimationData &animData )
         throw std::invalid_argument( "animData can't be empty (0 states)" );
     }
     animData_ = &animData;
+    animDataRevision_ = animData.revision();
     TileSprite::setTileset( animData_->tileset() );
     setState( 0 );
 }
@@ -87,6 +90,9 @@ void Animation::setAnimationData( const AnimationData &animData )
 void Animation::setState( unsigned int newState )
 {
     currentState_ = newState;
+
+    // The state's tile transform replaces any previous one.
+    setTileTransform( animData_->state( currentState_ ).tileTransform );
     setTile( animData_->state( currentState_ ).firstFrame );
 }
 
@@ -110,6 +116,12 @@ void Animation::setTile( unsigned int tile )
 
 void Animation::update( unsigned int ms )
 {
+    M2G_TRACE_SCOPE( "Animation::update" );
+    Stats::increment( STAT_ANIMATION_UPDATES );
+    if( animDataRevision_ != animData_->revision() ){
+        syncWithAnimationData();
+    }
+
     const unsigned int MS_PER_FRAME = (1000 / animData_->refreshRate());
 
     const unsigned int N_FRAMES = ( timeInCurrentFrame_ + ms ) / MS_PER_FRAME;
@@ -129,4 +141,26 @@ void Animation::update( unsigned int ms )
 }
 
 
+/***
+ * 6. Auxiliar methods
+ ***/
+
+void Animation::syncWithAnimationData()
+{
+    animDataRevision_ = animData_->revision();
+
+    if( currentState_ >= animData_->nStates() ){
+        setState( 0 );
+        return;
+    }
+
+    const AnimationState state = animData_->state( currentState_ );
+    setTileTransform( state.tileTransform );
+    if( currentFrame_ < std::min( state.backFrame, state.firstFrame ) ||
+        currentFrame_ > state.lastFrame ){
+        setTile( state.firstFrame );
+    }
+}
+
+
 } // namespace m2g
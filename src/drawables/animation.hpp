@@ -65,8 +65,20 @@ class Animation : public TileSprite
 
 
     private:
+        /***
+         * 6. Auxiliar methods
+         ***/
+        // Keeps the current state and frame valid after the animation data
+        // is reloaded.
+        void syncWithAnimationData();
+
+
+        /***
+         * Attributes
+         ***/
         AnimationDataPtr ownAnimData_;
         AnimationData const* animData_;
+        unsigned int animDataRevision_;
         unsigned int currentState_;
         unsigned int currentFrame_;
         unsigned int timeInCurrentFrame_;
@@ -18,9 +18,21 @@
 ***/
 
 #include "animation_data.hpp"
+#include <atomic>
 
 namespace m2g {
 
+namespace {
+
+unsigned int nextRevision()
+{
+    static std::atomic< unsigned int > lastRevision( 0 );
+    return ++lastRevision;
+}
+
+} // namespace
+
+
 /***
  * 1. Construction
  ***/
@@ -29,8 +41,11 @@ AnimationData::AnimationData( const Tileset& tileset,
                               unsigned int refreshRate ) :
     ownTileset_( nullptr ),
     tileset_( &tileset ),
-    refreshRate_( refreshRate )
-{}
+    data_( new Data )
+{
+    data_->refreshRate = refreshRate;
+    data_->revision = nextRevision();
+}
 
 
 AnimationData::AnimationData( TilesetPtr tileset,
@@ -41,19 +56,31 @@ AnimationData::AnimationData( TilesetPtr tileset,
 }
 
 
+AnimationData::AnimationData( const AnimationData& b ) :
+    ownTileset_( nullptr ),
+    tileset_( b.tileset_ ),
+    data_( b.data_ )
+{
+    if( b.ownTileset_ != nullptr ){
+        ownTileset_.reset( new Tileset( *( b.ownTileset_ ) ) );
+        tileset_ = ownTileset_.get();
+    }
+}
+
+
 /***
  * 3. Getters
  ***/
 
 AnimationState AnimationData::state( unsigned int index ) const
 {
-    return states_.at( index );
+    return data_->states.at( index );
 }
 
 
 unsigned int AnimationData::nStates() const
 {
-    return states_.size();
+    return data_->states.size();
 }
 
 
@@ -65,7 +92,19 @@ const Tileset &AnimationData::tileset() const
 
 unsigned int AnimationData::refreshRate() const
 {
-    return refreshRate_;
+    return data_->refreshRate;
+}
+
+
+unsigned int AnimationData::revision() const
+{
+    return data_->revision;
+}
+
+
+bool AnimationData::sharesContents() const
+{
+    return data_.use_count() > 1 || tileset_->sharesContents();
 }
 
 
@@ -78,7 +117,44 @@ void AnimationData::addState( const AnimationState &newState )
     if( newState.lastFrame >= tileset_->nTiles() ){
         throw std::out_of_range( "lastFrame" );
     }
-    states_.push_back( newState );
+    Data& data = mutableData();
+    data.states.push_back( newState );
+    data.revision = nextRevision();
+}
+
+
+/***
+ * 5. Reloading
+ ***/
+
+void AnimationData::reload( const AnimationData& animData )
+{
+    if( ownTileset_ != nullptr ){
+        ownTileset_->reload( animData.tileset() );
+    }
+
+    // AnimationState isn't assignable, so states are copied one by one.
+    const Data source = *( animData.data_ );
+    data_->refreshRate = source.refreshRate;
+    data_->states.clear();
+    for( const AnimationState& state : source.states ){
+        data_->states.push_back( state );
+    }
+    data_->revision = nextRevision();
+}
+
+
+/***
+ * 6. Auxiliar methods
+ ***/
+
+AnimationData::Data& AnimationData::mutableData()
+{
+    // Copy on write: changes made through a copy don't reach the others.
+    if( data_.use_count() > 1 ){
+        data_ = std::make_shared< Data >( *data_ );
+    }
+    return *data_;
 }
 
 } // namespace m2g
@@ -36,6 +36,10 @@ class AnimationData
         AnimationData( const Tileset& tileset, unsigned int refreshRate = DEFAULT_ANIMATION_REFRESH_RATE );
         AnimationData( TilesetPtr tileset, unsigned int refreshRate );
 
+        // Copies share the states (copy on write) and, when the animation
+        // data owns its tileset, the tileset contents too.
+        AnimationData( const AnimationData& b );
+
         /***
          * 2. Destruction
          ***/
@@ -50,6 +54,13 @@ class AnimationData
         const Tileset& tileset() const;
         unsigned int refreshRate() const;
 
+        // Changes every time the states or the refresh rate change.
+        unsigned int revision() const;
+
+        // True while other copies share the contents of this AnimationData
+        // or its tileset.
+        bool sharesContents() const;
+
 
         /***
          * 4. States management
@@ -57,11 +68,35 @@ class AnimationData
         void addState( const AnimationState& newState );
 
 
+        /***
+         * 5. Reloading
+         ***/
+        // Replaces the states, refresh rate and owned tileset contents
+        // shared by this animation data and its copies with the given
+        // ones (see Tileset::reload).
+        void reload( const AnimationData& animData );
+
+
     private:
+        struct Data
+        {
+            unsigned int refreshRate;
+            std::vector< AnimationState > states;
+            unsigned int revision;
+        };
+
+        /***
+         * 6. Auxiliar methods
+         ***/
+        Data& mutableData();
+
+
+        /***
+         * Attributes
+         ***/
         TilesetPtr ownTileset_;
         const Tileset* tileset_;
-        unsigned int refreshRate_;
-        std::vector< AnimationState > states_;
+        std::shared_ptr< Data > data_;
 };
 
 typedef std::unique_ptr< AnimationData > AnimationDataPtr;
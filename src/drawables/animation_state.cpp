@@ -29,7 +29,8 @@ namespace m2g {
 AnimationState::AnimationState() :
     firstFrame( 0 ),
     lastFrame( 0 ),
-    backFrame( 0 )
+    backFrame( 0 ),
+    tileTransform( TILE_TRANSFORM_NONE )
 {}
 
 
@@ -37,7 +38,8 @@ AnimationState::AnimationState( unsigned int firstFrame,
                                 unsigned int lastFrame ) :
     firstFrame( firstFrame ),
     lastFrame( lastFrame ),
-    backFrame( firstFrame )
+    backFrame( firstFrame ),
+    tileTransform( TILE_TRANSFORM_NONE )
 {
     throwIfLastFrameGreaterThanFirstFrame();
 }
@@ -46,15 +48,27 @@ AnimationState::AnimationState( unsigned int firstFrame,
 AnimationState::AnimationState( unsigned int firstFrame,
                                 unsigned int lastFrame,
                                 unsigned int backFrame ) :
+    AnimationState( firstFrame, lastFrame, backFrame, TILE_TRANSFORM_NONE )
+{}
+
+
+AnimationState::AnimationState( unsigned int firstFrame,
+                                unsigned int lastFrame,
+                                unsigned int backFrame,
+                                TileTransform tileTransform ) :
     firstFrame( firstFrame ),
     lastFrame( lastFrame ),
-    backFrame( backFrame )
+    backFrame( backFrame ),
+    tileTransform( tileTransform )
 {
     throwIfLastFrameGreaterThanFirstFrame();
 
     if( backFrame > lastFrame ){
         throw std::invalid_argument( "backFrame mustn't be greater than lastFrame" );
     }
+    if( tileTransform > TILE_TRANSFORM_ALL ){
+        throw std::invalid_argument( "Invalid tileTransform" );
+    }
 }
 
 
@@ -66,7 +80,8 @@ bool AnimationState::operator ==(const AnimationState &b) const
 {
     return ( firstFrame == b.firstFrame &&
              lastFrame == b.lastFrame &&
-             backFrame == b.backFrame );
+             backFrame == b.backFrame &&
+             tileTransform == b.tileTransform );
 }
 
 
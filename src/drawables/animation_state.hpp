@@ -20,6 +20,8 @@
 #ifndef ANIMATION_STATE_HPP
 #define ANIMATION_STATE_HPP
 
+#include "tile_transform.hpp"
+
 namespace m2g {
 
 class AnimationState {
@@ -33,6 +35,10 @@ class AnimationState {
         AnimationState( unsigned int firstFrame,
                         unsigned int lastFrame,
                         unsigned int backFrame );
+        AnimationState( unsigned int firstFrame,
+                        unsigned int lastFrame,
+                        unsigned int backFrame,
+                        TileTransform tileTransform );
 
 
         /***
@@ -48,6 +54,10 @@ class AnimationState {
         const unsigned int lastFrame;
         const unsigned int backFrame;
 
+        // Transform applied to every frame (ie. a left-facing state reusing
+        // the frames of a right-facing one).
+        const TileTransform tileTransform;
+
 
 
 
@@ -0,0 +1,179 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "dynamic_atlas.hpp"
+#include "../utilities/stats.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace m2g {
+
+/***
+ * AtlasRegion - 1. Destruction
+ ***/
+
+AtlasRegion::~AtlasRegion()
+{
+    atlas_.release( page_, allocatedRect_ );
+}
+
+
+/***
+ * AtlasRegion - 2. Getters
+ ***/
+
+std::shared_ptr< const sf::Texture > AtlasRegion::texture() const
+{
+    return atlas_.page( page_ );
+}
+
+
+sf::IntRect AtlasRegion::rect() const
+{
+    return rect_;
+}
+
+
+unsigned int AtlasRegion::page() const
+{
+    return page_;
+}
+
+
+AtlasRegion::AtlasRegion( DynamicAtlas& atlas,
+                          unsigned int page,
+                          const sf::IntRect& rect,
+                          const sf::IntRect& allocatedRect ) :
+    atlas_( atlas ),
+    page_( page ),
+    rect_( rect ),
+    allocatedRect_( allocatedRect )
+{}
+
+
+/***
+ * DynamicAtlas - 1. Construction
+ ***/
+
+DynamicAtlas::DynamicAtlas( unsigned int pageSize, unsigned int padding ) :
+    pageSize_( std::min( pageSize, sf::Texture::getMaximumSize() ) ),
+    padding_( padding )
+{}
+
+
+/***
+ * DynamicAtlas - 2. Getters
+ ***/
+
+unsigned int DynamicAtlas::pageSize() const
+{
+    return pageSize_;
+}
+
+
+unsigned int DynamicAtlas::nPages() const
+{
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return pages_.size();
+}
+
+
+std::shared_ptr< const sf::Texture > DynamicAtlas::page( unsigned int index ) const
+{
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return pages_.at( index ).texture;
+}
+
+
+unsigned int DynamicAtlas::usedArea( unsigned int page ) const
+{
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return pages_.at( page ).packer.usedArea();
+}
+
+
+/***
+ * DynamicAtlas - 3. Allocation
+ ***/
+
+AtlasRegionPtr DynamicAtlas::allocate( const sf::Image& image )
+{
+    const sf::Vector2u size = image.getSize();
+    if( size.x > pageSize_ || size.y > pageSize_ ){
+        throw std::invalid_argument( "DynamicAtlas::allocate - image bigger than atlas page" );
+    }
+
+    const unsigned int paddedWidth = std::min( size.x + padding_, pageSize_ );
+    const unsigned int paddedHeight = std::min( size.y + padding_, pageSize_ );
+
+    std::lock_guard< std::mutex > lock( mutex_ );
+
+    sf::Vector2u position;
+    unsigned int pageIndex = 0;
+    while( pageIndex < pages_.size() &&
+           !pages_[pageIndex].packer.insert( paddedWidth, paddedHeight, position ) ){
+        pageIndex++;
+    }
+
+    if( pageIndex == pages_.size() ){
+        std::unique_ptr< sf::Texture > texture( new sf::Texture );
+        if( !texture->create( pageSize_, pageSize_ ) ){
+            throw std::runtime_error( "DynamicAtlas::allocate - couldn't create atlas page" );
+        }
+        AtlasPage newPage = {
+            Stats::trackTexture( std::move( texture ) ),
+            GuillotinePacker( pageSize_, pageSize_ )
+        };
+        newPage.packer.insert( paddedWidth, paddedHeight, position );
+        pages_.push_back( newPage );
+    }
+
+    if( paddedWidth == size.x && paddedHeight == size.y ){
+        pages_[pageIndex].texture->update( image, position.x, position.y );
+    }else{
+        // Fresh pages are undefined and released regions keep stale pixels,
+        // so the padding is cleared to transparent along with the image.
+        sf::Image paddedImage;
+        paddedImage.create( paddedWidth, paddedHeight, sf::Color::Transparent );
+        paddedImage.copy( image, 0, 0 );
+        pages_[pageIndex].texture->update( paddedImage, position.x, position.y );
+    }
+
+    // The padding is allocated too, so it's given back along with the image.
+    return AtlasRegionPtr(
+                new AtlasRegion( *this,
+                                 pageIndex,
+                                 sf::IntRect( position.x, position.y,
+                                              size.x, size.y ),
+                                 sf::IntRect( position.x, position.y,
+                                              paddedWidth, paddedHeight ) ) );
+}
+
+
+/***
+ * DynamicAtlas - 4. Auxiliar methods
+ ***/
+
+void DynamicAtlas::release( unsigned int page, const sf::IntRect& rect )
+{
+    std::lock_guard< std::mutex > lock( mutex_ );
+    pages_.at( page ).packer.release( rect );
+}
+
+} // namespace m2g
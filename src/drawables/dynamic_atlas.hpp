@@ -0,0 +1,137 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef DYNAMIC_ATLAS_HPP
+#define DYNAMIC_ATLAS_HPP
+
+#include "../utilities/guillotine_packer.hpp"
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace m2g {
+
+const unsigned int DEFAULT_DYNAMIC_ATLAS_PAGE_SIZE = 2048;
+const unsigned int DEFAULT_DYNAMIC_ATLAS_PADDING = 1;
+
+class DynamicAtlas;
+
+// Region of a DynamicAtlas page. The region is given back to the atlas when
+// destroyed.
+class AtlasRegion
+{
+    public:
+        /***
+         * 1. Destruction
+         ***/
+        ~AtlasRegion();
+        AtlasRegion( const AtlasRegion& ) = delete;
+        AtlasRegion& operator = ( const AtlasRegion& ) = delete;
+
+
+        /***
+         * 2. Getters
+         ***/
+        std::shared_ptr< const sf::Texture > texture() const;
+        sf::IntRect rect() const;
+        unsigned int page() const;
+
+
+    private:
+        friend class DynamicAtlas;
+
+        AtlasRegion( DynamicAtlas& atlas,
+                     unsigned int page,
+                     const sf::IntRect& rect,
+                     const sf::IntRect& allocatedRect );
+
+        DynamicAtlas& atlas_;
+        unsigned int page_;
+        sf::IntRect rect_;
+
+        // Image rect plus padding.
+        sf::IntRect allocatedRect_;
+};
+
+typedef std::shared_ptr< AtlasRegion > AtlasRegionPtr;
+
+
+// Set of big textures ("pages") where images known only at runtime are packed
+// together, so sprites using them share textures. New pages are created when
+// the existing ones are full. The atlas must outlive all its regions. Regions
+// can be allocated and released from any thread.
+class DynamicAtlas
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        DynamicAtlas( unsigned int pageSize = DEFAULT_DYNAMIC_ATLAS_PAGE_SIZE,
+                      unsigned int padding = DEFAULT_DYNAMIC_ATLAS_PADDING );
+        DynamicAtlas( const DynamicAtlas& ) = delete;
+        DynamicAtlas& operator = ( const DynamicAtlas& ) = delete;
+
+
+        /***
+         * 2. Getters
+         ***/
+        unsigned int pageSize() const;
+        unsigned int nPages() const;
+        std::shared_ptr< const sf::Texture > page( unsigned int index ) const;
+        unsigned int usedArea( unsigned int page ) const;
+
+
+        /***
+         * 3. Allocation
+         ***/
+        AtlasRegionPtr allocate( const sf::Image& image );
+
+
+    private:
+        friend class AtlasRegion;
+
+        /***
+         * 4. Auxiliar methods
+         ***/
+        void release( unsigned int page, const sf::IntRect& rect );
+
+
+        /***
+         * Attributes
+         ***/
+        struct AtlasPage
+        {
+            std::shared_ptr< sf::Texture > texture;
+            GuillotinePacker packer;
+        };
+
+        unsigned int pageSize_;
+        unsigned int padding_;
+
+        // Guards pages_ (and their packers) for allocation, release and page
+        // creation.
+        mutable std::mutex mutex_;
+        std::vector< AtlasPage > pages_;
+};
+
+} // namespace m2g
+
+#endif // DYNAMIC_ATLAS_HPP
@@ -0,0 +1,622 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "sprite_store.hpp"
+#include "../utilities/trace.hpp"
+#include "../utilities/stats.hpp"
+#include "../utilities/rect_batch.hpp"
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace m2g {
+
+const float PI = 3.141592654f;
+
+/***
+ * SpriteHandle
+ ***/
+
+bool SpriteHandle::operator == ( const SpriteHandle& handle ) const
+{
+    return index == handle.index && generation == handle.generation;
+}
+
+
+bool SpriteHandle::operator != ( const SpriteHandle& handle ) const
+{
+    return !( *this == handle );
+}
+
+
+/***
+ * 1. Construction
+ ***/
+
+SpriteStore::SpriteStore()
+{}
+
+
+/***
+ * 2. Tilesets
+ ***/
+
+unsigned int SpriteStore::addTileset( const Tileset& tileset )
+{
+    tilesets_.push_back( &tileset );
+    return tilesets_.size() - 1;
+}
+
+
+const Tileset& SpriteStore::tileset( unsigned int tilesetId ) const
+{
+    if( tilesetId >= tilesets_.size() ){
+        throw std::out_of_range( "Tileset id out of range" );
+    }
+    return *( tilesets_[tilesetId] );
+}
+
+
+unsigned int SpriteStore::nTilesets() const
+{
+    return tilesets_.size();
+}
+
+
+/***
+ * 3. Sprites management
+ ***/
+
+SpriteHandle SpriteStore::create( unsigned int tilesetId,
+                                  unsigned int tile,
+                                  const sf::Vector2f& position )
+{
+    checkTile( tilesetId, tile );
+
+    std::uint32_t slotIndex;
+    if( freeSlots_.size() ){
+        slotIndex = freeSlots_.back();
+        freeSlots_.pop_back();
+    }else{
+        slotIndex = slots_.size();
+        slots_.push_back( Slot{ 0, 0 } );
+    }
+
+    const std::uint32_t denseIndex = slotIndices_.size();
+    slots_[slotIndex].denseIndex = denseIndex;
+
+    slotIndices_.push_back( slotIndex );
+    positionsX_.push_back( position.x );
+    positionsY_.push_back( position.y );
+    scalesX_.push_back( 1.0f );
+    scalesY_.push_back( 1.0f );
+    rotations_.push_back( 0.0f );
+    tiles_.push_back( tile );
+    tilesetIds_.push_back( tilesetId );
+
+    const sf::Vector2u tileDimensions = tilesets_[tilesetId]->tileDimensions();
+    boundsLeft_.push_back( position.x );
+    boundsTop_.push_back( position.y );
+    boundsRight_.push_back( position.x + tileDimensions.x );
+    boundsBottom_.push_back( position.y + tileDimensions.y );
+
+    return SpriteHandle{ slotIndex, slots_[slotIndex].generation };
+}
+
+
+void SpriteStore::destroy( SpriteHandle sprite )
+{
+    const unsigned int denseIndex = checkedDenseIndex( sprite );
+
+    // Invalidates every handle to the sprite.
+    slots_[sprite.index].generation++;
+    freeSlots_.push_back( sprite.index );
+
+    removeDense( denseIndex );
+}
+
+
+bool SpriteStore::valid( SpriteHandle sprite ) const
+{
+    return sprite.index < slots_.size() &&
+            slots_[sprite.index].generation == sprite.generation &&
+            slots_[sprite.index].denseIndex < slotIndices_.size() &&
+            slotIndices_[slots_[sprite.index].denseIndex] == sprite.index;
+}
+
+
+void SpriteStore::clear()
+{
+    for( std::uint32_t slotIndex : slotIndices_ ){
+        slots_[slotIndex].generation++;
+        freeSlots_.push_back( slotIndex );
+    }
+
+    slotIndices_.clear();
+    positionsX_.clear();
+    positionsY_.clear();
+    scalesX_.clear();
+    scalesY_.clear();
+    rotations_.clear();
+    tiles_.clear();
+    tilesetIds_.clear();
+    boundsLeft_.clear();
+    boundsTop_.clear();
+    boundsRight_.clear();
+    boundsBottom_.clear();
+}
+
+
+void SpriteStore::reserve( unsigned int nSprites )
+{
+    slots_.reserve( nSprites );
+    slotIndices_.reserve( nSprites );
+    positionsX_.reserve( nSprites );
+    positionsY_.reserve( nSprites );
+    scalesX_.reserve( nSprites );
+    scalesY_.reserve( nSprites );
+    rotations_.reserve( nSprites );
+    tiles_.reserve( nSprites );
+    tilesetIds_.reserve( nSprites );
+    boundsLeft_.reserve( nSprites );
+    boundsTop_.reserve( nSprites );
+    boundsRight_.reserve( nSprites );
+    boundsBottom_.reserve( nSprites );
+}
+
+
+unsigned int SpriteStore::size() const
+{
+    return slotIndices_.size();
+}
+
+
+/***
+ * 4. Getters
+ ***/
+
+sf::Vector2f SpriteStore::position( SpriteHandle sprite ) const
+{
+    const unsigned int i = checkedDenseIndex( sprite );
+    return sf::Vector2f( positionsX_[i], positionsY_[i] );
+}
+
+
+sf::Vector2f SpriteStore::scale( SpriteHandle sprite ) const
+{
+    const unsigned int i = checkedDenseIndex( sprite );
+    return sf::Vector2f( scalesX_[i], scalesY_[i] );
+}
+
+
+float SpriteStore::rotation( SpriteHandle sprite ) const
+{
+    return rotations_[checkedDenseIndex( sprite )];
+}
+
+
+unsigned int SpriteStore::tile( SpriteHandle sprite ) const
+{
+    return tiles_[checkedDenseIndex( sprite )];
+}
+
+
+unsigned int SpriteStore::tilesetId( SpriteHandle sprite ) const
+{
+    return tilesetIds_[checkedDenseIndex( sprite )];
+}
+
+
+sf::FloatRect SpriteStore::boundaryBox( SpriteHandle sprite ) const
+{
+    const unsigned int i = checkedDenseIndex( sprite );
+    return sf::FloatRect( boundsLeft_[i],
+                          boundsTop_[i],
+                          boundsRight_[i] - boundsLeft_[i],
+                          boundsBottom_[i] - boundsTop_[i] );
+}
+
+
+/***
+ * 5. Setters
+ ***/
+
+void SpriteStore::setPosition( SpriteHandle sprite, const sf::Vector2f& position )
+{
+    const unsigned int i = checkedDenseIndex( sprite );
+    positionsX_[i] = position.x;
+    positionsY_[i] = position.y;
+}
+
+
+void SpriteStore::setScale( SpriteHandle sprite, const sf::Vector2f& scale )
+{
+    const unsigned int i = checkedDenseIndex( sprite );
+    scalesX_[i] = scale.x;
+    scalesY_[i] = scale.y;
+}
+
+
+void SpriteStore::setRotation( SpriteHandle sprite, float angle )
+{
+    // Same range as sf::Transformable::setRotation().
+    angle = static_cast< float >( std::fmod( angle, 360.0f ) );
+    if( angle < 0.0f ){
+        angle += 360.0f;
+    }
+    rotations_[checkedDenseIndex( sprite )] = angle;
+}
+
+
+void SpriteStore::setTile( SpriteHandle sprite, unsigned int tile )
+{
+    const unsigned int i = checkedDenseIndex( sprite );
+    checkTile( tilesetIds_[i], tile );
+    tiles_[i] = tile;
+}
+
+
+void SpriteStore::setTileset( SpriteHandle sprite, unsigned int tilesetId, unsigned int tile )
+{
+    const unsigned int i = checkedDenseIndex( sprite );
+    checkTile( tilesetId, tile );
+    tilesetIds_[i] = tilesetId;
+    tiles_[i] = tile;
+}
+
+
+/***
+ * 6. Bulk access
+ ***/
+
+SpriteHandle SpriteStore::handle( unsigned int denseIndex ) const
+{
+    if( denseIndex >= slotIndices_.size() ){
+        throw std::out_of_range( "Sprite index out of range" );
+    }
+    const std::uint32_t slotIndex = slotIndices_[denseIndex];
+    return SpriteHandle{ slotIndex, slots_[slotIndex].generation };
+}
+
+
+unsigned int SpriteStore::denseIndex( SpriteHandle sprite ) const
+{
+    return checkedDenseIndex( sprite );
+}
+
+
+float* SpriteStore::positionsX()
+{
+    return positionsX_.data();
+}
+
+
+float* SpriteStore::positionsY()
+{
+    return positionsY_.data();
+}
+
+
+const float* SpriteStore::positionsX() const
+{
+    return positionsX_.data();
+}
+
+
+const float* SpriteStore::positionsY() const
+{
+    return positionsY_.data();
+}
+
+
+void SpriteStore::move( const float* offsetsX, const float* offsetsY )
+{
+    M2G_TRACE_SCOPE( "SpriteStore::move" );
+    const unsigned int nSprites = size();
+    float* positionsX = positionsX_.data();
+    float* positionsY = positionsY_.data();
+
+    for( unsigned int i = 0; i < nSprites; i++ ){
+        positionsX[i] += offsetsX[i];
+    }
+    for( unsigned int i = 0; i < nSprites; i++ ){
+        positionsY[i] += offsetsY[i];
+    }
+}
+
+
+/***
+ * 7. Bulk passes
+ ***/
+
+void SpriteStore::updateBounds()
+{
+    M2G_TRACE_SCOPE( "SpriteStore::updateBounds" );
+    const unsigned int nSprites = size();
+
+    for( unsigned int i = 0; i < nSprites; i++ ){
+        const sf::Vector2u tileDimensions =
+                tilesets_[tilesetIds_[i]]->tileDimensions();
+        const sf::FloatRect bounds =
+                transformRect( i, sf::FloatRect( 0.0f, 0.0f, tileDimensions.x, tileDimensions.y ) );
+
+        boundsLeft_[i] = bounds.left;
+        boundsTop_[i] = bounds.top;
+        boundsRight_[i] = bounds.left + bounds.width;
+        boundsBottom_[i] = bounds.top + bounds.height;
+    }
+}
+
+
+void SpriteStore::cull( const sf::FloatRect& area,
+                        std::vector< SpriteHandle >& visibleSprites ) const
+{
+    M2G_TRACE_SCOPE( "SpriteStore::cull" );
+    const unsigned int nSprites = size();
+    const float areaRight = area.left + area.width;
+    const float areaBottom = area.top + area.height;
+
+    for( unsigned int i = 0; i < nSprites; i++ ){
+        if( boundsLeft_[i] < areaRight && area.left < boundsRight_[i] &&
+                boundsTop_[i] < areaBottom && area.top < boundsBottom_[i] ){
+            const std::uint32_t slotIndex = slotIndices_[i];
+            visibleSprites.push_back( SpriteHandle{ slotIndex, slots_[slotIndex].generation } );
+        }
+    }
+}
+
+
+bool SpriteStore::collide( SpriteHandle a, SpriteHandle b ) const
+{
+    Stats::increment( STAT_SPRITE_COLLIDES );
+    return collideDense( checkedDenseIndex( a ), checkedDenseIndex( b ) );
+}
+
+
+void SpriteStore::findCollisions( SpriteHandle sprite,
+                                  std::vector< SpriteHandle >& collisions ) const
+{
+    M2G_TRACE_SCOPE( "SpriteStore::findCollisions" );
+    const unsigned int a = checkedDenseIndex( sprite );
+    const unsigned int nSprites = size();
+    const float left = boundsLeft_[a];
+    const float top = boundsTop_[a];
+    const float right = boundsRight_[a];
+    const float bottom = boundsBottom_[a];
+
+    // Boundary boxes discard most candidates without touching the
+    // tilesets.
+    unsigned int nTests = 0;
+    for( unsigned int b = 0; b < nSprites; b++ ){
+        if( boundsLeft_[b] < right && left < boundsRight_[b] &&
+                boundsTop_[b] < bottom && top < boundsBottom_[b] && b != a ){
+            nTests++;
+            if( collideDense( a, b ) ){
+                const std::uint32_t slotIndex = slotIndices_[b];
+                collisions.push_back( SpriteHandle{ slotIndex, slots_[slotIndex].generation } );
+            }
+        }
+    }
+    Stats::increment( STAT_SPRITE_COLLIDES, nTests );
+}
+
+
+/***
+ * 8. Drawing
+ ***/
+
+void SpriteStore::draw( sf::RenderTarget& target, sf::RenderStates states ) const
+{
+    M2G_TRACE_SCOPE( "SpriteStore::draw" );
+    const unsigned int nSprites = size();
+    Stats::increment( STAT_SPRITE_DRAWS, nSprites );
+
+    for( auto& batch : batches_ ){
+        batch.second.clear();
+    }
+
+    for( unsigned int i = 0; i < nSprites; i++ ){
+        const Tileset& tileset = *( tilesets_[tilesetIds_[i]] );
+        const unsigned int tile = tiles_[i];
+        const sf::IntRect tileRect = tileset.tileRect( tile );
+        std::vector< sf::Vertex >& vertices =
+                batches_[&( tileset.texture( tileset.tilePage( tile ) ) )];
+
+        const float radians = rotations_[i] * PI / 180.0f;
+        const float cosine = std::cos( radians );
+        const float sine = std::sin( radians );
+        const float width = tileRect.width;
+        const float height = tileRect.height;
+        const float corners[4][2] =
+        {
+            { 0.0f, 0.0f },
+            { width, 0.0f },
+            { width, height },
+            { 0.0f, height }
+        };
+
+        for( unsigned int j = 0; j < 4; j++ ){
+            const float x = corners[j][0] * scalesX_[i];
+            const float y = corners[j][1] * scalesY_[i];
+            vertices.push_back(
+                        sf::Vertex( sf::Vector2f( positionsX_[i] + cosine * x - sine * y,
+                                                  positionsY_[i] + sine * x + cosine * y ),
+                                    sf::Vector2f( tileRect.left + corners[j][0],
+                                                  tileRect.top + corners[j][1] ) ) );
+        }
+    }
+
+    for( const auto& batch : batches_ ){
+        if( batch.second.size() ){
+            states.texture = batch.first;
+            target.draw( batch.second.data(), batch.second.size(), sf::Quads, states );
+        }
+    }
+}
+
+
+/***
+ * 9. Auxiliar methods
+ ***/
+
+unsigned int SpriteStore::checkedDenseIndex( SpriteHandle sprite ) const
+{
+    if( !valid( sprite ) ){
+        throw std::out_of_range( "Invalid sprite handle" );
+    }
+    return slots_[sprite.index].denseIndex;
+}
+
+
+void SpriteStore::checkTile( unsigned int tilesetId, unsigned int tile ) const
+{
+    if( tile >= tileset( tilesetId ).nTiles() ){
+        throw std::out_of_range( "Tile out of range" );
+    }
+}
+
+
+void SpriteStore::removeDense( unsigned int denseIndex )
+{
+    // Moves the last sprite to the removed one place, so the arrays stay
+    // packed.
+    const unsigned int last = slotIndices_.size() - 1;
+    if( denseIndex != last ){
+        slotIndices_[denseIndex] = slotIndices_[last];
+        positionsX_[denseIndex] = positionsX_[last];
+        positionsY_[denseIndex] = positionsY_[last];
+        scalesX_[denseIndex] = scalesX_[last];
+        scalesY_[denseIndex] = scalesY_[last];
+        rotations_[denseIndex] = rotations_[last];
+        tiles_[denseIndex] = tiles_[last];
+        tilesetIds_[denseIndex] = tilesetIds_[last];
+        boundsLeft_[denseIndex] = boundsLeft_[last];
+        boundsTop_[denseIndex] = boundsTop_[last];
+        boundsRight_[denseIndex] = boundsRight_[last];
+        boundsBottom_[denseIndex] = boundsBottom_[last];
+        slots_[slotIndices_[denseIndex]].denseIndex = denseIndex;
+    }
+
+    slotIndices_.pop_back();
+    positionsX_.pop_back();
+    positionsY_.pop_back();
+    scalesX_.pop_back();
+    scalesY_.pop_back();
+    rotations_.pop_back();
+    tiles_.pop_back();
+    tilesetIds_.pop_back();
+    boundsLeft_.pop_back();
+    boundsTop_.pop_back();
+    boundsRight_.pop_back();
+    boundsBottom_.pop_back();
+}
+
+
+sf::FloatRect SpriteStore::transformRect( unsigned int denseIndex,
+                                          const sf::FloatRect& rect ) const
+{
+    const unsigned int i = denseIndex;
+    const float left = rect.left * scalesX_[i];
+    const float top = rect.top * scalesY_[i];
+    const float right = ( rect.left + rect.width ) * scalesX_[i];
+    const float bottom = ( rect.top + rect.height ) * scalesY_[i];
+
+    if( rotations_[i] == 0.0f ){
+        return sf::FloatRect( positionsX_[i] + std::min( left, right ),
+                              positionsY_[i] + std::min( top, bottom ),
+                              std::fabs( right - left ),
+                              std::fabs( bottom - top ) );
+    }
+
+    const float radians = rotations_[i] * PI / 180.0f;
+    const float cosine = std::cos( radians );
+    const float sine = std::sin( radians );
+    const float corners[4][2] =
+    {
+        { left, top },
+        { right, top },
+        { right, bottom },
+        { left, bottom }
+    };
+
+    float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+    for( unsigned int j = 0; j < 4; j++ ){
+        const float x = cosine * corners[j][0] - sine * corners[j][1];
+        const float y = sine * corners[j][0] + cosine * corners[j][1];
+        if( j == 0 ){
+            minX = maxX = x;
+            minY = maxY = y;
+        }else{
+            minX = std::min( minX, x );
+            maxX = std::max( maxX, x );
+            minY = std::min( minY, y );
+            maxY = std::max( maxY, y );
+        }
+    }
+
+    return sf::FloatRect( positionsX_[i] + minX,
+                          positionsY_[i] + minY,
+                          maxX - minX,
+                          maxY - minY );
+}
+
+
+bool SpriteStore::collideDense( unsigned int a, unsigned int b ) const
+{
+    const Tileset& tilesetA = *( tilesets_[tilesetIds_[a]] );
+    const Tileset& tilesetB = *( tilesets_[tilesetIds_[b]] );
+
+    // Stored sprites use the collision filter of their tilesets.
+    const std::uint32_t categoryA = tilesetA.collisionCategory();
+    const std::uint32_t categoryB = tilesetB.collisionCategory();
+    const std::uint32_t maskA = tilesetA.collisionMask();
+    const std::uint32_t maskB = tilesetB.collisionMask();
+    if( !( categoryA & maskB ) || !( categoryB & maskA ) ){
+        return false;
+    }
+
+    const std::vector< TilesetCollisionRect >& rectsA = tilesetA.tileCollisionRects( tiles_[a] );
+    const std::vector< TilesetCollisionRect >& rectsB = tilesetB.tileCollisionRects( tiles_[b] );
+
+    // Reused between calls (one per thread, so concurrent const calls are
+    // safe). Only rects B's mask accepts are kept.
+    static thread_local RectBatch worldRectsB;
+    worldRectsB.clear();
+    for( const TilesetCollisionRect& rectB : rectsB ){
+        const std::uint32_t layers =
+                ( rectB.layers == ALL_COLLISION_CATEGORIES ) ? categoryB : rectB.layers;
+        if( layers & maskA ){
+            worldRectsB.push_back( transformRect( b, sf::FloatRect( rectB.rect ) ) );
+        }
+    }
+
+    for( const TilesetCollisionRect& rectA : rectsA ){
+        const std::uint32_t layers =
+                ( rectA.layers == ALL_COLLISION_CATEGORIES ) ? categoryA : rectA.layers;
+        if( ( layers & maskB ) &&
+                intersectsAny( transformRect( a, sf::FloatRect( rectA.rect ) ), worldRectsB ) ){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace m2g
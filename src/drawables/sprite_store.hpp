@@ -0,0 +1,201 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef SPRITE_STORE_HPP
+#define SPRITE_STORE_HPP
+
+#include "tileset.hpp"
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace m2g {
+
+// Compact reference to a sprite in a SpriteStore. The generation tells a
+// destroyed sprite apart from a newer one reusing its slot.
+struct SpriteHandle
+{
+    std::uint32_t index;
+    std::uint32_t generation;
+
+    bool operator == ( const SpriteHandle& handle ) const;
+    bool operator != ( const SpriteHandle& handle ) const;
+};
+
+
+// Keeps many tile sprites in parallel arrays (positions, scales, rotations,
+// tiles and tilesets), so passes over all of them (transforming, culling,
+// collision detection, drawing) run linearly over contiguous memory instead
+// of chasing one heap allocated TileSprite per sprite.
+//
+// Sprites have no origin: position, scale and rotation (in degrees) are
+// applied like in sf::Transformable with origin (0, 0).
+class SpriteStore : public sf::Drawable
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        SpriteStore();
+
+
+        /***
+         * 2. Tilesets
+         ***/
+        // Tilesets are referenced, not copied, so they must outlive the
+        // store. Returns the id to create sprites with.
+        unsigned int addTileset( const Tileset& tileset );
+        const Tileset& tileset( unsigned int tilesetId ) const;
+        unsigned int nTilesets() const;
+
+
+        /***
+         * 3. Sprites management
+         ***/
+        SpriteHandle create( unsigned int tilesetId,
+                             unsigned int tile = 0,
+                             const sf::Vector2f& position = sf::Vector2f( 0.0f, 0.0f ) );
+        void destroy( SpriteHandle sprite );
+        bool valid( SpriteHandle sprite ) const;
+        void clear();
+        void reserve( unsigned int nSprites );
+        unsigned int size() const;
+
+
+        /***
+         * 4. Getters
+         ***/
+        sf::Vector2f position( SpriteHandle sprite ) const;
+        sf::Vector2f scale( SpriteHandle sprite ) const;
+        float rotation( SpriteHandle sprite ) const;
+        unsigned int tile( SpriteHandle sprite ) const;
+        unsigned int tilesetId( SpriteHandle sprite ) const;
+        // Axis aligned box around the transformed tile, as computed by the
+        // last call to updateBounds().
+        sf::FloatRect boundaryBox( SpriteHandle sprite ) const;
+
+
+        /***
+         * 5. Setters
+         ***/
+        void setPosition( SpriteHandle sprite, const sf::Vector2f& position );
+        void setScale( SpriteHandle sprite, const sf::Vector2f& scale );
+        void setRotation( SpriteHandle sprite, float angle );
+        void setTile( SpriteHandle sprite, unsigned int tile );
+        void setTileset( SpriteHandle sprite, unsigned int tilesetId, unsigned int tile = 0 );
+
+
+        /***
+         * 6. Bulk access
+         ***/
+        // Sprites are kept packed in indices [0, size()), in no particular
+        // order (destroying a sprite moves the last one to its place). The
+        // arrays below follow that order and can be updated in bulk; call
+        // updateBounds() afterwards.
+        SpriteHandle handle( unsigned int denseIndex ) const;
+        unsigned int denseIndex( SpriteHandle sprite ) const;
+        float* positionsX();
+        float* positionsY();
+        const float* positionsX() const;
+        const float* positionsY() const;
+        // Adds offsetsX[i] and offsetsY[i] to the position of the i-th
+        // sprite.
+        void move( const float* offsetsX, const float* offsetsY );
+
+
+        /***
+         * 7. Bulk passes
+         ***/
+        // Recomputes the boundary box of every sprite. Cheap for sprites
+        // not rotated. Call it once per frame, after moving the sprites and
+        // before culling them or looking for collisions.
+        void updateBounds();
+        // Appends to visibleSprites the sprites whose boundary box
+        // intersects the given area.
+        void cull( const sf::FloatRect& area,
+                   std::vector< SpriteHandle >& visibleSprites ) const;
+        bool collide( SpriteHandle a, SpriteHandle b ) const;
+        // Appends to collisions every other sprite colliding with the given
+        // one.
+        void findCollisions( SpriteHandle sprite,
+                             std::vector< SpriteHandle >& collisions ) const;
+
+
+        /***
+         * 8. Drawing
+         ***/
+        // Draws every sprite, batching those sharing a texture into a single
+        // draw call.
+        virtual void draw( sf::RenderTarget& target, sf::RenderStates states ) const;
+
+
+    private:
+        /***
+         * 9. Auxiliar methods
+         ***/
+        unsigned int checkedDenseIndex( SpriteHandle sprite ) const;
+        void checkTile( unsigned int tilesetId, unsigned int tile ) const;
+        void removeDense( unsigned int denseIndex );
+        // Transforms a rect in tile coordinates of the given sprite into
+        // world coordinates (axis aligned box around it).
+        sf::FloatRect transformRect( unsigned int denseIndex,
+                                     const sf::FloatRect& rect ) const;
+        bool collideDense( unsigned int a, unsigned int b ) const;
+
+
+        /***
+         * Attributes
+         ***/
+        struct Slot
+        {
+            std::uint32_t denseIndex;
+            std::uint32_t generation;
+        };
+
+        std::vector< const Tileset* > tilesets_;
+
+        // Sparse slots addressed by handles, and the free ones.
+        std::vector< Slot > slots_;
+        std::vector< std::uint32_t > freeSlots_;
+
+        // Dense arrays, one element per sprite.
+        std::vector< std::uint32_t > slotIndices_;
+        std::vector< float > positionsX_;
+        std::vector< float > positionsY_;
+        std::vector< float > scalesX_;
+        std::vector< float > scalesY_;
+        std::vector< float > rotations_;
+        std::vector< std::uint32_t > tiles_;
+        std::vector< std::uint32_t > tilesetIds_;
+        std::vector< float > boundsLeft_;
+        std::vector< float > boundsTop_;
+        std::vector< float > boundsRight_;
+        std::vector< float > boundsBottom_;
+
+        // Vertices batched per texture, kept between draws to reuse their
+        // memory.
+        mutable std::map< const sf::Texture*, std::vector< sf::Vertex > > batches_;
+};
+
+} // namespace m2g
+
+#endif // SPRITE_STORE_HPP
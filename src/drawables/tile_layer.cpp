@@ -0,0 +1,363 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "tile_layer.hpp"
+#include "../utilities/trace.hpp"
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace m2g {
+
+/***
+ * 1. Construction
+ ***/
+
+TileLayer::TileLayer( const Tileset& tileset, unsigned int nColumns, unsigned int nRows ) :
+    tileset_( &tileset ),
+    nColumns_( nColumns ),
+    nRows_( nRows ),
+    tiles_( nColumns * nRows, NO_TILE ),
+    position_( 0.0f, 0.0f ),
+    tilesetRevision_( 0 ),
+    verticesValid_( false )
+{}
+
+
+/***
+ * 2. Getters
+ ***/
+
+const Tileset& TileLayer::tileset() const
+{
+    return *tileset_;
+}
+
+
+unsigned int TileLayer::nColumns() const
+{
+    return nColumns_;
+}
+
+
+unsigned int TileLayer::nRows() const
+{
+    return nRows_;
+}
+
+
+unsigned int TileLayer::tile( unsigned int column, unsigned int row ) const
+{
+    return tiles_[cellIndex( column, row )];
+}
+
+
+const sf::Vector2f& TileLayer::position() const
+{
+    return position_;
+}
+
+
+sf::FloatRect TileLayer::bounds() const
+{
+    const sf::Vector2u tileDimensions = tileset_->tileDimensions();
+    return sf::FloatRect( position_.x,
+                          position_.y,
+                          static_cast< float >( nColumns_ * tileDimensions.x ),
+                          static_cast< float >( nRows_ * tileDimensions.y ) );
+}
+
+
+/***
+ * 3. Setters
+ ***/
+
+void TileLayer::setTile( unsigned int column, unsigned int row, unsigned int tile )
+{
+    const unsigned int cell = cellIndex( column, row );
+    if( tile != NO_TILE && tile >= tileset_->nTiles() ){
+        throw std::out_of_range( "Tile out of range" );
+    }
+    tiles_[cell] = tile;
+    verticesValid_ = false;
+}
+
+
+void TileLayer::setPosition( const sf::Vector2f& position )
+{
+    position_ = position;
+    verticesValid_ = false;
+}
+
+
+/***
+ * 4. Collision detection
+ ***/
+
+bool TileLayer::collide( const sf::FloatRect& rect, std::uint32_t mask ) const
+{
+    M2G_TRACE_SCOPE( "TileLayer::collide" );
+    sf::Vector2u firstCell, lastCell;
+    if( !cellRange( rect, firstCell, lastCell ) ){
+        return false;
+    }
+
+    for( unsigned int row = firstCell.y; row <= lastCell.y; row++ ){
+        for( unsigned int column = firstCell.x; column <= lastCell.x; column++ ){
+            for( const TilesetCollisionRect& tileRect : cellCollisionRects( column, row ) ){
+                if( ( collisionRectCategory( tileRect ) & mask ) &&
+                        worldRect( column, row, tileRect.rect ).intersects( rect ) ){
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+
+void TileLayer::findCollisions( const sf::FloatRect& rect,
+                                std::vector< sf::Vector2u >& cells,
+                                std::uint32_t mask ) const
+{
+    M2G_TRACE_SCOPE( "TileLayer::findCollisions" );
+    sf::Vector2u firstCell, lastCell;
+    if( !cellRange( rect, firstCell, lastCell ) ){
+        return;
+    }
+
+    for( unsigned int row = firstCell.y; row <= lastCell.y; row++ ){
+        for( unsigned int column = firstCell.x; column <= lastCell.x; column++ ){
+            for( const TilesetCollisionRect& tileRect : cellCollisionRects( column, row ) ){
+                if( ( collisionRectCategory( tileRect ) & mask ) &&
+                        worldRect( column, row, tileRect.rect ).intersects( rect ) ){
+                    cells.push_back( sf::Vector2u( column, row ) );
+                    break;
+                }
+            }
+        }
+    }
+}
+
+
+bool TileLayer::collide( const TileSprite& sprite ) const
+{
+    if( !( sprite.collisionCategory() & tileset_->collisionMask() ) ){
+        return false;
+    }
+
+    for( const sf::FloatRect& rect : sprite.collisionRects() ){
+        if( collide( rect, sprite.collisionMask() ) ){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool TileLayer::sweep( const sf::FloatRect& rect,
+                       const sf::Vector2f& displacement,
+                       sf::Vector2u& cell,
+                       SweepHit& hit,
+                       std::uint32_t mask ) const
+{
+    M2G_TRACE_SCOPE( "TileLayer::sweep" );
+    const sf::FloatRect area( std::min( rect.left, rect.left + displacement.x ),
+                              std::min( rect.top, rect.top + displacement.y ),
+                              rect.width + std::fabs( displacement.x ),
+                              rect.height + std::fabs( displacement.y ) );
+    sf::Vector2u firstCell, lastCell;
+    if( !cellRange( area, firstCell, lastCell ) ){
+        return false;
+    }
+
+    bool found = false;
+    for( unsigned int row = firstCell.y; row <= lastCell.y; row++ ){
+        for( unsigned int column = firstCell.x; column <= lastCell.x; column++ ){
+            for( const TilesetCollisionRect& tileRect : cellCollisionRects( column, row ) ){
+                SweepHit rectHit;
+                if( ( collisionRectCategory( tileRect ) & mask ) &&
+                        sweepRect( rect, displacement,
+                                   worldRect( column, row, tileRect.rect ), rectHit ) &&
+                        ( !found || rectHit.time < hit.time ) ){
+                    cell = sf::Vector2u( column, row );
+                    hit = rectHit;
+                    found = true;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
+
+/***
+ * 5. Drawing
+ ***/
+
+void TileLayer::draw( sf::RenderTarget& target, sf::RenderStates states ) const
+{
+    M2G_TRACE_SCOPE( "TileLayer::draw" );
+    syncWithTileset();
+    if( !verticesValid_ ){
+        updateVertices();
+    }
+
+    for( const auto& batch : batches_ ){
+        if( batch.second.size() ){
+            states.texture = batch.first;
+            target.draw( batch.second.data(), batch.second.size(), sf::Quads, states );
+        }
+    }
+}
+
+
+/***
+ * 6. Auxiliar methods
+ ***/
+
+unsigned int TileLayer::cellIndex( unsigned int column, unsigned int row ) const
+{
+    if( column >= nColumns_ || row >= nRows_ ){
+        throw std::out_of_range( "Cell out of range" );
+    }
+    return row * nColumns_ + column;
+}
+
+
+void TileLayer::syncWithTileset() const
+{
+    if( tilesetRevision_ == tileset_->revision() ){
+        return;
+    }
+
+    tilesetRevision_ = tileset_->revision();
+    verticesValid_ = false;
+}
+
+
+bool TileLayer::cellRange( const sf::FloatRect& area,
+                           sf::Vector2u& firstCell,
+                           sf::Vector2u& lastCell ) const
+{
+    const sf::Vector2u tileDimensions = tileset_->tileDimensions();
+    const float left = std::floor( ( area.left - position_.x ) / tileDimensions.x );
+    const float top = std::floor( ( area.top - position_.y ) / tileDimensions.y );
+    const float right =
+            std::floor( ( area.left + area.width - position_.x ) / tileDimensions.x );
+    const float bottom =
+            std::floor( ( area.top + area.height - position_.y ) / tileDimensions.y );
+
+    // NaN coordinates fail these comparisons too.
+    if( !( left <= right ) || !( top <= bottom ) ){
+        return false;
+    }
+
+    // Compared and clamped as floats, so areas far from the layer (or
+    // infinite) are never cast out of range.
+    if( right < 0.0f || bottom < 0.0f || left >= nColumns_ || top >= nRows_ ){
+        return false;
+    }
+
+    // The float limits may round up for huge layers, hence the second
+    // clamp after casting.
+    firstCell.x = static_cast< unsigned int >( std::max( left, 0.0f ) );
+    firstCell.y = static_cast< unsigned int >( std::max( top, 0.0f ) );
+    lastCell.x = std::min( static_cast< unsigned int >(
+                               std::min( right, static_cast< float >( nColumns_ - 1 ) ) ),
+                           nColumns_ - 1 );
+    lastCell.y = std::min( static_cast< unsigned int >(
+                               std::min( bottom, static_cast< float >( nRows_ - 1 ) ) ),
+                           nRows_ - 1 );
+    return true;
+}
+
+
+const std::vector< TilesetCollisionRect >& TileLayer::cellCollisionRects( unsigned int column,
+                                                                          unsigned int row ) const
+{
+    return tileset_->tileCollisionRects( tiles_[row * nColumns_ + column] );
+}
+
+
+sf::FloatRect TileLayer::worldRect( unsigned int column,
+                                    unsigned int row,
+                                    const sf::IntRect& rect ) const
+{
+    const sf::Vector2u tileDimensions = tileset_->tileDimensions();
+    return sf::FloatRect( position_.x + column * tileDimensions.x + rect.left,
+                          position_.y + row * tileDimensions.y + rect.top,
+                          rect.width,
+                          rect.height );
+}
+
+
+std::uint32_t TileLayer::collisionRectCategory( const TilesetCollisionRect& rect ) const
+{
+    return ( rect.layers == ALL_COLLISION_CATEGORIES ) ?
+                tileset_->collisionCategory() : rect.layers;
+}
+
+
+void TileLayer::updateVertices() const
+{
+    for( auto& batch : batches_ ){
+        batch.second.clear();
+    }
+
+    const sf::Vector2u tileDimensions = tileset_->tileDimensions();
+    const unsigned int nTiles = tileset_->nTiles();
+    for( unsigned int row = 0; row < nRows_; row++ ){
+        for( unsigned int column = 0; column < nColumns_; column++ ){
+            const std::uint32_t tile = tiles_[row * nColumns_ + column];
+            if( tile >= nTiles ){
+                continue;
+            }
+
+            const sf::IntRect tileRect = tileset_->tileRect( tile );
+            std::vector< sf::Vertex >& vertices =
+                    batches_[&( tileset_->texture( tileset_->tilePage( tile ) ) )];
+            const float x = position_.x + column * tileDimensions.x;
+            const float y = position_.y + row * tileDimensions.y;
+            const float width = tileRect.width;
+            const float height = tileRect.height;
+            const float corners[4][2] =
+            {
+                { 0.0f, 0.0f },
+                { width, 0.0f },
+                { width, height },
+                { 0.0f, height }
+            };
+
+            for( unsigned int i = 0; i < 4; i++ ){
+                vertices.push_back(
+                            sf::Vertex( sf::Vector2f( x + corners[i][0], y + corners[i][1] ),
+                                        sf::Vector2f( tileRect.left + corners[i][0],
+                                                      tileRect.top + corners[i][1] ) ) );
+            }
+        }
+    }
+
+    verticesValid_ = true;
+}
+
+} // namespace m2g
@@ -0,0 +1,145 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef TILE_LAYER_HPP
+#define TILE_LAYER_HPP
+
+#include "tile_sprite.hpp"
+#include "../utilities/swept_rect.hpp"
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace m2g {
+
+// Tile index of the empty cells of a TileLayer.
+const std::uint32_t NO_TILE = 0xFFFFFFFF;
+
+// Static grid of tiles from a single tileset (level geometry), placed at a
+// given position with no rotation or scale. Collision queries only visit
+// the cells overlapped by the queried area, so they cost the same whatever
+// the size of the layer. Cells collide with the collision rects of their
+// tiles in the tileset, which are expected to lie inside the tile.
+class TileLayer : public sf::Drawable
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        // The tileset is referenced, not copied, so it must outlive the
+        // layer. Every cell starts empty.
+        TileLayer( const Tileset& tileset, unsigned int nColumns, unsigned int nRows );
+
+
+        /***
+         * 2. Getters
+         ***/
+        const Tileset& tileset() const;
+        unsigned int nColumns() const;
+        unsigned int nRows() const;
+        unsigned int tile( unsigned int column, unsigned int row ) const;
+        const sf::Vector2f& position() const;
+        sf::FloatRect bounds() const;
+
+
+        /***
+         * 3. Setters
+         ***/
+        // tile is a tile of the tileset or NO_TILE.
+        void setTile( unsigned int column, unsigned int row, unsigned int tile );
+        void setPosition( const sf::Vector2f& position );
+
+
+        /***
+         * 4. Collision detection
+         ***/
+        // Queries only consider the tile rects whose collision categories
+        // are in the given mask.
+        bool collide( const sf::FloatRect& rect,
+                      std::uint32_t mask = ALL_COLLISION_CATEGORIES ) const;
+        // Appends the cells (column, row) with a tile rect intersecting the
+        // given one, once and by rows.
+        void findCollisions( const sf::FloatRect& rect,
+                             std::vector< sf::Vector2u >& cells,
+                             std::uint32_t mask = ALL_COLLISION_CATEGORIES ) const;
+        // Tests the collision rects of the sprite with the collision filter
+        // of the tileset.
+        bool collide( const TileSprite& sprite ) const;
+        // Finds the first cell hit by rect while moving by displacement
+        // (see sweepRect()).
+        bool sweep( const sf::FloatRect& rect,
+                    const sf::Vector2f& displacement,
+                    sf::Vector2u& cell,
+                    SweepHit& hit,
+                    std::uint32_t mask = ALL_COLLISION_CATEGORIES ) const;
+
+
+        /***
+         * 5. Drawing
+         ***/
+        // Draws every tile, in a single draw call per texture page.
+        virtual void draw( sf::RenderTarget& target, sf::RenderStates states ) const;
+
+
+    private:
+        /***
+         * 6. Auxiliar methods
+         ***/
+        unsigned int cellIndex( unsigned int column, unsigned int row ) const;
+        // Invalidates the vertices after the tileset changes.
+        void syncWithTileset() const;
+        // Cells overlapped by the given area. Returns false if there are
+        // none.
+        bool cellRange( const sf::FloatRect& area,
+                        sf::Vector2u& firstCell,
+                        sf::Vector2u& lastCell ) const;
+        // Collision rects of the tile in the given cell (none for empty
+        // cells and tiles no longer in the tileset).
+        const std::vector< TilesetCollisionRect >& cellCollisionRects( unsigned int column,
+                                                                       unsigned int row ) const;
+        // Collision rect of the tile in the given cell, in world
+        // coordinates.
+        sf::FloatRect worldRect( unsigned int column,
+                                 unsigned int row,
+                                 const sf::IntRect& rect ) const;
+        std::uint32_t collisionRectCategory( const TilesetCollisionRect& rect ) const;
+        void updateVertices() const;
+
+
+        /***
+         * Attributes
+         ***/
+        const Tileset* tileset_;
+        unsigned int nColumns_;
+        unsigned int nRows_;
+        std::vector< std::uint32_t > tiles_;
+        sf::Vector2f position_;
+
+        mutable unsigned int tilesetRevision_;
+
+        // Vertices of every tile, per texture page, rebuilt after any change.
+        mutable std::map< const sf::Texture*, std::vector< sf::Vertex > > batches_;
+        mutable bool verticesValid_;
+};
+
+} // namespace m2g
+
+#endif // TILE_LAYER_HPP
@@ -18,21 +18,58 @@
 ***/
 
 #include "tile_sprite.hpp"
+#include "../utilities/trace.hpp"
+#include "../utilities/stats.hpp"
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <atomic>
+#include <cmath>
 
 namespace m2g {
 
+namespace {
+
+unsigned int nextCollisionRectsRevision()
+{
+    static std::atomic< unsigned int > lastRevision( 0 );
+    return ++lastRevision;
+}
+
+} // namespace
+
+
 /***
  * 1. Construction
  ***/
 
-TileSprite::TileSprite( const m2g::Tileset &tileset )
+TileSprite::TileSprite( const m2g::Tileset &tileset ) :
+    tileTransform_( TILE_TRANSFORM_NONE ),
+    hasCollisionFilter_( false ),
+    collisionCategory_( DEFAULT_COLLISION_CATEGORY ),
+    collisionMask_( ALL_COLLISION_CATEGORIES ),
+    orientedCollision_( false ),
+    hasLayeredCollisionRects_( false ),
+    collisionRectsRevision_( nextCollisionRectsRevision() ),
+    collisionRectsKey_(),
+    collisionRectsValid_( false ),
+    boundaryBoxKey_(),
+    boundaryBoxValid_( false )
 {
     setTileset( tileset );
 }
 
 
-TileSprite::TileSprite( TilesetPtr tileset )
+TileSprite::TileSprite( TilesetPtr tileset ) :
+    tileTransform_( TILE_TRANSFORM_NONE ),
+    hasCollisionFilter_( false ),
+    collisionCategory_( DEFAULT_COLLISION_CATEGORY ),
+    collisionMask_( ALL_COLLISION_CATEGORIES ),
+    orientedCollision_( false ),
+    hasLayeredCollisionRects_( false ),
+    collisionRectsRevision_( nextCollisionRectsRevision() ),
+    collisionRectsKey_(),
+    collisionRectsValid_( false ),
+    boundaryBoxKey_(),
+    boundaryBoxValid_( false )
 {
     setTileset( std::move( tileset ) );
 }
@@ -54,29 +91,108 @@ unsigned int TileSprite::currentTile() const
 }
 
 
-std::list<sf::FloatRect> TileSprite::collisionRects() const
+TileTransform TileSprite::tileTransform() const
 {
-    const std::list< sf::IntRect > tileCollisionRects =
-            tileset_->collisionRects( currentTile_ );
-    std::list< sf::FloatRect > collisionRects;
+    return tileTransform_;
+}
 
-    for( const sf::IntRect& tileColRect : tileCollisionRects ){
-        sf::FloatRect floatRect;
-        floatRect.left = tileColRect.left;
-        floatRect.top = tileColRect.top;
-        floatRect.height = tileColRect.height;
-        floatRect.width = tileColRect.width;
 
-        collisionRects.push_back( getTransform().transformRect( floatRect ) );
+const std::list<sf::FloatRect>& TileSprite::collisionRects() const
+{
+    syncWithTileset();
+    if( updateTransformKey( collisionRectsKey_ ) ){
+        collisionRectsValid_ = false;
+    }
+    if( collisionRectsValid_ ){
+        return collisionRects_;
     }
 
-    return collisionRects;
+    const std::vector< TilesetCollisionRect >& tileCollisionRects =
+            tileset_->tileCollisionRects( currentTile_ );
+    const sf::Transform& transform = getTransform();
+    collisionRects_.clear();
+    collisionRectBatch_.clear();
+    collisionRectLayers_.clear();
+    hasLayeredCollisionRects_ = false;
+    orientedCollisionRects_.clear();
+
+    // Bounds of rects rotated by multiples of 90 degrees are exact.
+    const bool oriented = orientedCollision_ &&
+            std::fmod( getRotation(), 90.0f ) != 0.0f;
+
+    for( const TilesetCollisionRect& tileColRectData : tileCollisionRects ){
+        const sf::FloatRect floatRect = tileCollisionRect( tileColRectData.rect );
+        collisionRects_.push_back( transform.transformRect( floatRect ) );
+        if( oriented ){
+            orientedCollisionRects_.push_back( transformOrientedRect( transform, floatRect ) );
+        }
+        collisionRectBatch_.push_back( collisionRects_.back() );
+        collisionRectLayers_.push_back( tileColRectData.layers );
+        if( tileColRectData.layers != ALL_COLLISION_CATEGORIES ){
+            hasLayeredCollisionRects_ = true;
+        }
+    }
+
+    collisionRectsValid_ = true;
+    collisionRectsRevision_ = nextCollisionRectsRevision();
+    return collisionRects_;
+}
+
+
+std::list< sf::FloatRect > TileSprite::collisionRects( const sf::Transform& transform ) const
+{
+    syncWithTileset();
+    std::list< sf::FloatRect > rects;
+    for( const sf::IntRect& rect : tileset_->collisionRects( currentTile_ ) ){
+        rects.push_back( transform.transformRect( tileCollisionRect( rect ) ) );
+    }
+    return rects;
 }
 
 
 sf::FloatRect TileSprite::getBoundaryBox() const
 {
-    return getTransform().transformRect( sprite_.getGlobalBounds() );
+    syncWithTileset();
+    if( updateTransformKey( boundaryBoxKey_ ) ){
+        boundaryBoxValid_ = false;
+    }
+    if( boundaryBoxValid_ ){
+        return boundaryBox_;
+    }
+
+    const sf::Vector2f dimensions =
+            transformedTileDimensions( sf::Vector2u( tileRect_.width, tileRect_.height ),
+                                       tileTransform_ );
+
+    boundaryBox_ = getTransform().transformRect(
+                sf::FloatRect( 0.0f, 0.0f, dimensions.x, dimensions.y ) );
+    boundaryBoxValid_ = true;
+    return boundaryBox_;
+}
+
+
+std::uint32_t TileSprite::collisionCategory() const
+{
+    return hasCollisionFilter_ ? collisionCategory_ : tileset_->collisionCategory();
+}
+
+
+std::uint32_t TileSprite::collisionMask() const
+{
+    return hasCollisionFilter_ ? collisionMask_ : tileset_->collisionMask();
+}
+
+
+bool TileSprite::orientedCollision() const
+{
+    return orientedCollision_;
+}
+
+
+unsigned int TileSprite::collisionRectsRevision() const
+{
+    collisionRects();
+    return collisionRectsRevision_;
 }
 
 
@@ -86,15 +202,29 @@ sf::FloatRect TileSprite::getBoundaryBox() const
 
 void TileSprite::setTile( unsigned int tile )
 {
+    const sf::IntRect tileRect = tileset_->tileRect( tile );
+
+    // Tiles of big tilesets may be in different texture pages.
+    const unsigned int page = tileset_->tilePage( tile );
+    if( page != currentPage_ || tilesetRevision_ != tileset_->revision() ){
+        texture_ = &( tileset_->texture( page ) );
+        currentPage_ = page;
+    }
+
+    tilesetRevision_ = tileset_->revision();
     currentTile_ = tile;
-    sprite_.setTextureRect( tileset_->tileRect( currentTile_ ) );
+    tileRect_ = tileRect;
+    updateVertices();
+    invalidateCaches();
 }
 
 
 void TileSprite::setTileset( const Tileset &tileset )
 {
     tileset_ = &tileset;
-    sprite_.setTexture( tileset.texture() );
+    texture_ = &( tileset.texture() );
+    tilesetRevision_ = tileset.revision();
+    currentPage_ = 0;
     TileSprite::setTile( 0 );
 }
 
@@ -106,26 +236,117 @@ void TileSprite::setTileset( TilesetPtr tileset )
 }
 
 
+void TileSprite::setTileTransform( TileTransform transform )
+{
+    if( transform > TILE_TRANSFORM_ALL ){
+        throw std::invalid_argument( "Invalid tile transform" );
+    }
+    tileTransform_ = transform;
+    updateVertices();
+    invalidateCaches();
+}
+
+
+void TileSprite::setCollisionFilter( std::uint32_t category, std::uint32_t mask )
+{
+    hasCollisionFilter_ = true;
+    collisionCategory_ = category;
+    collisionMask_ = mask;
+
+    // Collision results cached by revision aren't valid anymore.
+    invalidateCaches();
+}
+
+
+void TileSprite::useTilesetCollisionFilter()
+{
+    hasCollisionFilter_ = false;
+    invalidateCaches();
+}
+
+
+void TileSprite::setOrientedCollision( bool oriented )
+{
+    orientedCollision_ = oriented;
+    invalidateCaches();
+}
+
+
 /***
  * 4. Collision detection
  ***/
 
+bool TileSprite::interacts( const TileSprite& sprite ) const
+{
+    return ( collisionCategory() & sprite.collisionMask() ) &&
+            ( sprite.collisionCategory() & collisionMask() );
+}
+
+
 bool TileSprite::collide( const TileSprite &sprite ) const
 {
-    std::list< sf::FloatRect > rectsA, rectsB;
+    M2G_TRACE_SCOPE( "TileSprite::collide" );
+    Stats::increment( STAT_SPRITE_COLLIDES );
+    return collideUncounted( sprite );
+}
 
-    rectsA = collisionRects();
-    rectsB = sprite.collisionRects();
 
-    for( sf::FloatRect& rectA : rectsA ){
-        for( sf::FloatRect& rectB : rectsB ){
-            if( rectA.intersects( rectB ) ){
-                return true;
+bool TileSprite::sweep( const sf::Transform& previousTransform,
+                        const TileSprite& sprite,
+                        SweepHit& hit ) const
+{
+    return sweep( collisionRects( previousTransform ), sprite, hit );
+}
+
+
+bool TileSprite::sweep( const std::list< sf::FloatRect >& previousRects,
+                        const TileSprite& sprite,
+                        SweepHit& hit ) const
+{
+    M2G_TRACE_SCOPE( "TileSprite::sweep" );
+    const RectBatch& rectsA = collisionRectBatch();
+    if( previousRects.size() != rectsA.size() ){
+        throw std::invalid_argument( "Previous rects don't match the collision rects" );
+    }
+    if( !interacts( sprite ) ){
+        return false;
+    }
+
+    const RectBatch& rectsB = sprite.collisionRectBatch();
+    const std::uint32_t maskA = collisionMask();
+    const std::uint32_t maskB = sprite.collisionMask();
+
+    bool found = false;
+    unsigned int i = 0;
+    for( const sf::FloatRect& previousRect : previousRects ){
+        const sf::FloatRect rectA = rectsA.rect( i );
+        if( !( collisionRectCategory( i++ ) & maskB ) ){
+            continue;
+        }
+
+        // The current rect, moved back to the previous position.
+        const sf::Vector2f displacement(
+                    ( rectA.left + rectA.width * 0.5f ) -
+                    ( previousRect.left + previousRect.width * 0.5f ),
+                    ( rectA.top + rectA.height * 0.5f ) -
+                    ( previousRect.top + previousRect.height * 0.5f ) );
+        const sf::FloatRect startRect( rectA.left - displacement.x,
+                                       rectA.top - displacement.y,
+                                       rectA.width,
+                                       rectA.height );
+
+        for( unsigned int j = 0; j < rectsB.size(); j++ ){
+            SweepHit rectHit;
+            if( ( sprite.collisionRectCategory( j ) & maskA ) &&
+                    sweepRect( startRect, displacement, rectsB.rect( j ), rectHit ) &&
+                    ( !found || rectHit.time < hit.time ) ){
+                hit = rectHit;
+                found = true;
             }
         }
     }
 
-    return false;
+    return found;
 }
 
 
@@ -135,8 +356,186 @@ bool TileSprite::collide( const TileSprite &sprite ) const
 
 void TileSprite::draw( sf::RenderTarget &target, sf::RenderStates states ) const
 {
+    M2G_TRACE_SCOPE( "TileSprite::draw" );
+    Stats::increment( STAT_SPRITE_DRAWS );
+    syncWithTileset();
     states.transform = getTransform();
-    target.draw( sprite_, states );
+    states.texture = texture_;
+    target.draw( vertices_, 4, sf::Quads, states );
+}
+
+
+/***
+ * 6. Auxiliar methods
+ ***/
+
+void TileSprite::syncWithTileset() const
+{
+    if( tilesetRevision_ == tileset_->revision() ){
+        return;
+    }
+
+    // The tileset was reloaded: the texture and tile rects may have
+    // changed and the current tile may not exist anymore.
+    if( currentTile_ >= tileset_->nTiles() ){
+        currentTile_ = 0;
+    }
+    currentPage_ = tileset_->tilePage( currentTile_ );
+    texture_ = &( tileset_->texture( currentPage_ ) );
+    tileRect_ = tileset_->tileRect( currentTile_ );
+    tilesetRevision_ = tileset_->revision();
+    updateVertices();
+    invalidateCaches();
+}
+
+
+void TileSprite::updateVertices() const
+{
+    const sf::Vector2f dimensions =
+            transformedTileDimensions( sf::Vector2u( tileRect_.width, tileRect_.height ),
+                                       tileTransform_ );
+    sf::Vector2f texCoords[4];
+    transformTileTexCoords( tileRect_, tileTransform_, texCoords );
+
+    vertices_[0].position = sf::Vector2f( 0.0f, 0.0f );
+    vertices_[1].position = sf::Vector2f( dimensions.x, 0.0f );
+    vertices_[2].position = sf::Vector2f( dimensions.x, dimensions.y );
+    vertices_[3].position = sf::Vector2f( 0.0f, dimensions.y );
+
+    for( unsigned int i = 0; i < 4; i++ ){
+        vertices_[i].texCoords = texCoords[i];
+    }
+}
+
+
+
+void TileSprite::invalidateCaches() const
+{
+    collisionRectsValid_ = false;
+    boundaryBoxValid_ = false;
+}
+
+
+sf::FloatRect TileSprite::tileCollisionRect( const sf::IntRect& rect ) const
+{
+    // Collision rects follow the tile when flipped or rotated.
+    return transformTileRect( sf::FloatRect( rect ),
+                              tileset_->tileDimensions(),
+                              tileTransform_ );
+}
+
+
+const RectBatch& TileSprite::collisionRectBatch() const
+{
+    collisionRects();
+    return collisionRectBatch_;
+}
+
+
+std::uint32_t TileSprite::collisionRectCategory( unsigned int i ) const
+{
+    return ( collisionRectLayers_[i] == ALL_COLLISION_CATEGORIES ) ?
+                collisionCategory() : collisionRectLayers_[i];
+}
+
+
+bool TileSprite::collideUncounted( const TileSprite& sprite ) const
+{
+    // Filtered out before touching any rect.
+    if( !interacts( sprite ) ){
+        return false;
+    }
+
+    const RectBatch& rectsA = collisionRectBatch();
+    const RectBatch& rectsB = sprite.collisionRectBatch();
+    if( orientedCollisionRects_.size() || sprite.orientedCollisionRects_.size() ){
+        // Most pairs are discarded by their bounds, as fast as unrotated
+        // ones.
+        return intersectsAny( rectsA, rectsB ) && collideOrientedRects( sprite );
+    }
+    if( hasLayeredCollisionRects_ || sprite.hasLayeredCollisionRects_ ){
+        return collideLayeredRects( sprite );
+    }
+    return intersectsAny( rectsA, rectsB );
+}
+
+
+bool TileSprite::collideLayeredRects( const TileSprite& sprite ) const
+{
+    const std::uint32_t maskA = collisionMask();
+    const std::uint32_t maskB = sprite.collisionMask();
+
+    // The batch kernel discards the rects of A which don't touch any rect
+    // of B, so layers are only checked for the overlapping ones.
+    for( unsigned int i = 0; i < collisionRectBatch_.size(); i++ ){
+        const sf::FloatRect rectA = collisionRectBatch_.rect( i );
+        if( !( collisionRectCategory( i ) & maskB ) ||
+                !intersectsAny( rectA, sprite.collisionRectBatch_ ) ){
+            continue;
+        }
+        for( unsigned int j = 0; j < sprite.collisionRectBatch_.size(); j++ ){
+            if( ( sprite.collisionRectCategory( j ) & maskA ) &&
+                    rectA.intersects( sprite.collisionRectBatch_.rect( j ) ) ){
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+bool TileSprite::collideOrientedRects( const TileSprite& sprite ) const
+{
+    const std::uint32_t maskA = collisionMask();
+    const std::uint32_t maskB = sprite.collisionMask();
+
+    // As in collideLayeredRects(), the batch kernel discards the rects of A
+    // whose bounds don't touch any rect of B before the SAT tests.
+    for( unsigned int i = 0; i < collisionRectBatch_.size(); i++ ){
+        const sf::FloatRect boundsA = collisionRectBatch_.rect( i );
+        if( !( collisionRectCategory( i ) & maskB ) ||
+                !intersectsAny( boundsA, sprite.collisionRectBatch_ ) ){
+            continue;
+        }
+        const OrientedRect rectA = orientedCollisionRect( i );
+        for( unsigned int j = 0; j < sprite.collisionRectBatch_.size(); j++ ){
+            if( ( sprite.collisionRectCategory( j ) & maskA ) &&
+                    boundsA.intersects( sprite.collisionRectBatch_.rect( j ) ) &&
+                    intersects( rectA, sprite.orientedCollisionRect( j ) ) ){
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+
+OrientedRect TileSprite::orientedCollisionRect( unsigned int i ) const
+{
+    return orientedCollisionRects_.size() ?
+                orientedCollisionRects_[i] : orientedRect( collisionRectBatch_.rect( i ) );
+}
+
+
+bool TileSprite::updateTransformKey( TransformKey& key ) const
+{
+    const sf::Vector2f& position = getPosition();
+    const sf::Vector2f& scale = getScale();
+    const sf::Vector2f& origin = getOrigin();
+    const float rotation = getRotation();
+
+    if( key.position == position && key.scale == scale &&
+            key.origin == origin && key.rotation == rotation ){
+        return false;
+    }
+
+    key.position = position;
+    key.scale = scale;
+    key.origin = origin;
+    key.rotation = rotation;
+    return true;
 }
 
 } // namespace m2g
@@ -21,7 +21,13 @@
 #define TILE_SPRITE
 
 #include "tileset.hpp"
-#include <SFML/Graphics/Sprite.hpp>
+#include "tile_transform.hpp"
+#include "../utilities/oriented_rect.hpp"
+#include "../utilities/rect_batch.hpp"
+#include "../utilities/swept_rect.hpp"
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Transformable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
 
 namespace m2g {
 
@@ -40,8 +46,23 @@ class TileSprite : public sf::Drawable, public sf::Transformable
          ***/
         const Tileset& tileset() const;
         unsigned int currentTile() const;
-        std::list< sf::FloatRect > collisionRects() const;
+        TileTransform tileTransform() const;
+        // World collision rects and boundary box are cached until the tile,
+        // the tileset (or its contents), the tile transform or the sprite
+        // transform change. The returned list is valid until then.
+        const std::list< sf::FloatRect >& collisionRects() const;
+        // Collision rects the sprite would have with the given transform
+        // (not cached), in the same order as collisionRects().
+        std::list< sf::FloatRect > collisionRects( const sf::Transform& transform ) const;
         sf::FloatRect getBoundaryBox() const;
+        // Collision filter set with setCollisionFilter(), or the tileset one.
+        std::uint32_t collisionCategory() const;
+        std::uint32_t collisionMask() const;
+        bool orientedCollision() const;
+        // Changes every time the world collision rects change, so callers
+        // can skip collision tests between sprites which didn't change.
+        // Never 0.
+        unsigned int collisionRectsRevision() const;
 
 
         /***
@@ -50,12 +71,35 @@ class TileSprite : public sf::Drawable, public sf::Transformable
         virtual void setTile( unsigned int tile );
         void setTileset( const Tileset& tileset );
         void setTileset( TilesetPtr tileset );
+        void setTileTransform( TileTransform transform );
+        void setCollisionFilter( std::uint32_t category, std::uint32_t mask );
+        void useTilesetCollisionFilter();
+        // collisionRects() are the axis aligned bounds of the transformed
+        // rects, so rotated sprites collide with more than they cover. With
+        // oriented collision on, rotated sprites are tested with their
+        // rotated rects instead, at the cost of a slower collide().
+        void setOrientedCollision( bool oriented );
 
 
         /***
          * 4. Collision detection
          ***/
+        // True if the collision filters of both sprites let them collide.
+        bool interacts( const TileSprite& sprite ) const;
         bool collide( const TileSprite& sprite ) const;
+        // Continuous version of collide(), for sprites moving fast enough to
+        // go through others between frames: finds the first contact of this
+        // sprite, moving from previousTransform to its current transform,
+        // with the given (still) sprite. Only translations are swept: every
+        // rect moves with its current size from where its center was.
+        bool sweep( const sf::Transform& previousTransform,
+                    const TileSprite& sprite,
+                    SweepHit& hit ) const;
+        // Same, with the rects returned by collisionRects( previousTransform ),
+        // for sweeping against several sprites.
+        bool sweep( const std::list< sf::FloatRect >& previousRects,
+                    const TileSprite& sprite,
+                    SweepHit& hit ) const;
 
 
         /***
@@ -65,10 +109,80 @@ class TileSprite : public sf::Drawable, public sf::Transformable
 
 
     private:
-        sf::Sprite sprite_;
+        // Tests sprites through collideUncounted(), accounting them once
+        // per call.
+        friend class CollisionWorld;
+
+        // Parameters of sf::Transformable the cached rects were computed
+        // with. Its setters aren't virtual, so changes are detected by
+        // comparing them.
+        struct TransformKey
+        {
+            sf::Vector2f position;
+            sf::Vector2f scale;
+            sf::Vector2f origin;
+            float rotation;
+        };
+
+
+        /***
+         * 6. Auxiliar methods
+         ***/
+        // Refreshes the tile after its tileset is reloaded.
+        void syncWithTileset() const;
+        void updateVertices() const;
+        void invalidateCaches() const;
+        // Collision rect of the current tile, with the tile transform
+        // applied (but not the sprite one).
+        sf::FloatRect tileCollisionRect( const sf::IntRect& rect ) const;
+        // Same rects as collisionRects(), packed for the intersection
+        // kernels.
+        const RectBatch& collisionRectBatch() const;
+        // Collision categories of the i-th collision rect.
+        std::uint32_t collisionRectCategory( unsigned int i ) const;
+        // collide() without updating STAT_SPRITE_COLLIDES.
+        bool collideUncounted( const TileSprite& sprite ) const;
+        bool collideLayeredRects( const TileSprite& sprite ) const;
+        // Tests the rotated rects of the pairs whose bounds intersect.
+        bool collideOrientedRects( const TileSprite& sprite ) const;
+        OrientedRect orientedCollisionRect( unsigned int i ) const;
+        // Returns true if the sprite transform changed since the given key
+        // was taken, updating the key.
+        bool updateTransformKey( TransformKey& key ) const;
+
+
+        /***
+         * Attributes
+         ***/
+        // Mutable ones are refreshed lazily, even from const methods, when
+        // the tileset is reloaded.
+        mutable sf::Vertex vertices_[4];
+        mutable const sf::Texture* texture_;
         TilesetPtr ownTileset_;
         const Tileset* tileset_;
-        unsigned int currentTile_;
+        mutable unsigned int tilesetRevision_;
+        mutable unsigned int currentTile_;
+        mutable unsigned int currentPage_;
+        mutable sf::IntRect tileRect_;
+        TileTransform tileTransform_;
+        bool hasCollisionFilter_;
+        std::uint32_t collisionCategory_;
+        std::uint32_t collisionMask_;
+        bool orientedCollision_;
+
+        mutable std::list< sf::FloatRect > collisionRects_;
+        mutable RectBatch collisionRectBatch_;
+        mutable std::vector< std::uint32_t > collisionRectLayers_;
+        mutable bool hasLayeredCollisionRects_;
+        // Only filled when oriented collision is on and the sprite is
+        // rotated (otherwise collision rects are exact).
+        mutable std::vector< OrientedRect > orientedCollisionRects_;
+        mutable unsigned int collisionRectsRevision_;
+        mutable TransformKey collisionRectsKey_;
+        mutable bool collisionRectsValid_;
+        mutable sf::FloatRect boundaryBox_;
+        mutable TransformKey boundaryBoxKey_;
+        mutable bool boundaryBoxValid_;
 };
 
 typedef std::unique_ptr< TileSprite > TileSpritePtr;
@@ -0,0 +1,109 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "tile_transform.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace m2g {
+
+/***
+ * 1. Tile transformations
+ ***/
+
+sf::Vector2f transformedTileDimensions( const sf::Vector2u& tileDimensions,
+                                        TileTransform transform )
+{
+    if( transform & TILE_ROTATE_90 ){
+        return sf::Vector2f( tileDimensions.y, tileDimensions.x );
+    }else{
+        return sf::Vector2f( tileDimensions.x, tileDimensions.y );
+    }
+}
+
+
+sf::FloatRect transformTileRect( const sf::FloatRect& rect,
+                                 const sf::Vector2u& tileDimensions,
+                                 TileTransform transform )
+{
+    if( transform == TILE_TRANSFORM_NONE ){
+        return rect;
+    }
+
+    const sf::Vector2f dimensions =
+            transformedTileDimensions( tileDimensions, transform );
+    sf::Vector2f corners[2] =
+    {
+        sf::Vector2f( rect.left, rect.top ),
+        sf::Vector2f( rect.left + rect.width, rect.top + rect.height )
+    };
+
+    for( sf::Vector2f& corner : corners ){
+        if( transform & TILE_ROTATE_90 ){
+            corner = sf::Vector2f( tileDimensions.y - corner.y, corner.x );
+        }
+        if( transform & TILE_FLIP_HORIZONTALLY ){
+            corner.x = dimensions.x - corner.x;
+        }
+        if( transform & TILE_FLIP_VERTICALLY ){
+            corner.y = dimensions.y - corner.y;
+        }
+    }
+
+    return sf::FloatRect( std::min( corners[0].x, corners[1].x ),
+                          std::min( corners[0].y, corners[1].y ),
+                          std::abs( corners[1].x - corners[0].x ),
+                          std::abs( corners[1].y - corners[0].y ) );
+}
+
+
+void transformTileTexCoords( const sf::IntRect& tileRect,
+                             TileTransform transform,
+                             sf::Vector2f texCoords[4] )
+{
+    const sf::Vector2u tileDimensions( tileRect.width, tileRect.height );
+    const sf::Vector2f dimensions =
+            transformedTileDimensions( tileDimensions, transform );
+    const sf::Vector2f corners[4] =
+    {
+        sf::Vector2f( 0.0f, 0.0f ),
+        sf::Vector2f( dimensions.x, 0.0f ),
+        sf::Vector2f( dimensions.x, dimensions.y ),
+        sf::Vector2f( 0.0f, dimensions.y )
+    };
+
+    // Map every corner of the transformed tile back to the source tile.
+    for( unsigned int i = 0; i < 4; i++ ){
+        sf::Vector2f corner = corners[i];
+        if( transform & TILE_FLIP_HORIZONTALLY ){
+            corner.x = dimensions.x - corner.x;
+        }
+        if( transform & TILE_FLIP_VERTICALLY ){
+            corner.y = dimensions.y - corner.y;
+        }
+        if( transform & TILE_ROTATE_90 ){
+            corner = sf::Vector2f( corner.y, tileDimensions.y - corner.x );
+        }
+
+        texCoords[i] = sf::Vector2f( tileRect.left + corner.x,
+                                     tileRect.top + corner.y );
+    }
+}
+
+} // namespace m2g
@@ -0,0 +1,61 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef TILE_TRANSFORM_HPP
+#define TILE_TRANSFORM_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+namespace m2g {
+
+// Flags for drawing a tile flipped and / or rotated without storing the
+// transformed pixels. The rotation (clockwise) is applied first and the flips
+// after it, along the axes of the rotated tile.
+typedef unsigned int TileTransform;
+
+const TileTransform TILE_TRANSFORM_NONE = 0;
+const TileTransform TILE_FLIP_HORIZONTALLY = 1;
+const TileTransform TILE_FLIP_VERTICALLY = 2;
+const TileTransform TILE_ROTATE_90 = 4;
+const TileTransform TILE_TRANSFORM_ALL = 7;
+
+
+/***
+ * 1. Tile transformations
+ ***/
+
+// Dimensions of the tile once transformed.
+sf::Vector2f transformedTileDimensions( const sf::Vector2u& tileDimensions,
+                                        TileTransform transform );
+
+// Transforms a rect given in tile coordinates (ie. a collision rect).
+sf::FloatRect transformTileRect( const sf::FloatRect& rect,
+                                 const sf::Vector2u& tileDimensions,
+                                 TileTransform transform );
+
+// Texture coordinates for the top-left, top-right, bottom-right and
+// bottom-left corners of the transformed tile.
+void transformTileTexCoords( const sf::IntRect& tileRect,
+                             TileTransform transform,
+                             sf::Vector2f texCoords[4] );
+
+} // namespace m2g
+
+#endif // TILE_TRANSFORM_HPP
@@ -18,40 +18,121 @@
 ***/
 
 #include "tileset.hpp"
+#include "../utilities/trace.hpp"
 #include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <atomic>
 
 namespace m2g {
 
+namespace {
+
+// Revisions are unique among all tilesets, so a sprite switching between
+// tilesets never mistakes one for the other.
+unsigned int nextRevision()
+{
+    static std::atomic< unsigned int > lastRevision( 0 );
+    return ++lastRevision;
+}
+
+} // namespace
+
+
+/***
+ * TilesetLoadOptions
+ ***/
+
+TilesetLoadOptions::TilesetLoadOptions( unsigned int maxTextureSize,
+                                        bool deduplicateTiles ) :
+    maxTextureSize( maxTextureSize ),
+    deduplicateTiles( deduplicateTiles )
+{}
+
+
 
 /***
  * 1. Initialization and destruction.
  ***/
 
-Tileset::Tileset( const std::string &imagePath, unsigned int tileWidth, unsigned int tileHeight ) :
-    tileDimensions_( tileWidth, tileHeight )
+Tileset::Tileset( const std::string &imagePath,
+                  unsigned int tileWidth,
+                  unsigned int tileHeight,
+                  unsigned int maxTextureSize ) :
+    Tileset( imagePath,
+             tileWidth,
+             tileHeight,
+             TilesetLoadOptions( maxTextureSize ) )
+{}
+
+
+Tileset::Tileset( const std::string &imagePath,
+                  unsigned int tileWidth,
+                  unsigned int tileHeight,
+                  const TilesetLoadOptions& options ) :
+    data_( std::make_shared< Data >( tileWidth, tileHeight ) )
 {
-    std::ifstream file( imagePath.c_str() );
-    if( !file.is_open() ){
-        throw std::runtime_error( "File not found" );
-    }
-    file.close();
-    texture_.loadFromFile( imagePath );
+    M2G_TRACE_SCOPE( "Tileset::Tileset" );
+    Stats::increment( STAT_TILESETS_LOADED );
+    const sf::Image image = loadImage( imagePath );
+    data_->region = sf::IntRect( 0, 0, image.getSize().x, image.getSize().y );
 
-    if( tileWidth > texture_.getSize().x ){
-        throw std::invalid_argument( "Tileset constructor - tile width can't be greater thant tileset width" );
-    }
-    if( texture_.getSize().x % tileWidth ){
-        throw std::invalid_argument( "Tileset constructor - tileset width must be dividable by tile width" );
+    initTileGrid( tileWidth, tileHeight );
+
+    sf::Image compactedImage;
+    if( options.deduplicateTiles && deduplicateTiles( image, compactedImage ) ){
+        loadPages( compactedImage, options.maxTextureSize );
+    }else{
+        loadPages( image, options.maxTextureSize );
     }
-    if( tileHeight > texture_.getSize().y ){
-        throw std::invalid_argument( "Tileset constructor - tile height can't be greater thant tileset height" );
+}
+
+
+Tileset::Tileset( std::shared_ptr< const sf::Texture > texture,
+                  const sf::IntRect& region,
+                  unsigned int tileWidth,
+                  unsigned int tileHeight ) :
+    data_( std::make_shared< Data >( tileWidth, tileHeight ) )
+{
+    data_->pages.push_back( std::move( texture ) );
+    data_->region = region;
+
+    if( data_->pages[0] == nullptr ){
+        throw std::invalid_argument( "Tileset constructor - texture can't be null" );
     }
-    if( texture_.getSize().y % tileHeight ){
-        throw std::invalid_argument( "Tileset constructor - tileset height must be dividable by tile height" );
+    if( data_->region.left < 0 || data_->region.top < 0 ||
+        data_->region.left + data_->region.width > static_cast< int >( data_->pages[0]->getSize().x ) ||
+        data_->region.top + data_->region.height > static_cast< int >( data_->pages[0]->getSize().y ) ){
+        throw std::out_of_range( "Tileset constructor - region out of texture bounds" );
     }
 
-    nRows_ = texture_.getSize().y / tileDimensions_.y;
-    nColumns_ = texture_.getSize().x / tileDimensions_.x;
+    initTileGrid( tileWidth, tileHeight );
+}
+
+
+Tileset::Tileset( DynamicAtlas& atlas,
+                  const std::string& imagePath,
+                  unsigned int tileWidth,
+                  unsigned int tileHeight ) :
+    Tileset( atlas, loadImage( imagePath ), tileWidth, tileHeight )
+{}
+
+
+Tileset::Tileset( DynamicAtlas& atlas,
+                  const sf::Image& image,
+                  unsigned int tileWidth,
+                  unsigned int tileHeight ) :
+    data_( std::make_shared< Data >( tileWidth, tileHeight ) )
+{
+    M2G_TRACE_SCOPE( "Tileset::Tileset(atlas)" );
+    // Check the tile grid before taking space from the atlas.
+    data_->region = sf::IntRect( 0, 0, image.getSize().x, image.getSize().y );
+    initTileGrid( tileWidth, tileHeight );
+
+    data_->atlasRegion = atlas.allocate( image );
+    data_->pages.push_back( data_->atlasRegion->texture() );
+    data_->region = data_->atlasRegion->rect();
 }
 
 
@@ -61,39 +142,69 @@ Tileset::Tileset( const std::string &imagePath, unsigned int tileWidth, unsigned
 
 sf::Vector2u Tileset::tileDimensions() const
 {
-    return tileDimensions_;
+    return data_->tileDimensions;
 }
 
 
 sf::Vector2u Tileset::dimensions() const
 {
-    return texture_.getSize();
+    return data_->dimensions;
 }
 
 
 sf::IntRect Tileset::tileRect( unsigned int tile ) const
 {
-    if( tile >= nRows_ * nColumns_ ){
+    if( tile >= data_->nTiles ){
         throw std::out_of_range( "tile " +
                                  std::to_string( tile ) +
                                  ") out of bounds (" +
-                                 std::to_string( nRows_ * nColumns_ )
+                                 std::to_string( data_->nTiles )
                                  + ")" );
     }
 
-    const unsigned int row = tile / nColumns_;
-    const unsigned int column = tile % nColumns_;
+    // Rect relative to the tile's page.
+    const unsigned int slot = tileSlot( tile );
+    const unsigned int row = ( slot / data_->nColumns ) % data_->nPageRows;
+    const unsigned int column = ( slot % data_->nColumns ) % data_->nPageColumns;
 
-    return sf::IntRect( column * tileDimensions_.x,
-                        row * tileDimensions_.y,
-                        tileDimensions_.x,
-                        tileDimensions_.y );
+    return sf::IntRect( data_->region.left + column * data_->tileDimensions.x,
+                        data_->region.top + row * data_->tileDimensions.y,
+                        data_->tileDimensions.x,
+                        data_->tileDimensions.y );
 }
 
 
 const sf::Texture &Tileset::texture() const
 {
-    return texture_;
+    return *( data_->pages[0] );
+}
+
+
+const sf::Texture &Tileset::texture( unsigned int page ) const
+{
+    return *( data_->pages.at( page ) );
+}
+
+
+unsigned int Tileset::tilePage( unsigned int tile ) const
+{
+    const unsigned int slot = tileSlot( tile );
+    const unsigned int row = slot / data_->nColumns;
+    const unsigned int column = slot % data_->nColumns;
+
+    return ( row / data_->nPageRows ) * data_->nPagesPerRow + column / data_->nPageColumns;
+}
+
+
+unsigned int Tileset::nPages() const
+{
+    return data_->pages.size();
+}
+
+
+sf::IntRect Tileset::region() const
+{
+    return data_->region;
 }
 
 
@@ -101,7 +212,7 @@ std::list<sf::IntRect> Tileset::collisionRects( unsigned int tile ) const
 {
     std::list<sf::IntRect> collisionRects;
 
-    for( const TilesetCollisionRect& colRect : collisionRects_ ){
+    for( const TilesetCollisionRect& colRect : data_->collisionRects ){
         if( tile >= colRect.firstTile && tile <= colRect.lastTile ){
             collisionRects.push_back( colRect.rect );
         }
@@ -111,9 +222,57 @@ std::list<sf::IntRect> Tileset::collisionRects( unsigned int tile ) const
 }
 
 
+const std::vector< TilesetCollisionRect >& Tileset::tileCollisionRects( unsigned int tile ) const
+{
+    static const std::vector< TilesetCollisionRect > noRects;
+
+    return ( tile < data_->tileCollisionRects.size() ) ?
+                data_->tileCollisionRects[tile] : noRects;
+}
+
+
+std::uint32_t Tileset::collisionCategory() const
+{
+    return data_->collisionCategory;
+}
+
+
+std::uint32_t Tileset::collisionMask() const
+{
+    return data_->collisionMask;
+}
+
+
 unsigned int Tileset::nTiles() const
 {
-    return nRows_ * nColumns_;
+    return data_->nTiles;
+}
+
+
+unsigned int Tileset::tileSlot( unsigned int tile ) const
+{
+    if( data_->tileSlots.empty() ){
+        return tile;
+    }
+    return data_->tileSlots.at( tile );
+}
+
+
+TileDeduplicationStats Tileset::deduplicationStats() const
+{
+    return data_->deduplicationStats;
+}
+
+
+unsigned int Tileset::revision() const
+{
+    return data_->revision;
+}
+
+
+bool Tileset::sharesContents() const
+{
+    return data_.use_count() > 1;
 }
 
 
@@ -123,16 +282,254 @@ unsigned int Tileset::nTiles() const
 
 void Tileset::addCollisionRect( const sf::IntRect &rect )
 {
-    addCollisionRect( rect, 0, nRows_ * nColumns_ );
+    addCollisionRect( rect, 0, data_->nTiles );
 }
 
 
 void Tileset::addCollisionRect( const sf::IntRect &rect,
                                 unsigned int firstTile,
-                                unsigned int lastTile )
+                                unsigned int lastTile,
+                                std::uint32_t layers )
 {
-    TilesetCollisionRect colRect = { rect, firstTile, lastTile };
-    collisionRects_.push_back( colRect );
+    Data& data = mutableData();
+    TilesetCollisionRect colRect = { rect, firstTile, lastTile, layers };
+    data.collisionRects.push_back( colRect );
+    data.collisionRectsStat.add( 1 );
+
+    data.tileCollisionRects.resize( data.nTiles );
+    for( unsigned int tile = firstTile; tile <= lastTile && tile < data.nTiles; tile++ ){
+        data.tileCollisionRects[tile].push_back( colRect );
+    }
+    data.revision = nextRevision();
+}
+
+
+void Tileset::setCollisionFilter( std::uint32_t category, std::uint32_t mask )
+{
+    Data& data = mutableData();
+    data.collisionCategory = category;
+    data.collisionMask = mask;
+    data.revision = nextRevision();
+}
+
+
+/***
+ * 4. Reloading
+ ***/
+
+void Tileset::reload( const Tileset& tileset )
+{
+    *data_ = *( tileset.data_ );
+    data_->revision = nextRevision();
+}
+
+
+/***
+ * 5. Auxiliar initialization methods
+ ***/
+
+Tileset::Data::Data( unsigned int tileWidth, unsigned int tileHeight ) :
+    tileDimensions( tileWidth, tileHeight ),
+    collisionCategory( DEFAULT_COLLISION_CATEGORY ),
+    collisionMask( ALL_COLLISION_CATEGORIES ),
+    nTiles( 0 ),
+    nRows( 0 ),
+    nColumns( 0 ),
+    deduplicationStats( { 0, 0, 0 } ),
+    nPageRows( 0 ),
+    nPageColumns( 0 ),
+    nPagesPerRow( 0 ),
+    revision( nextRevision() ),
+    tilesetStat( STAT_TILESETS, 1 ),
+    collisionRectsStat( STAT_COLLISION_RECTS )
+{}
+
+
+Tileset::Data& Tileset::mutableData()
+{
+    // Copy on write: changes made through a copy don't reach the others.
+    if( data_.use_count() > 1 ){
+        data_ = std::make_shared< Data >( *data_ );
+    }
+    return *data_;
+}
+
+
+void Tileset::initTileGrid( unsigned int tileWidth, unsigned int tileHeight )
+{
+    data_->dimensions = sf::Vector2u( data_->region.width, data_->region.height );
+    const sf::Vector2u dimensions = data_->dimensions;
+
+    if( tileWidth > dimensions.x ){
+        throw std::invalid_argument( "Tileset constructor - tile width can't be greater thant tileset width" );
+    }
+    if( dimensions.x % tileWidth ){
+        throw std::invalid_argument( "Tileset constructor - tileset width must be dividable by tile width" );
+    }
+    if( tileHeight > dimensions.y ){
+        throw std::invalid_argument( "Tileset constructor - tile height can't be greater thant tileset height" );
+    }
+    if( dimensions.y % tileHeight ){
+        throw std::invalid_argument( "Tileset constructor - tileset height must be dividable by tile height" );
+    }
+
+    data_->nRows = dimensions.y / data_->tileDimensions.y;
+    data_->nColumns = dimensions.x / data_->tileDimensions.x;
+    data_->nTiles = data_->nRows * data_->nColumns;
+    data_->deduplicationStats = { data_->nTiles, data_->nTiles, 0 };
+
+    // Single page by default.
+    data_->nPageRows = data_->nRows;
+    data_->nPageColumns = data_->nColumns;
+    data_->nPagesPerRow = 1;
+}
+
+
+void Tileset::loadPages( const sf::Image& image, unsigned int maxTextureSize )
+{
+    M2G_TRACE_SCOPE( "Tileset::loadPages" );
+    if( maxTextureSize == 0 ){
+        maxTextureSize = sf::Texture::getMaximumSize();
+    }
+
+    if( image.getSize().x <= maxTextureSize &&
+        image.getSize().y <= maxTextureSize ){
+        std::unique_ptr< sf::Texture > texture( new sf::Texture );
+        texture->loadFromImage( image );
+        data_->pages.push_back( Stats::trackTexture( std::move( texture ) ) );
+        return;
+    }
+
+    if( data_->tileDimensions.x > maxTextureSize || data_->tileDimensions.y > maxTextureSize ){
+        throw std::invalid_argument( "Tileset constructor - tile bigger than maximum texture size" );
+    }
+
+    data_->nPageColumns = std::min( data_->nColumns, maxTextureSize / data_->tileDimensions.x );
+    data_->nPageRows = std::min( data_->nRows, maxTextureSize / data_->tileDimensions.y );
+    data_->nPagesPerRow = ( data_->nColumns + data_->nPageColumns - 1 ) / data_->nPageColumns;
+    const unsigned int nPagesPerColumn = ( data_->nRows + data_->nPageRows - 1 ) / data_->nPageRows;
+
+    for( unsigned int pageRow = 0; pageRow < nPagesPerColumn; pageRow++ ){
+        for( unsigned int pageColumn = 0; pageColumn < data_->nPagesPerRow; pageColumn++ ){
+            const unsigned int firstRow = pageRow * data_->nPageRows;
+            const unsigned int firstColumn = pageColumn * data_->nPageColumns;
+            const sf::IntRect area(
+                        firstColumn * data_->tileDimensions.x,
+                        firstRow * data_->tileDimensions.y,
+                        std::min( data_->nPageColumns, data_->nColumns - firstColumn ) * data_->tileDimensions.x,
+                        std::min( data_->nPageRows, data_->nRows - firstRow ) * data_->tileDimensions.y );
+
+            std::unique_ptr< sf::Texture > texture( new sf::Texture );
+            if( !texture->loadFromImage( image, area ) ){
+                throw std::runtime_error( "Tileset constructor - couldn't create texture page" );
+            }
+            data_->pages.push_back( Stats::trackTexture( std::move( texture ) ) );
+        }
+    }
+}
+
+
+bool Tileset::deduplicateTiles( const sf::Image& image, sf::Image& compactedImage )
+{
+    M2G_TRACE_SCOPE( "Tileset::deduplicateTiles" );
+    const sf::Uint8* pixels = image.getPixelsPtr();
+    const std::size_t imageRowSize = image.getSize().x * 4;
+    const std::size_t tileRowSize = data_->tileDimensions.x * 4;
+
+    auto tileRow = [&]( unsigned int tile, unsigned int row ){
+        return pixels +
+                ( ( tile / data_->nColumns ) * data_->tileDimensions.y + row ) * imageRowSize +
+                ( tile % data_->nColumns ) * tileRowSize;
+    };
+
+    // Source tile of every slot and slot of every tile.
+    std::vector< unsigned int > slotTiles;
+    std::vector< unsigned int > tileSlots( data_->nTiles );
+    std::unordered_multimap< std::uint64_t, unsigned int > slotsByHash;
+
+    for( unsigned int tile = 0; tile < data_->nTiles; tile++ ){
+        // FNV-1a hash of the tile pixels.
+        std::uint64_t hash = 14695981039346656037ULL;
+        for( unsigned int row = 0; row < data_->tileDimensions.y; row++ ){
+            const sf::Uint8* rowPixels = tileRow( tile, row );
+            for( std::size_t i = 0; i < tileRowSize; i++ ){
+                hash = ( hash ^ rowPixels[i] ) * 1099511628211ULL;
+            }
+        }
+
+        bool duplicated = false;
+        auto candidates = slotsByHash.equal_range( hash );
+        for( auto it = candidates.first; it != candidates.second && !duplicated; it++ ){
+            const unsigned int candidateTile = slotTiles[it->second];
+            duplicated = true;
+            for( unsigned int row = 0; row < data_->tileDimensions.y && duplicated; row++ ){
+                duplicated = !memcmp( tileRow( tile, row ),
+                                      tileRow( candidateTile, row ),
+                                      tileRowSize );
+            }
+            if( duplicated ){
+                tileSlots[tile] = it->second;
+            }
+        }
+
+        if( !duplicated ){
+            tileSlots[tile] = slotTiles.size();
+            slotsByHash.insert( std::make_pair( hash, slotTiles.size() ) );
+            slotTiles.push_back( tile );
+        }
+    }
+
+    const unsigned int nSlots = slotTiles.size();
+    data_->deduplicationStats.nUniqueTiles = nSlots;
+    if( nSlots == data_->nTiles ){
+        return false;
+    }
+
+    // Copy the unique tiles to a smaller image, keeping the grid width.
+    const unsigned int nSourceColumns = data_->nColumns;
+    data_->nColumns = std::min( data_->nColumns, nSlots );
+    data_->nRows = ( nSlots + data_->nColumns - 1 ) / data_->nColumns;
+
+    compactedImage.create( data_->nColumns * data_->tileDimensions.x,
+                           data_->nRows * data_->tileDimensions.y,
+                           sf::Color( 0, 0, 0, 0 ) );
+    for( unsigned int slot = 0; slot < nSlots; slot++ ){
+        const unsigned int sourceTile = slotTiles[slot];
+        compactedImage.copy( image,
+                             ( slot % data_->nColumns ) * data_->tileDimensions.x,
+                             ( slot / data_->nColumns ) * data_->tileDimensions.y,
+                             sf::IntRect( ( sourceTile % nSourceColumns ) * data_->tileDimensions.x,
+                                          ( sourceTile / nSourceColumns ) * data_->tileDimensions.y,
+                                          data_->tileDimensions.x,
+                                          data_->tileDimensions.y ) );
+    }
+
+    data_->tileSlots = std::move( tileSlots );
+    data_->region = sf::IntRect( 0, 0, compactedImage.getSize().x, compactedImage.getSize().y );
+    data_->nPageRows = data_->nRows;
+    data_->nPageColumns = data_->nColumns;
+    data_->deduplicationStats.savedBytes =
+            static_cast< std::size_t >( data_->dimensions.x ) * data_->dimensions.y * 4 -
+            static_cast< std::size_t >( data_->region.width ) * data_->region.height * 4;
+
+    return true;
+}
+
+
+sf::Image Tileset::loadImage( const std::string& imagePath )
+{
+    M2G_TRACE_SCOPE( "Tileset::loadImage" );
+    std::ifstream file( imagePath.c_str() );
+    if( !file.is_open() ){
+        throw std::runtime_error( "File not found" );
+    }
+    file.close();
+
+    sf::Image image;
+    if( !image.loadFromFile( imagePath ) ){
+        throw std::runtime_error( "Couldn't load image [" + imagePath + "]" );
+    }
+    return image;
 }
 
 } // Namespace m2g
@@ -21,16 +21,54 @@
 #define TILESET_HPP
 
 #include <memory>
+#include <cstdint>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Image.hpp>
 #include <list>
+#include <vector>
+#include "dynamic_atlas.hpp"
+#include "../utilities/stats.hpp"
 
 namespace m2g {
 
+// Collision filtering: two sprites are only tested for collision when the
+// category bits of each one are in the mask of the other.
+const std::uint32_t DEFAULT_COLLISION_CATEGORY = 1;
+const std::uint32_t ALL_COLLISION_CATEGORIES = 0xFFFFFFFF;
+
 struct TilesetCollisionRect
 {
     sf::IntRect rect;
     unsigned int firstTile;
     unsigned int lastTile;
+
+    // Collision categories of the rect, so a tile can have, for example,
+    // separated hit and hurt boxes. ALL_COLLISION_CATEGORIES means those of
+    // the sprite; otherwise they should be a subset of them, as sprites are
+    // filtered before their rects.
+    std::uint32_t layers;
+};
+
+
+struct TilesetLoadOptions
+{
+    explicit TilesetLoadOptions( unsigned int maxTextureSize = 0,
+                                 bool deduplicateTiles = false );
+
+    // Images bigger than this are split into several texture pages (0 means
+    // sf::Texture::getMaximumSize()).
+    unsigned int maxTextureSize;
+
+    // Keep a single copy of byte-identical tiles in the texture.
+    bool deduplicateTiles;
+};
+
+
+struct TileDeduplicationStats
+{
+    unsigned int nTiles;
+    unsigned int nUniqueTiles;
+    std::size_t savedBytes;
 };
 
 
@@ -40,7 +78,29 @@ class Tileset
         /***
          * 1. Initialization and destruction.
          ***/
-        Tileset( const std::string& imagePath, unsigned int tileWidth, unsigned int tileHeight );
+        // Images bigger than maxTextureSize (0 means
+        // sf::Texture::getMaximumSize()) are split into several texture
+        // pages along tile boundaries.
+        Tileset( const std::string& imagePath,
+                 unsigned int tileWidth,
+                 unsigned int tileHeight,
+                 unsigned int maxTextureSize = 0 );
+        Tileset( const std::string& imagePath,
+                 unsigned int tileWidth,
+                 unsigned int tileHeight,
+                 const TilesetLoadOptions& options );
+        Tileset( std::shared_ptr< const sf::Texture > texture,
+                 const sf::IntRect& region,
+                 unsigned int tileWidth,
+                 unsigned int tileHeight );
+        Tileset( DynamicAtlas& atlas,
+                 const std::string& imagePath,
+                 unsigned int tileWidth,
+                 unsigned int tileHeight );
+        Tileset( DynamicAtlas& atlas,
+                 const sf::Image& image,
+                 unsigned int tileWidth,
+                 unsigned int tileHeight );
         virtual ~Tileset() = default;
 
 
@@ -51,8 +111,28 @@ class Tileset
         sf::Vector2u dimensions() const;
         virtual sf::IntRect tileRect( unsigned int tile ) const;
         virtual const sf::Texture& texture() const;
+        const sf::Texture& texture( unsigned int page ) const;
+        unsigned int tilePage( unsigned int tile ) const;
+        unsigned int nPages() const;
+        sf::IntRect region() const;
         std::list< sf::IntRect > collisionRects( unsigned int tile ) const;
+        // Same as collisionRects(), with the layers of every rect. Cached
+        // per tile, so it doesn't allocate; the reference is valid until
+        // this tileset is modified or destroyed.
+        const std::vector< TilesetCollisionRect >& tileCollisionRects( unsigned int tile ) const;
+        // Default collision filter of the sprites using this tileset.
+        std::uint32_t collisionCategory() const;
+        std::uint32_t collisionMask() const;
         unsigned int nTiles() const;
+        unsigned int tileSlot( unsigned int tile ) const;
+        TileDeduplicationStats deduplicationStats() const;
+
+        // Changes every time the tileset contents change (collision rects
+        // added or tileset reloaded).
+        unsigned int revision() const;
+
+        // True while other copies share the contents of this tileset.
+        bool sharesContents() const;
 
 
         /***
@@ -61,15 +141,73 @@ class Tileset
         void addCollisionRect( const sf::IntRect& rect );
         void addCollisionRect( const sf::IntRect& rect,
                                unsigned int firstTile,
-                               unsigned int lastTile );
+                               unsigned int lastTile,
+                               std::uint32_t layers = ALL_COLLISION_CATEGORIES );
+        void setCollisionFilter( std::uint32_t category, std::uint32_t mask );
+
+
+        /***
+         * 4. Reloading
+         ***/
+        // Copies of a tileset share its contents until one of them is
+        // modified (copy on write). Reloading replaces the shared contents
+        // with the given tileset ones, so every copy sharing them sees the
+        // change (used for hot reloading). Not thread-safe with respect to
+        // other users of the copies.
+        void reload( const Tileset& tileset );
 
 
     private:
-        sf::Texture texture_;
-        sf::Vector2u tileDimensions_;
-        std::list< TilesetCollisionRect > collisionRects_;
-        unsigned int nRows_;
-        unsigned int nColumns_;
+        struct Data
+        {
+            Data( unsigned int tileWidth, unsigned int tileHeight );
+
+            std::vector< std::shared_ptr< const sf::Texture > > pages;
+            sf::IntRect region;
+            AtlasRegionPtr atlasRegion;
+            sf::Vector2u dimensions;
+            sf::Vector2u tileDimensions;
+            std::list< TilesetCollisionRect > collisionRects;
+            // collisionRects by tile (empty until a rect is added).
+            std::vector< std::vector< TilesetCollisionRect > > tileCollisionRects;
+            std::uint32_t collisionCategory;
+            std::uint32_t collisionMask;
+            unsigned int nTiles;
+
+            // Grid of tiles actually stored in the texture(s). It differs
+            // from the logical one when duplicated tiles are removed.
+            unsigned int nRows;
+            unsigned int nColumns;
+            std::vector< unsigned int > tileSlots;
+            TileDeduplicationStats deduplicationStats;
+
+            // Tiles per page (row and column) and pages per row of pages.
+            unsigned int nPageRows;
+            unsigned int nPageColumns;
+            unsigned int nPagesPerRow;
+
+            unsigned int revision;
+            // Counted once per distinct contents, as copies of a tileset
+            // share them until modified.
+            StatContribution tilesetStat;
+            StatContribution collisionRectsStat;
+        };
+
+
+        /***
+         * 5. Auxiliar initialization methods
+         ***/
+        void initTileGrid( unsigned int tileWidth, unsigned int tileHeight );
+        void loadPages( const sf::Image& image, unsigned int maxTextureSize );
+        bool deduplicateTiles( const sf::Image& image, sf::Image& compactedImage );
+        static sf::Image loadImage( const std::string& imagePath );
+        Data& mutableData();
+
+
+        /***
+         * Attributes
+         ***/
+        std::shared_ptr< Data > data_;
 };
 
 typedef std::unique_ptr< Tileset > TilesetPtr;
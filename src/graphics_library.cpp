@@ -18,6 +18,12 @@
 ***/
 
 #include "graphics_library.hpp"
+#include "utilities/trace.hpp"
+#include "utilities/stats.hpp"
+#include "utilities/image_header.hpp"
+#include "utilities/path.hpp"
+#include <atomic>
+#include <chrono>
 
 namespace m2g {
 
@@ -27,218 +33,1044 @@ namespace m2g {
  ***/
 
 GraphicsLibrary::GraphicsLibrary( const std::string &libraryPath ) :
-    libraryPath_( libraryPath )
-{}
+    libraryPath_( libraryPath ),
+    dynamicAtlas_( nullptr ),
+    deduplicateTiles_( false ),
+    deduplicationStats_( { 0, 0, 0 } ),
+    tilesetSlots_( nullptr ),
+    animationSlots_( nullptr ),
+    nPrefetchRequests_( 0 ),
+    stopPrefetching_( false )
+{
+    nameIndex_ = indexLibrary( loadIndexes( {} ), nullptr );
+    publishSlots( *nameIndex_ );
+}
+
+
+/***
+ * 2. Destruction
+ ***/
+
+GraphicsLibrary::~GraphicsLibrary()
+{
+    if( prefetchThread_.joinable() ){
+        {
+            std::lock_guard< std::mutex > lock( prefetchMutex_ );
+            stopPrefetching_ = true;
+        }
+        prefetchCondition_.notify_all();
+        prefetchThread_.join();
+    }
+}
+
+
+/***
+ * 3. Setters
+ ***/
+
+void GraphicsLibrary::setDynamicAtlas( DynamicAtlas* atlas )
+{
+    dynamicAtlas_ = atlas;
+    clearCache();
+}
+
+
+void GraphicsLibrary::setTileDeduplication( bool deduplicateTiles )
+{
+    deduplicateTiles_ = deduplicateTiles;
+    clearCache();
+}
+
+
+void GraphicsLibrary::clearCache()
+{
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    for( const IndexedTileset& tileset : names->tilesets ){
+        tileset.slot->clear();
+    }
+    for( const IndexedAnimation& animation : names->animations ){
+        animation.slot->clear();
+    }
+}
 
 
 /***
- * 2. Loading
+ * 4. Getters
  ***/
 
+TileDeduplicationStats GraphicsLibrary::deduplicationStats() const
+{
+    std::lock_guard< std::mutex > lock( deduplicationStatsMutex_ );
+    return deduplicationStats_;
+}
+
+
+/***
+ * 5. Loading
+ ***/
+
+TilesetHandle GraphicsLibrary::tilesetHandle( const std::string& tilesetName ) const
+{
+    Stats::increment( STAT_LIBRARY_LOOKUPS );
+
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    auto it = names->tilesetHandles.find( tilesetName );
+    if( it == names->tilesetHandles.end() ){
+        return TilesetHandle();
+    }
+    return TilesetHandle( it->second );
+}
+
+
+AnimationHandle GraphicsLibrary::animationHandle( const std::string& animDataName ) const
+{
+    Stats::increment( STAT_LIBRARY_LOOKUPS );
+
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    auto it = names->animationHandles.find( animDataName );
+    if( it == names->animationHandles.end() ){
+        return AnimationHandle();
+    }
+    return AnimationHandle( it->second );
+}
+
+
+std::shared_ptr< const Tileset > GraphicsLibrary::getTileset( TilesetHandle handle )
+{
+    TilesetSlot& slot = *( tilesetSlots_.load( std::memory_order_acquire )->at( handle.index ) );
+    std::shared_ptr< Tileset > cachedTileset = slot.find();
+    if( cachedTileset != nullptr ){
+        return cachedTileset;
+    }
+
+    // The loader keeps the name index (and so the descriptor) alive.
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    const IndexedTileset& entry = names->tilesets.at( handle.index );
+    if( entry.descriptor == nullptr ){
+        return nullptr;
+    }
+    const TilesetDescriptor* descriptor = entry.descriptor;
+    const LibraryIndex* index = entry.index;
+    return slot.get( [this, names, descriptor, index](){
+        return std::shared_ptr< Tileset >( loadTileset( *descriptor, *index ) );
+    });
+}
+
+
+std::shared_ptr< const AnimationData > GraphicsLibrary::getAnimationData( AnimationHandle handle )
+{
+    AnimationSlot& slot = *( animationSlots_.load( std::memory_order_acquire )->at( handle.index ) );
+    std::shared_ptr< AnimationData > cachedAnimData = slot.find();
+    if( cachedAnimData != nullptr ){
+        return cachedAnimData;
+    }
+
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    const IndexedAnimation& entry = names->animations.at( handle.index );
+    if( entry.descriptor == nullptr ){
+        return nullptr;
+    }
+    const AnimationDescriptor* descriptor = entry.descriptor;
+    const LibraryIndex* index = entry.index;
+    return slot.get( [this, names, descriptor, index](){
+        return std::shared_ptr< AnimationData >( loadAnimationData( *descriptor, *index ) );
+    });
+}
+
+
 TilesetPtr GraphicsLibrary::getTilesetByName( const std::string& tilesetName )
 {
-    TilesetPtr tileset = nullptr;
-    tinyxml2::XMLDocument libraryFile;
-    libraryFile.LoadFile( libraryPath_.c_str() );
+    M2G_TRACE_SCOPE( "GraphicsLibrary::getTilesetByName" );
+    const TilesetHandle handle = tilesetHandle( tilesetName );
+    std::shared_ptr< const Tileset > tileset =
+            handle.valid() ? getTileset( handle ) : nullptr;
+    if( tileset == nullptr ){
+        return nullptr;
+    }
+    return TilesetPtr( new Tileset( *tileset ) );
+}
 
-    tinyxml2::XMLElement* rootElement =
-            libraryFile.FirstChildElement( "library" );
-    tinyxml2::XMLElement* xmlElement =
-            rootElement->FirstChildElement( "tileset" );
 
-    while( xmlElement != nullptr ){
-        std::string name, path;
-        loadNameAndPath( xmlElement, name, path );
+AnimationDataPtr GraphicsLibrary::getAnimationDataByName( const std::string& animDataName )
+{
+    M2G_TRACE_SCOPE( "GraphicsLibrary::getAnimationDataByName" );
+    const AnimationHandle handle = animationHandle( animDataName );
+    std::shared_ptr< const AnimationData > animData =
+            handle.valid() ? getAnimationData( handle ) : nullptr;
+    if( animData == nullptr ){
+        return nullptr;
+    }
+    return AnimationDataPtr( new AnimationData( *animData ) );
+}
 
-        if( name == tilesetName ){
-            return loadTilesetFromXML( xmlElement );
+
+AnimationDataList GraphicsLibrary::getAnimationDataByPrefix( const std::string &animDataName )
+{
+    M2G_TRACE_SCOPE( "GraphicsLibrary::getAnimationDataByPrefix" );
+    AnimationDataList animDataList;
+
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    for( unsigned int handleIndex : names->animationsInFileOrder ){
+        const std::string& name = names->animations[handleIndex].descriptor->tileset.name;
+        if( name.substr( 0, animDataName.size() ) == animDataName ){
+            std::shared_ptr< const AnimationData > animData =
+                    getAnimationData( AnimationHandle( handleIndex ) );
+            animDataList.push_back( AnimationDataPtr( new AnimationData( *animData ) ) );
         }
-        xmlElement = xmlElement->NextSiblingElement( "tileset" );
     }
 
-    return tileset;
+    return animDataList;
 }
 
 
-AnimationDataPtr GraphicsLibrary::getAnimationDataByName( const std::string& animDataName )
+/***
+ * 6. Hot reloading
+ ***/
+
+void GraphicsLibrary::enableHotReload()
+{
+    if( fileWatcher_ != nullptr ){
+        return;
+    }
+    fileWatcher_.reset( new FileWatcher );
+    watchFiles( *std::atomic_load( &nameIndex_ ) );
+}
+
+
+unsigned int GraphicsLibrary::pollChanges()
 {
-    tinyxml2::XMLDocument libraryFile;
-    libraryFile.LoadFile( libraryPath_.c_str() );
+    M2G_TRACE_SCOPE( "GraphicsLibrary::pollChanges" );
+    const unsigned int nReloaded = applyFinishedReloads();
+    if( fileWatcher_ == nullptr ){
+        return nReloaded;
+    }
 
-    tinyxml2::XMLElement* rootElement =
-            libraryFile.FirstChildElement( "library" );
-    tinyxml2::XMLElement* xmlElement =
-            rootElement->FirstChildElement( "animation" );
+    for( const std::string& path : fileWatcher_->changedFiles() ){
+        changedFiles_.insert( path );
+    }
+    if( changedFiles_.empty() ){
+        return nReloaded;
+    }
+    const std::set< std::string > changedFiles = changedFiles_;
 
-    while( xmlElement != nullptr ){
-        std::string name, path;
-        loadNameAndPath( xmlElement->FirstChildElement( "tileset" ), name, path );
+    // Index again only the library files which changed. If any of them is
+    // broken this throws and the current index is kept.
+    const NameIndexPtr oldNames = std::atomic_load( &nameIndex_ );
+    std::map< std::string, std::shared_ptr< const LibraryIndex > > reusableIndexes;
+    for( const std::shared_ptr< const LibraryIndex >& index : oldNames->indexes ){
+        const std::string path = resolvePath( index->libraryPath(), "" );
+        if( !changedFiles.count( path ) ){
+            reusableIndexes[path] = index;
+        }
+    }
+    const NameIndexPtr newNames = indexLibrary( loadIndexes( reusableIndexes ), oldNames.get() );
+    watchFiles( *newNames );
+
+    // Changed images can't be taken from the atlas pages cache anymore.
+    {
+        std::lock_guard< std::mutex > lock( atlasPagesMutex_ );
+        for( const std::string& path : changedFiles ){
+            atlasPages_.erase( path );
+        }
+    }
+
+    publishSlots( *newNames );
+    std::atomic_store( &nameIndex_, newNames );
+    changedFiles_.clear();
+
+    // Reload the cached entries which changed. Entries not cached yet only
+    // need to be forgotten (in case they are being loaded with the old
+    // descriptor).
+    // Handles keep their indices in the new index.
+    for( unsigned int i = 0; i < oldNames->tilesets.size(); i++ ){
+        const IndexedTileset& oldEntry = oldNames->tilesets[i];
+        const IndexedTileset& newEntry = newNames->tilesets[i];
+        if( oldEntry.descriptor == nullptr ){
+            continue;
+        }
+        if( newEntry.descriptor == nullptr ){
+            newEntry.slot->clear();
+        }else if( tilesetChanged( *oldEntry.descriptor, *oldEntry.index,
+                                  *newEntry.descriptor, *newEntry.index,
+                                  changedFiles ) ){
+            if( newEntry.slot->find() == nullptr ){
+                newEntry.slot->clear();
+            }else{
+                const TilesetDescriptor* descriptor = newEntry.descriptor;
+                const LibraryIndex* index = newEntry.index;
+                PendingReload reload;
+                reload.tilesetSlot = newEntry.slot;
+                reload.tileset = std::async( std::launch::async, [this, newNames, descriptor, index](){
+                    return loadTileset( *descriptor, *index );
+                });
+                scheduleReload( std::move( reload ) );
+            }
+        }
+    }
 
-        if( name == animDataName ){
-            return loadAnimationDataFromXML( xmlElement );
+    for( unsigned int i = 0; i < oldNames->animations.size(); i++ ){
+        const IndexedAnimation& oldEntry = oldNames->animations[i];
+        const IndexedAnimation& newEntry = newNames->animations[i];
+        if( oldEntry.descriptor == nullptr ){
+            continue;
+        }
+        if( newEntry.descriptor == nullptr ){
+            newEntry.slot->clear();
+        }else if( !( *oldEntry.descriptor == *newEntry.descriptor ) ||
+                  tilesetChanged( oldEntry.descriptor->tileset, *oldEntry.index,
+                                  newEntry.descriptor->tileset, *newEntry.index,
+                                  changedFiles ) ){
+            if( newEntry.slot->find() == nullptr ){
+                newEntry.slot->clear();
+            }else{
+                const AnimationDescriptor* descriptor = newEntry.descriptor;
+                const LibraryIndex* index = newEntry.index;
+                PendingReload reload;
+                reload.animDataSlot = newEntry.slot;
+                reload.animData = std::async( std::launch::async, [this, newNames, descriptor, index](){
+                    return loadAnimationData( *descriptor, *index );
+                });
+                scheduleReload( std::move( reload ) );
+            }
         }
-        xmlElement = xmlElement->NextSiblingElement( "animation" );
     }
 
-    return nullptr;
+    return nReloaded;
 }
 
 
-AnimationDataList GraphicsLibrary::getAnimationDataByPrefix( const std::string &animDataName )
+/***
+ * 7. Groups
+ ***/
+
+void GraphicsLibrary::prefetchGroup( const std::string& groupName, unsigned int priority )
 {
-    AnimationDataList animDataList;
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    const IndexedGroup& group = findGroup( *names, groupName );
 
-    tinyxml2::XMLDocument libraryFile;
-    libraryFile.LoadFile( libraryPath_.c_str() );
+    std::unique_lock< std::mutex > lock( prefetchMutex_ );
+    std::shared_ptr< GroupState >& state = groupStates_[groupName];
+    if( state == nullptr ){
+        state = std::make_shared< GroupState >();
+    }
+    state->retained = true;
+    state->priority = priority;
+    state->nFailed = 0;
 
-    tinyxml2::XMLElement* rootElement =
-            libraryFile.FirstChildElement( "library" );
-    tinyxml2::XMLElement* xmlElement =
-            rootElement->FirstChildElement( "animation" );
+    // Requests queued with the old priority are skipped when dequeued.
+    for( unsigned int handleIndex : group.tilesets ){
+        prefetchQueue_.push( { priority, nPrefetchRequests_++, false, handleIndex, state } );
+        releasedTilesets_.erase( handleIndex );
+    }
+    for( unsigned int handleIndex : group.animations ){
+        prefetchQueue_.push( { priority, nPrefetchRequests_++, true, handleIndex, state } );
+        releasedAnimations_.erase( handleIndex );
+    }
 
-    while( xmlElement != nullptr ){
-        std::string name, path;
-        loadNameAndPath( xmlElement->FirstChildElement( "tileset" ), name, path );
+    if( !prefetchThread_.joinable() ){
+        prefetchThread_ = std::thread( &GraphicsLibrary::streamAssets, this );
+    }
+    lock.unlock();
+    prefetchCondition_.notify_one();
+}
 
-        if( name.substr( 0, animDataName.size() ) == animDataName ){
-            animDataList.push_back( loadAnimationDataFromXML( xmlElement ) );
+
+GroupProgress GraphicsLibrary::groupProgress( const std::string& groupName ) const
+{
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    const IndexedGroup& group = findGroup( *names, groupName );
+
+    GroupProgress progress = { 0, 0, 0 };
+    for( unsigned int handleIndex : group.tilesets ){
+        progress.nAssets++;
+        progress.nLoaded += ( names->tilesets[handleIndex].slot->find() != nullptr );
+    }
+    for( unsigned int handleIndex : group.animations ){
+        progress.nAssets++;
+        progress.nLoaded += ( names->animations[handleIndex].slot->find() != nullptr );
+    }
+
+    std::lock_guard< std::mutex > lock( prefetchMutex_ );
+    auto state = groupStates_.find( groupName );
+    if( state != groupStates_.end() ){
+        progress.nFailed = state->second->nFailed;
+    }
+    return progress;
+}
+
+
+unsigned int GraphicsLibrary::releaseGroup( const std::string& groupName )
+{
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    const IndexedGroup& group = findGroup( *names, groupName );
+
+    {
+        std::lock_guard< std::mutex > lock( prefetchMutex_ );
+        auto state = groupStates_.find( groupName );
+        if( state != groupStates_.end() ){
+            state->second->retained = false;
         }
-        xmlElement = xmlElement->NextSiblingElement( "animation" );
+        releasedTilesets_.insert( group.tilesets.begin(), group.tilesets.end() );
+        releasedAnimations_.insert( group.animations.begin(), group.animations.end() );
     }
 
-    return animDataList;
+    return releaseUnusedAssets();
+}
+
+
+unsigned int GraphicsLibrary::releaseUnusedAssets()
+{
+    const NameIndexPtr names = std::atomic_load( &nameIndex_ );
+    std::lock_guard< std::mutex > lock( prefetchMutex_ );
+
+    // Assets listed by retained groups are kept.
+    std::set< unsigned int > retainedTilesets;
+    std::set< unsigned int > retainedAnimations;
+    for( const auto& state : groupStates_ ){
+        auto group = names->groups.find( state.first );
+        if( state.second->retained && group != names->groups.end() ){
+            retainedTilesets.insert( group->second.tilesets.begin(), group->second.tilesets.end() );
+            retainedAnimations.insert( group->second.animations.begin(), group->second.animations.end() );
+        }
+    }
+
+    // Besides the slot, the only owner of an unused asset is the local
+    // pointer.
+    unsigned int nReleased = 0;
+    auto tilesetIt = releasedTilesets_.begin();
+    while( tilesetIt != releasedTilesets_.end() ){
+        const std::shared_ptr< TilesetSlot >& slot = names->tilesets[*tilesetIt].slot;
+        std::shared_ptr< Tileset > tileset = slot->find();
+        if( tileset != nullptr && !retainedTilesets.count( *tilesetIt ) ){
+            if( tileset.use_count() > 2 || tileset->sharesContents() ){
+                tilesetIt++;
+                continue;
+            }
+            slot->clear();
+            nReleased++;
+        }
+        tilesetIt = releasedTilesets_.erase( tilesetIt );
+    }
+
+    auto animationIt = releasedAnimations_.begin();
+    while( animationIt != releasedAnimations_.end() ){
+        const std::shared_ptr< AnimationSlot >& slot = names->animations[*animationIt].slot;
+        std::shared_ptr< AnimationData > animData = slot->find();
+        if( animData != nullptr && !retainedAnimations.count( *animationIt ) ){
+            if( animData.use_count() > 2 || animData->sharesContents() ){
+                animationIt++;
+                continue;
+            }
+            slot->clear();
+            nReleased++;
+        }
+        animationIt = releasedAnimations_.erase( animationIt );
+    }
+
+    return nReleased;
 }
 
 
 /***
- * 3. Auxiliar loading methods
+ * 8. Validation
  ***/
 
-void GraphicsLibrary::loadNameAndPath( tinyxml2::XMLElement *tileSetXML,
-                                       std::string &name,
-                                       std::string &path )
+std::vector< std::string > GraphicsLibrary::validate( const std::string& libraryPath )
 {
-    path = tileSetXML->FirstChildElement( "src" )->GetText();
+    M2G_TRACE_SCOPE( "GraphicsLibrary::validate" );
 
-    if( tileSetXML->FirstChildElement( "name" ) != nullptr ){
-        name = tileSetXML->FirstChildElement( "name" )->GetText();
+    struct ValidatedFile
+    {
+        std::shared_ptr< const LibraryIndex > index;
+        std::vector< std::string > errors;
+    };
+    auto validateFile = []( const std::string& path ){
+        ValidatedFile file;
+        file.index.reset( new LibraryIndex( path, &file.errors ) );
+        const std::vector< std::string > entryErrors = validateIndex( *file.index );
+        file.errors.insert( file.errors.end(), entryErrors.begin(), entryErrors.end() );
+        return file;
+    };
+
+    // Included files start being checked as soon as the file including
+    // them has been indexed.
+    std::vector< std::string > errors;
+    LibraryIndexes indexes;
+    const std::string rootPath = resolvePath( libraryPath, "" );
+    std::set< std::string > indexedPaths = { rootPath };
+    std::vector< std::future< ValidatedFile > > level;
+    level.push_back( std::async( std::launch::async, validateFile, rootPath ) );
+    while( !level.empty() ){
+        std::vector< std::future< ValidatedFile > > nextLevel;
+        for( auto& validatedFile : level ){
+            ValidatedFile file = validatedFile.get();
+            errors.insert( errors.end(), file.errors.begin(), file.errors.end() );
+            for( const std::string& src : file.index->includes() ){
+                const std::string path = resolvePath( file.index->libraryPath(), src );
+                if( indexedPaths.insert( path ).second ){
+                    nextLevel.push_back( std::async( std::launch::async, validateFile, path ) );
+                }
+            }
+            indexes.push_back( file.index );
+        }
+        level = std::move( nextLevel );
+    }
+
+    // Names are checked across files.
+    std::map< std::string, std::string > tilesetFiles;
+    std::map< std::string, std::string > animationFiles;
+    std::set< std::string > groupNames;
+    for( const std::shared_ptr< const LibraryIndex >& index : indexes ){
+        for( const TilesetDescriptor& tileset : index->tilesets() ){
+            auto inserted = tilesetFiles.insert( { tileset.name, index->libraryPath() } );
+            if( !inserted.second ){
+                errors.push_back( "Tileset [" + tileset.name + "] defined in [" +
+                                  inserted.first->second + "] and [" + index->libraryPath() + "]" );
+            }
+        }
+        for( const AnimationDescriptor& animation : index->animations() ){
+            auto inserted = animationFiles.insert( { animation.tileset.name, index->libraryPath() } );
+            if( !inserted.second ){
+                errors.push_back( "Animation [" + animation.tileset.name + "] defined in [" +
+                                  inserted.first->second + "] and [" + index->libraryPath() + "]" );
+            }
+        }
+    }
+    for( const std::shared_ptr< const LibraryIndex >& index : indexes ){
+        for( const GroupDescriptor& group : index->groups() ){
+            if( !groupNames.insert( group.name ).second ){
+                errors.push_back( "Group [" + group.name + "] defined twice (last one in [" +
+                                  index->libraryPath() + "])" );
+            }
+            for( const std::string& tilesetName : group.tilesets ){
+                if( !tilesetFiles.count( tilesetName ) ){
+                    errors.push_back( "Group [" + group.name + "] lists unknown tileset [" +
+                                      tilesetName + "]" );
+                }
+            }
+            for( const std::string& animationName : group.animations ){
+                if( !animationFiles.count( animationName ) ){
+                    errors.push_back( "Group [" + group.name + "] lists unknown animation [" +
+                                      animationName + "]" );
+                }
+            }
+        }
+    }
+
+    return errors;
+}
+
+
+/***
+ * 9. Auxiliar loading methods
+ ***/
+
+GraphicsLibrary::LibraryIndexes GraphicsLibrary::loadIndexes( const std::map< std::string, std::shared_ptr< const LibraryIndex > >& reusableIndexes ) const
+{
+    M2G_TRACE_SCOPE( "GraphicsLibrary::loadIndexes" );
+
+    // Reused indexes are "loaded" by deferred tasks returning them.
+    auto loadIndex = [&reusableIndexes]( const std::string& path ){
+        auto reusableIndex = reusableIndexes.find( path );
+        if( reusableIndex != reusableIndexes.end() ){
+            const std::shared_ptr< const LibraryIndex > index = reusableIndex->second;
+            return std::async( std::launch::deferred, [index](){ return index; } );
+        }
+        return std::async( std::launch::async, [path](){
+            return std::shared_ptr< const LibraryIndex >( new LibraryIndex( path ) );
+        });
+    };
+
+    LibraryIndexes indexes;
+    const std::string rootPath = resolvePath( libraryPath_, "" );
+    std::set< std::string > indexedPaths = { rootPath };
+    indexes.push_back( loadIndex( rootPath ).get() );
+
+    // Files are indexed level by level: all the files included by the
+    // previous level are indexed in parallel. Files already indexed are
+    // skipped, so include cycles are harmless.
+    std::size_t levelBegin = 0;
+    while( levelBegin < indexes.size() ){
+        const std::size_t levelEnd = indexes.size();
+        std::vector< std::future< std::shared_ptr< const LibraryIndex > > > includedIndexes;
+
+        for( std::size_t i = levelBegin; i < levelEnd; i++ ){
+            for( const std::string& src : indexes[i]->includes() ){
+                const std::string path = resolvePath( indexes[i]->libraryPath(), src );
+                if( indexedPaths.insert( path ).second ){
+                    includedIndexes.push_back( loadIndex( path ) );
+                }
+            }
+        }
+
+        for( auto& includedIndex : includedIndexes ){
+            indexes.push_back( includedIndex.get() );
+        }
+        levelBegin = levelEnd;
+    }
+
+    return indexes;
+}
+
+
+GraphicsLibrary::NameIndexPtr GraphicsLibrary::indexLibrary( const LibraryIndexes& indexes,
+                                                            const NameIndex* previousNames )
+{
+    std::shared_ptr< NameIndex > names( new NameIndex );
+    names->indexes = indexes;
+    if( previousNames != nullptr ){
+        names->tilesetHandles = previousNames->tilesetHandles;
+        names->animationHandles = previousNames->animationHandles;
+        for( const IndexedTileset& tileset : previousNames->tilesets ){
+            names->tilesets.push_back( { nullptr, nullptr, tileset.slot } );
+        }
+        for( const IndexedAnimation& animation : previousNames->animations ){
+            names->animations.push_back( { nullptr, nullptr, animation.slot } );
+        }
+    }
+
+    for( const std::shared_ptr< const LibraryIndex >& index : indexes ){
+        for( const TilesetDescriptor& tileset : index->tilesets() ){
+            auto inserted = names->tilesetHandles.insert( { tileset.name, names->tilesets.size() } );
+            if( inserted.second ){
+                names->tilesets.push_back( { nullptr, nullptr, std::make_shared< TilesetSlot >() } );
+            }
+
+            IndexedTileset& entry = names->tilesets[inserted.first->second];
+            if( entry.descriptor != nullptr ){
+                throw std::runtime_error( "Tileset [" + tileset.name + "] defined in [" +
+                                          entry.index->libraryPath() + "] and [" +
+                                          index->libraryPath() + "]" );
+            }
+            entry.descriptor = &tileset;
+            entry.index = index.get();
+        }
+
+        for( const AnimationDescriptor& animation : index->animations() ){
+            const std::string& name = animation.tileset.name;
+            auto inserted = names->animationHandles.insert( { name, names->animations.size() } );
+            if( inserted.second ){
+                names->animations.push_back( { nullptr, nullptr, std::make_shared< AnimationSlot >() } );
+            }
+
+            IndexedAnimation& entry = names->animations[inserted.first->second];
+            if( entry.descriptor != nullptr ){
+                throw std::runtime_error( "Animation [" + name + "] defined in [" +
+                                          entry.index->libraryPath() + "] and [" +
+                                          index->libraryPath() + "]" );
+            }
+            entry.descriptor = &animation;
+            entry.index = index.get();
+            names->animationsInFileOrder.push_back( inserted.first->second );
+        }
+    }
+
+    // Groups are resolved once every entry is known, as they can list
+    // entries of any file.
+    for( const std::shared_ptr< const LibraryIndex >& index : indexes ){
+        for( const GroupDescriptor& group : index->groups() ){
+            auto inserted = names->groups.insert( { group.name, IndexedGroup() } );
+            if( !inserted.second ){
+                throw std::runtime_error( "Group [" + group.name + "] defined twice (last one in [" +
+                                          index->libraryPath() + "])" );
+            }
+
+            for( const std::string& tilesetName : group.tilesets ){
+                auto handle = names->tilesetHandles.find( tilesetName );
+                if( handle == names->tilesetHandles.end() ||
+                    names->tilesets[handle->second].descriptor == nullptr ){
+                    throw std::runtime_error( "Group [" + group.name + "] lists unknown tileset [" +
+                                              tilesetName + "]" );
+                }
+                inserted.first->second.tilesets.push_back( handle->second );
+            }
+            for( const std::string& animationName : group.animations ){
+                auto handle = names->animationHandles.find( animationName );
+                if( handle == names->animationHandles.end() ||
+                    names->animations[handle->second].descriptor == nullptr ){
+                    throw std::runtime_error( "Group [" + group.name + "] lists unknown animation [" +
+                                              animationName + "]" );
+                }
+                inserted.first->second.animations.push_back( handle->second );
+            }
+        }
+    }
+
+    return names;
+}
+
+
+void GraphicsLibrary::publishSlots( const NameIndex& names )
+{
+    // Entries are never removed, so a table is only outdated when shorter.
+    const TilesetSlots* tilesetSlots = tilesetSlots_.load( std::memory_order_relaxed );
+    if( tilesetSlots == nullptr || tilesetSlots->size() < names.tilesets.size() ){
+        std::unique_ptr< TilesetSlots > newSlots( new TilesetSlots );
+        for( const IndexedTileset& tileset : names.tilesets ){
+            newSlots->push_back( tileset.slot );
+        }
+        tilesetSlots_.store( newSlots.get(), std::memory_order_release );
+        tilesetSlotTables_.push_back( std::move( newSlots ) );
+    }
+
+    const AnimationSlots* animationSlots = animationSlots_.load( std::memory_order_relaxed );
+    if( animationSlots == nullptr || animationSlots->size() < names.animations.size() ){
+        std::unique_ptr< AnimationSlots > newSlots( new AnimationSlots );
+        for( const IndexedAnimation& animation : names.animations ){
+            newSlots->push_back( animation.slot );
+        }
+        animationSlots_.store( newSlots.get(), std::memory_order_release );
+        animationSlotTables_.push_back( std::move( newSlots ) );
+    }
+}
+
+
+TilesetPtr GraphicsLibrary::loadTileset( const TilesetDescriptor& descriptor,
+                                         const LibraryIndex& index )
+{
+    M2G_TRACE_SCOPE( "GraphicsLibrary::loadTileset" );
+    const std::string path = resolvePath( index.libraryPath(), descriptor.src );
+    const unsigned int width = descriptor.tileDimensions.x;
+    const unsigned int height = descriptor.tileDimensions.y;
+
+    TilesetPtr newTileset;
+    if( descriptor.packed ){
+        newTileset.reset(
+                    new Tileset( loadAtlasPage( index, descriptor.atlasPage ),
+                                 descriptor.atlasRect,
+                                 width,
+                                 height ) );
+    }else if( dynamicAtlas_ != nullptr ){
+        newTileset.reset( new Tileset( *dynamicAtlas_, path, width, height ) );
     }else{
-        // name = filename
-        size_t slashPos = path.find_last_of( '/' );
-        if( slashPos != std::string::npos ){
-            name = path.substr( slashPos + 1, path.size() );
+        newTileset.reset(
+                    new Tileset( path,
+                                 width,
+                                 height,
+                                 TilesetLoadOptions( 0, deduplicateTiles_ ) ) );
+    }
+
+    const TileDeduplicationStats stats = newTileset->deduplicationStats();
+    std::unique_lock< std::mutex > statsLock( deduplicationStatsMutex_ );
+    deduplicationStats_.nTiles += stats.nTiles;
+    deduplicationStats_.nUniqueTiles += stats.nUniqueTiles;
+    deduplicationStats_.savedBytes += stats.savedBytes;
+    statsLock.unlock();
+
+    for( const CollisionRectDescriptor& collisionRect : descriptor.collisionRects ){
+        if( collisionRect.allTiles ){
+            newTileset->addCollisionRect( collisionRect.rect, 0, newTileset->nTiles(),
+                                          collisionRect.layers );
         }else{
-            name = path;
+            newTileset->addCollisionRect( collisionRect.rect,
+                                          collisionRect.firstTile,
+                                          collisionRect.lastTile,
+                                          collisionRect.layers );
         }
     }
+    newTileset->setCollisionFilter( descriptor.collisionCategory, descriptor.collisionMask );
+
+    return newTileset;
 }
 
 
-TilesetPtr GraphicsLibrary::loadTilesetFromXML( tinyxml2::XMLElement *tilesetXML )
+AnimationDataPtr GraphicsLibrary::loadAnimationData( const AnimationDescriptor& descriptor,
+                                                     const LibraryIndex& index )
 {
-    std::string name, path;
-    loadNameAndPath( tilesetXML, name, path );
-    const std::string libraryDirPath = getDirPath( libraryPath_ );
-    path = libraryDirPath + '/' + path;
+    M2G_TRACE_SCOPE( "GraphicsLibrary::loadAnimationData" );
+    AnimationDataPtr animData( new AnimationData( loadTileset( descriptor.tileset, index ),
+                                                  descriptor.refreshRate ) );
+    for( const AnimationState& state : descriptor.states ){
+        animData->addState( state );
+    }
 
-    const tinyxml2::XMLElement* dimensionsElement =
-            tilesetXML->FirstChildElement( "tile_dimensions" );
-    const unsigned int width =
-            dimensionsElement->UnsignedAttribute( "width" );
-    const unsigned int height =
-            dimensionsElement->UnsignedAttribute( "height" );
+    return animData;
+}
 
-    TilesetPtr newTileset( new Tileset( path, width, height ) );
 
-    loadCollisionRects( *newTileset, tilesetXML->FirstChildElement( "collision_rects" ) );
+std::shared_ptr< const sf::Texture > GraphicsLibrary::loadAtlasPage( const LibraryIndex& index,
+                                                                     unsigned int pageIndex )
+{
+    M2G_TRACE_SCOPE( "GraphicsLibrary::loadAtlasPage" );
 
-    return newTileset;
+    const std::string pagePath =
+            resolvePath( index.libraryPath(), index.atlasPageSrc( pageIndex ) );
+
+    // Held while loading, so a page is never loaded twice.
+    std::lock_guard< std::mutex > lock( atlasPagesMutex_ );
+    std::weak_ptr< const sf::Texture >& cachedPage = atlasPages_[pagePath];
+    std::shared_ptr< const sf::Texture > page = cachedPage.lock();
+    if( page != nullptr ){
+        return page;
+    }
+
+    std::unique_ptr< sf::Texture > pageTexture( new sf::Texture );
+    if( !pageTexture->loadFromFile( pagePath ) ){
+        throw std::runtime_error( "Couldn't load atlas page [" + pagePath + "]" );
+    }
+
+    std::shared_ptr< sf::Texture > texture = Stats::trackTexture( std::move( pageTexture ) );
+    cachedPage = texture;
+    return texture;
 }
 
-AnimationDataPtr GraphicsLibrary::loadAnimationDataFromXML( tinyxml2::XMLElement *animDataXML )
+
+std::string GraphicsLibrary::imagePath( const TilesetDescriptor& descriptor,
+                                        const LibraryIndex& index )
 {
-    TilesetPtr tileset =
-            loadTilesetFromXML( animDataXML->FirstChildElement( "tileset" ) );
-    unsigned int refreshRate = DEFAULT_ANIMATION_REFRESH_RATE;
-    if( animDataXML->Attribute( "fps") != nullptr ){
-        refreshRate = animDataXML->UnsignedAttribute( "fps" );
+    if( descriptor.packed ){
+        return resolvePath( index.libraryPath(), index.atlasPageSrc( descriptor.atlasPage ) );
     }
+    return resolvePath( index.libraryPath(), descriptor.src );
+}
 
-    AnimationDataPtr animData( new AnimationData( std::move( tileset ), refreshRate ) );
 
-    loadAnimationDataStates( *animData,
-                             animDataXML->FirstChildElement( "animation_states" ) );
+/***
+ * 10. Auxiliar hot reloading methods
+ ***/
 
-    return animData;
+void GraphicsLibrary::watchFiles( const NameIndex& names )
+{
+    for( const std::shared_ptr< const LibraryIndex >& index : names.indexes ){
+        fileWatcher_->watch( resolvePath( index->libraryPath(), "" ) );
+    }
+    for( const IndexedTileset& entry : names.tilesets ){
+        if( entry.descriptor != nullptr ){
+            fileWatcher_->watch( imagePath( *entry.descriptor, *entry.index ) );
+        }
+    }
+    for( const IndexedAnimation& entry : names.animations ){
+        if( entry.descriptor != nullptr ){
+            fileWatcher_->watch( imagePath( entry.descriptor->tileset, *entry.index ) );
+        }
+    }
 }
 
 
-void GraphicsLibrary::loadCollisionRects( Tileset& tileset, tinyxml2::XMLElement *xmlElement )
+unsigned int GraphicsLibrary::applyFinishedReloads()
 {
-    if( xmlElement ){
-        xmlElement = xmlElement->FirstChildElement( "collision_rect" );
-        while( xmlElement ){
-            unsigned int firstTile, lastTile;
+    unsigned int nReloaded = 0;
+    std::string errors;
 
-            const std::string tilesStr = xmlElement->Attribute( "tiles" );
+    auto it = pendingReloads_.begin();
+    while( it != pendingReloads_.end() ){
+        std::future_status status = it->tileset.valid() ?
+                    it->tileset.wait_for( std::chrono::seconds( 0 ) ) :
+                    it->animData.wait_for( std::chrono::seconds( 0 ) );
+        if( status != std::future_status::ready ){
+            it++;
+            continue;
+        }
 
-            if( tilesStr == "all" ){
-                firstTile = 0;
-                lastTile = tileset.nTiles();
+        try{
+            if( it->tileset.valid() ){
+                TilesetPtr tileset = it->tileset.get();
+                std::shared_ptr< Tileset > cachedTileset = it->tilesetSlot->find();
+                if( !it->superseded && cachedTileset != nullptr ){
+                    cachedTileset->reload( *tileset );
+                    nReloaded++;
+                }
             }else{
-                std::size_t separatorPos = tilesStr.find( '-' );
-                if( separatorPos != std::string::npos ){
-                    firstTile = atoi( tilesStr.substr( 0, separatorPos ).c_str() );
-                    lastTile = atoi( tilesStr.substr( separatorPos + 1, tilesStr.size() ).c_str() );
-                }else{
-                    firstTile = lastTile = xmlElement->UnsignedAttribute( "tiles" );
+                AnimationDataPtr animData = it->animData.get();
+                std::shared_ptr< AnimationData > cachedAnimData = it->animDataSlot->find();
+                if( !it->superseded && cachedAnimData != nullptr ){
+                    cachedAnimData->reload( *animData );
+                    nReloaded++;
                 }
             }
+        }catch( std::exception& e ){
+            if( !it->superseded ){
+                errors += std::string( errors.empty() ? "" : "; " ) + e.what();
+            }
+        }
+        it = pendingReloads_.erase( it );
+    }
 
-            sf::IntRect rect;
-            rect.left = xmlElement->UnsignedAttribute( "x" );
-            rect.top = xmlElement->UnsignedAttribute( "y" );
-            rect.width = xmlElement->UnsignedAttribute( "width" );
-            rect.height = xmlElement->UnsignedAttribute( "height" );
+    if( !errors.empty() ){
+        throw std::runtime_error( "Couldn't reload library entries: " + errors );
+    }
+    return nReloaded;
+}
 
-            tileset.addCollisionRect( rect, firstTile, lastTile );
 
-            xmlElement = xmlElement->NextSiblingElement( "collision_rect" );
+void GraphicsLibrary::scheduleReload( PendingReload reload )
+{
+    // Older reloads of the entry can't be cancelled, but they must not
+    // overwrite the newest contents if they finish later.
+    for( PendingReload& pendingReload : pendingReloads_ ){
+        if( pendingReload.tilesetSlot == reload.tilesetSlot &&
+            pendingReload.animDataSlot == reload.animDataSlot ){
+            pendingReload.superseded = true;
         }
     }
+    reload.superseded = false;
+    pendingReloads_.push_back( std::move( reload ) );
 }
 
 
-std::string GraphicsLibrary::getDirPath( const std::string& path )
+bool GraphicsLibrary::tilesetChanged( const TilesetDescriptor& oldDescriptor,
+                                      const LibraryIndex& oldIndex,
+                                      const TilesetDescriptor& newDescriptor,
+                                      const LibraryIndex& newIndex,
+                                      const std::set< std::string >& changedFiles )
 {
-    std::size_t slashPos = path.find_last_of( '/' );
+    const std::string newImagePath = imagePath( newDescriptor, newIndex );
+    return !( oldDescriptor == newDescriptor ) ||
+            imagePath( oldDescriptor, oldIndex ) != newImagePath ||
+            changedFiles.count( newImagePath );
+}
 
-    if( slashPos != std::string::npos ){
-        return path.substr( 0, slashPos );
-    }else{
-        return ".";
+
+/***
+ * 11. Auxiliar streaming methods
+ ***/
+
+bool GraphicsLibrary::PrefetchRequest::operator < ( const PrefetchRequest& b ) const
+{
+    if( priority != b.priority ){
+        return priority < b.priority;
     }
+    return order > b.order;
 }
 
 
-void GraphicsLibrary::loadAnimationDataStates( AnimationData &animData,
-                                               tinyxml2::XMLElement *statesNode )
+const GraphicsLibrary::IndexedGroup& GraphicsLibrary::findGroup( const NameIndex& names,
+                                                                 const std::string& groupName )
 {
-    if( statesNode != nullptr ){
-        tinyxml2::XMLElement* stateNode =
-                statesNode->FirstChildElement( "animation_state" );
+    auto group = names.groups.find( groupName );
+    if( group == names.groups.end() ){
+        throw std::out_of_range( "Unknown group [" + groupName + "]" );
+    }
+    return group->second;
+}
 
-        while( stateNode != nullptr ){
-            AnimationState animState(
-                        stateNode->UnsignedAttribute( "first_frame" ),
-                        stateNode->UnsignedAttribute( "last_frame" ),
-                        stateNode->UnsignedAttribute( "back_frame" )
-                        );
-            animData.addState( animState );
 
-            stateNode = stateNode->NextSiblingElement( "animation_state" );
+void GraphicsLibrary::streamAssets()
+{
+    while( true ){
+        std::unique_lock< std::mutex > lock( prefetchMutex_ );
+        prefetchCondition_.wait( lock, [this](){
+            return stopPrefetching_ || !prefetchQueue_.empty();
+        });
+        if( stopPrefetching_ ){
+            return;
+        }
+        const PrefetchRequest request = prefetchQueue_.top();
+        prefetchQueue_.pop();
+        if( !request.group->retained || request.priority != request.group->priority ){
+            continue;
+        }
+        lock.unlock();
+
+        M2G_TRACE_SCOPE( "GraphicsLibrary::prefetch" );
+        try{
+            if( request.animation ){
+                getAnimationData( AnimationHandle( request.handleIndex ) );
+            }else{
+                getTileset( TilesetHandle( request.handleIndex ) );
+            }
+        }catch( std::exception& ){
+            std::lock_guard< std::mutex > failureLock( prefetchMutex_ );
+            request.group->nFailed++;
         }
     }
 }
 
+
+/***
+ * 12. Auxiliar validation methods
+ ***/
+
+std::vector< std::string > GraphicsLibrary::validateIndex( const LibraryIndex& index )
+{
+    std::vector< std::string > errors;
+    std::map< std::string, sf::Vector2u > imageSizes;
+
+    for( const TilesetDescriptor& tileset : index.tilesets() ){
+        validateTileset( tileset, index, imageSizes, errors );
+    }
+
+    for( const AnimationDescriptor& animation : index.animations() ){
+        const unsigned int nTiles = validateTileset( animation.tileset, index, imageSizes, errors );
+        if( nTiles == 0 ){
+            continue;
+        }
+        for( unsigned int i = 0; i < animation.states.size(); i++ ){
+            if( animation.states[i].lastFrame >= nTiles ){
+                errors.push_back( "Animation [" + animation.tileset.name + "] in library [" +
+                                  index.libraryPath() + "]: state " + std::to_string( i ) +
+                                  " ends at frame " + std::to_string( animation.states[i].lastFrame ) +
+                                  ", but the tileset has " + std::to_string( nTiles ) + " tiles" );
+            }
+        }
+    }
+
+    return errors;
+}
+
+
+unsigned int GraphicsLibrary::validateTileset( const TilesetDescriptor& descriptor,
+                                               const LibraryIndex& index,
+                                               std::map< std::string, sf::Vector2u >& imageSizes,
+                                               std::vector< std::string >& errors )
+{
+    const std::string prefix =
+            "Tileset [" + descriptor.name + "] in library [" + index.libraryPath() + "]: ";
+    const sf::Vector2u tileDimensions = descriptor.tileDimensions;
+    if( tileDimensions.x == 0 || tileDimensions.y == 0 ){
+        errors.push_back( prefix + "tile dimensions can't be 0" );
+        return 0;
+    }
+
+    sf::Vector2u size;
+    try{
+        const std::string path = imagePath( descriptor, index );
+        auto imageSize = imageSizes.find( path );
+        if( imageSize == imageSizes.end() ){
+            imageSize = imageSizes.insert( { path, readImageSize( path ) } ).first;
+        }
+        size = imageSize->second;
+    }catch( std::exception& e ){
+        errors.push_back( prefix + e.what() );
+        return 0;
+    }
+
+    if( descriptor.packed ){
+        const sf::IntRect& rect = descriptor.atlasRect;
+        if( rect.left < 0 || rect.top < 0 ||
+            static_cast< unsigned int >( rect.left + rect.width ) > size.x ||
+            static_cast< unsigned int >( rect.top + rect.height ) > size.y ){
+            errors.push_back( prefix + "atlas region out of the atlas page" );
+            return 0;
+        }
+        size = sf::Vector2u( rect.width, rect.height );
+    }
+
+    const std::size_t nErrors = errors.size();
+    if( tileDimensions.x > size.x || tileDimensions.y > size.y ){
+        errors.push_back( prefix + "tiles are bigger than the image" );
+    }else if( size.x % tileDimensions.x || size.y % tileDimensions.y ){
+        errors.push_back( prefix + "image dimensions (" + std::to_string( size.x ) + "x" +
+                          std::to_string( size.y ) + ") aren't a multiple of the tile ones (" +
+                          std::to_string( tileDimensions.x ) + "x" +
+                          std::to_string( tileDimensions.y ) + ")" );
+    }
+    if( errors.size() != nErrors ){
+        return 0;
+    }
+
+    const unsigned int nTiles = ( size.x / tileDimensions.x ) * ( size.y / tileDimensions.y );
+    for( const CollisionRectDescriptor& collisionRect : descriptor.collisionRects ){
+        if( !collisionRect.allTiles &&
+            ( collisionRect.firstTile > collisionRect.lastTile || collisionRect.lastTile >= nTiles ) ){
+            errors.push_back( prefix + "collision rect for tiles " +
+                              std::to_string( collisionRect.firstTile ) + "-" +
+                              std::to_string( collisionRect.lastTile ) + ", but the tileset has " +
+                              std::to_string( nTiles ) + " tiles" );
+        }
+    }
+
+    return nTiles;
+}
+
 } // namespace m2g
@@ -20,16 +20,70 @@
 #ifndef GRAPHICS_LIBRARY_HPP
 #define GRAPHICS_LIBRARY_HPP
 
-#include <tinyxml2.h>
 #include <string>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include "drawables/tileset.hpp"
 #include "drawables/animation_data.hpp"
+#include "utilities/cache_slot.hpp"
+#include "utilities/file_watcher.hpp"
+#include "asset_handle.hpp"
+#include "library_index.hpp"
 
 namespace m2g {
 
 typedef std::list< AnimationDataPtr > AnimationDataList;
 
+
+// Assets of a group already loaded (see GraphicsLibrary::prefetchGroup()).
+struct GroupProgress
+{
+    unsigned int nAssets;
+    unsigned int nLoaded;
+    unsigned int nFailed;
+};
+
+// The library file is indexed once, on construction (see LibraryIndex), and
+// its XML isn't kept. Libraries can include other libraries with
+// <include src="..."/> elements in their root (src is relative to the
+// including file); included files are indexed in parallel and merged into a
+// single name index. Repeated names throw std::runtime_error on
+// construction. Tilesets and animations are loaded from the index the
+// first time they are requested and cached; name getters return a copy of
+// the cached one (sharing its textures).
+//
+// Names can be resolved once into handles (see tilesetHandle()), which
+// index the library tables directly, so per-frame code can get assets
+// without hashing or comparing strings. The name API is built on them.
+//
+// Getters are thread-safe: the name index is immutable (hot reloading
+// replaces it as a whole), and every entry has its own cache slot, so
+// threads loading different assets don't block each other. When several
+// threads request the same asset, it is loaded only once. Setters aren't
+// thread-safe; call them before sharing the library between threads.
+//
+// With hot reloading enabled (see enableHotReload()), changes to the
+// library files and images are applied in place to the tilesets and
+// animations already returned, so live sprites and animations show them.
+//
+// Assets needed together (ie. by a level or a region of the world) can be
+// listed in groups, which are loaded by a background thread ahead of time
+// and released together:
+//
+// <group name="level_1">
+//     <tileset name="..."/>
+//     <animation name="..."/>
+// </group>
 class GraphicsLibrary
 {
     public:
@@ -37,36 +91,301 @@ class GraphicsLibrary
          * 1. Construction
          ***/
         GraphicsLibrary( const std::string& libraryPath );
+        GraphicsLibrary( const GraphicsLibrary& ) = delete;
+        GraphicsLibrary& operator = ( const GraphicsLibrary& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        // Waits for the asset being prefetched, if any.
+        ~GraphicsLibrary();
+
+
+        /***
+         * 3. Setters
+         ***/
+        // Tilesets not packed offline are loaded into the given atlas
+        // (nullptr for standalone textures). The atlas must outlive them.
+        // Allocations in the atlas are serialized by the library.
+        void setDynamicAtlas( DynamicAtlas* atlas );
+
+        // Load tilesets keeping a single copy of every distinct tile
+        // (see TilesetLoadOptions::deduplicateTiles).
+        void setTileDeduplication( bool deduplicateTiles );
+
+        // Drops the cached assets (assets already returned are kept alive
+        // by their owners). Setters call it, as cached assets may have been
+        // loaded with the old settings.
+        void clearCache();
+
+
+        /***
+         * 4. Getters
+         ***/
+        // Accumulated deduplication stats of all the tilesets loaded so far.
+        TileDeduplicationStats deduplicationStats() const;
 
 
         /***
-         * 2. Loading
+         * 5. Loading
          ***/
+        // Handles stay valid for the whole life of the library (also across
+        // hot reloads). Unknown names give invalid handles.
+        TilesetHandle tilesetHandle( const std::string& tilesetName ) const;
+        AnimationHandle animationHandle( const std::string& animDataName ) const;
+
+        // Return the cached asset itself (loading it if needed), shared with
+        // every other user, or nullptr if hot reloading removed the entry.
+        // Throw std::out_of_range if the handle isn't a handle of this
+        // library.
+        std::shared_ptr< const Tileset > getTileset( TilesetHandle handle );
+        std::shared_ptr< const AnimationData > getAnimationData( AnimationHandle handle );
+
         TilesetPtr getTilesetByName( const std::string& tilesetName );
         AnimationDataPtr getAnimationDataByName( const std::string& animDataName );
         AnimationDataList getAnimationDataByPrefix( const std::string& animDataName );
 
 
+        /***
+         * 6. Hot reloading
+         ***/
+        // Starts watching the library files and the images they reference
+        // (Linux only; throws std::runtime_error elsewhere).
+        void enableHotReload();
+
+        // Applies the changes made to the watched files since the previous
+        // call. Only the library files which changed are parsed again, and
+        // only the cached entries whose descriptor or image changed are
+        // reloaded. Reloads run in the background and are applied to the
+        // cached tilesets and animations (and so to every copy returned
+        // without own modifications) by a later call, once they are
+        // finished, so this never waits for images to load. Returns the
+        // number of entries updated in place.
+        //
+        // Meant to be called once per frame from the thread drawing the
+        // assets, while no other thread uses them. Throws std::runtime_error
+        // if a changed file can't be loaded; previous contents are kept and
+        // the file is tried again by the next call.
+        unsigned int pollChanges();
+
+
+        /***
+         * 7. Groups
+         ***/
+        // Queues the assets of the group to be loaded by a background
+        // thread. Assets of groups with higher priority are loaded first;
+        // prefetching a group again changes the priority of its assets not
+        // loaded yet. Prefetched assets stay cached until their group is
+        // released. Groups functions throw std::out_of_range for unknown
+        // groups.
+        void prefetchGroup( const std::string& groupName, unsigned int priority = 0 );
+        GroupProgress groupProgress( const std::string& groupName ) const;
+
+        // Stops prefetching the group and drops its assets from the cache,
+        // except the ones also listed by other prefetched groups. Assets
+        // still in use (ie. a copy or a shared pointer returned by a getter
+        // is alive) are kept until releaseUnusedAssets() is called after
+        // they are no longer used. Return the number of assets dropped.
+        unsigned int releaseGroup( const std::string& groupName );
+        unsigned int releaseUnusedAssets();
+
+
+        /***
+         * 8. Validation
+         ***/
+        // Checks the library and all the files it includes as the loaders
+        // would, but without decoding any image (image dimensions are read
+        // from their PNG headers), so it needs no graphics context. Files
+        // are checked in parallel. Returns every error found, so an empty
+        // list means the library is valid.
+        static std::vector< std::string > validate( const std::string& libraryPath );
+
+
     private:
+        typedef CacheSlot< Tileset > TilesetSlot;
+        typedef CacheSlot< AnimationData > AnimationSlot;
+
+        // Entries removed by hot reloading keep their handle and slot, with a
+        // null descriptor.
+        struct IndexedTileset
+        {
+            const TilesetDescriptor* descriptor;
+            const LibraryIndex* index;
+            std::shared_ptr< TilesetSlot > slot;
+        };
+
+        struct IndexedAnimation
+        {
+            const AnimationDescriptor* descriptor;
+            const LibraryIndex* index;
+            std::shared_ptr< AnimationSlot > slot;
+        };
+
+        typedef std::vector< std::shared_ptr< const LibraryIndex > > LibraryIndexes;
+
+        // Group entries, by handle index.
+        struct IndexedGroup
+        {
+            std::vector< unsigned int > tilesets;
+            std::vector< unsigned int > animations;
+        };
+
+        // Entries of the library file and all the files it includes (whose
+        // indexes it keeps alive), by handle index. Animations are also kept
+        // in file order for prefix searches.
+        struct NameIndex
+        {
+            LibraryIndexes indexes;
+            std::vector< IndexedTileset > tilesets;
+            std::vector< IndexedAnimation > animations;
+            std::unordered_map< std::string, unsigned int > tilesetHandles;
+            std::unordered_map< std::string, unsigned int > animationHandles;
+            std::vector< unsigned int > animationsInFileOrder;
+            std::unordered_map< std::string, IndexedGroup > groups;
+        };
+        typedef std::shared_ptr< const NameIndex > NameIndexPtr;
+
+        // Slots of a NameIndex, by handle index.
+        typedef std::vector< std::shared_ptr< TilesetSlot > > TilesetSlots;
+        typedef std::vector< std::shared_ptr< AnimationSlot > > AnimationSlots;
+
+        // Background load of the new version of a cached entry.
+        struct PendingReload
+        {
+            std::shared_ptr< TilesetSlot > tilesetSlot;
+            std::future< TilesetPtr > tileset;
+            std::shared_ptr< AnimationSlot > animDataSlot;
+            std::future< AnimationDataPtr > animData;
+
+            // A newer reload of the same entry was started.
+            bool superseded;
+        };
+
+        // Prefetching state of a group, guarded by prefetchMutex_.
+        struct GroupState
+        {
+            bool retained;
+            unsigned int priority;
+            unsigned int nFailed;
+        };
+
+        struct PrefetchRequest
+        {
+            unsigned int priority;
+            unsigned long long order;
+            bool animation;
+            unsigned int handleIndex;
+            std::shared_ptr< GroupState > group;
+
+            // Higher priority first, then first requested first.
+            bool operator < ( const PrefetchRequest& b ) const;
+        };
+
+
         /***
-         * 3. Auxiliar loading methods
+         * 9. Auxiliar loading methods
          ***/
-        void loadNameAndPath( tinyxml2::XMLElement* tileSetXML,
-                              std::string& name,
-                              std::string& path );
-        TilesetPtr loadTilesetFromXML( tinyxml2::XMLElement* tilesetXML );
-        AnimationDataPtr loadAnimationDataFromXML( tinyxml2::XMLElement* animDataXML );
+        // Files whose paths are in reusableIndexes aren't parsed again.
+        LibraryIndexes loadIndexes( const std::map< std::string, std::shared_ptr< const LibraryIndex > >& reusableIndexes ) const;
 
-        void loadCollisionRects( Tileset& tileset, tinyxml2::XMLElement* xmlElement );
-        std::string getDirPath( const std::string& path );
-        void loadAnimationDataStates( AnimationData& animData,
-                                      tinyxml2::XMLElement* statesNode );
+        // Entries keep the handles (and slots) they had in previousNames.
+        static NameIndexPtr indexLibrary( const LibraryIndexes& indexes,
+                                          const NameIndex* previousNames );
+
+        // Makes the slots of the entries added by names visible to the
+        // handle getters. Must be called before publishing names.
+        void publishSlots( const NameIndex& names );
+        TilesetPtr loadTileset( const TilesetDescriptor& descriptor,
+                                const LibraryIndex& index );
+        AnimationDataPtr loadAnimationData( const AnimationDescriptor& descriptor,
+                                            const LibraryIndex& index );
+        std::shared_ptr< const sf::Texture > loadAtlasPage( const LibraryIndex& index,
+                                                            unsigned int pageIndex );
+
+        // Image the tileset is loaded from (its atlas page if it is packed).
+        static std::string imagePath( const TilesetDescriptor& descriptor,
+                                      const LibraryIndex& index );
+
+
+        /***
+         * 10. Auxiliar hot reloading methods
+         ***/
+        void watchFiles( const NameIndex& names );
+        unsigned int applyFinishedReloads();
+        void scheduleReload( PendingReload reload );
+        static bool tilesetChanged( const TilesetDescriptor& oldDescriptor,
+                                    const LibraryIndex& oldIndex,
+                                    const TilesetDescriptor& newDescriptor,
+                                    const LibraryIndex& newIndex,
+                                    const std::set< std::string >& changedFiles );
+
+
+        /***
+         * 11. Auxiliar streaming methods
+         ***/
+        static const IndexedGroup& findGroup( const NameIndex& names,
+                                              const std::string& groupName );
+        void streamAssets();
+
+
+        /***
+         * 12. Auxiliar validation methods
+         ***/
+        static std::vector< std::string > validateIndex( const LibraryIndex& index );
+
+        // Returns the number of tiles of the tileset (0 if it isn't valid).
+        static unsigned int validateTileset( const TilesetDescriptor& descriptor,
+                                             const LibraryIndex& index,
+                                             std::map< std::string, sf::Vector2u >& imageSizes,
+                                             std::vector< std::string >& errors );
 
 
         /***
          * Attributes
          ***/
         std::string libraryPath_;
+        DynamicAtlas* dynamicAtlas_;
+        bool deduplicateTiles_;
+        TileDeduplicationStats deduplicationStats_;
+        mutable std::mutex deduplicationStatsMutex_;
+
+        // Read and replaced with std::atomic_load / std::atomic_store. Its
+        // slots cache the prototypes, modified in place by hot reloading.
+        NameIndexPtr nameIndex_;
+
+        // Slots read by the handle getters without locking nor touching
+        // nameIndex_. Slots never move, and a table is only replaced (by a
+        // longer one) when reindexing adds entries. Replaced tables are kept
+        // until destruction, as getters may still be reading them.
+        std::atomic< const TilesetSlots* > tilesetSlots_;
+        std::atomic< const AnimationSlots* > animationSlots_;
+        std::list< std::unique_ptr< const TilesetSlots > > tilesetSlotTables_;
+        std::list< std::unique_ptr< const AnimationSlots > > animationSlotTables_;
+
+        // Atlas pages (by path) are shared by all the tilesets packed into
+        // them and released when none of those tilesets is alive.
+        std::map< std::string, std::weak_ptr< const sf::Texture > > atlasPages_;
+        std::mutex atlasPagesMutex_;
+
+        // Hot reloading, only used by pollChanges().
+        std::unique_ptr< FileWatcher > fileWatcher_;
+        // Changed files not applied yet because indexing them failed; they
+        // are tried again by the next poll.
+        std::set< std::string > changedFiles_;
+        std::list< PendingReload > pendingReloads_;
+
+        // Groups streaming. Assets of released groups still in use wait in
+        // releasedTilesets_ / releasedAnimations_ (by handle index).
+        std::map< std::string, std::shared_ptr< GroupState > > groupStates_;
+        std::priority_queue< PrefetchRequest > prefetchQueue_;
+        unsigned long long nPrefetchRequests_;
+        std::set< unsigned int > releasedTilesets_;
+        std::set< unsigned int > releasedAnimations_;
+        mutable std::mutex prefetchMutex_;
+        std::condition_variable prefetchCondition_;
+        bool stopPrefetching_;
+        std::thread prefetchThread_;
 };
 
 } // namespace m2g
@@ -0,0 +1,421 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "library_index.hpp"
+#include "drawables/animation_data.hpp"
+#include "drawables/tileset.hpp"
+#include "utilities/trace.hpp"
+#include "utilities/stats.hpp"
+#include <tinyxml2.h>
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace m2g {
+
+/***
+ * Descriptors
+ ***/
+
+bool CollisionRectDescriptor::operator == ( const CollisionRectDescriptor& b ) const
+{
+    return rect == b.rect &&
+            allTiles == b.allTiles &&
+            ( allTiles || ( firstTile == b.firstTile && lastTile == b.lastTile ) ) &&
+            layers == b.layers;
+}
+
+
+bool TilesetDescriptor::operator == ( const TilesetDescriptor& b ) const
+{
+    return name == b.name &&
+            src == b.src &&
+            tileDimensions == b.tileDimensions &&
+            collisionRects == b.collisionRects &&
+            collisionCategory == b.collisionCategory &&
+            collisionMask == b.collisionMask &&
+            packed == b.packed &&
+            ( !packed || ( atlasPage == b.atlasPage && atlasRect == b.atlasRect ) );
+}
+
+
+bool AnimationDescriptor::operator == ( const AnimationDescriptor& b ) const
+{
+    return tileset == b.tileset &&
+            refreshRate == b.refreshRate &&
+            states == b.states;
+}
+
+
+/***
+ * LibraryIndexBuilder
+ ***/
+
+// Single pass over the library document, filling the index as elements are
+// entered and exited. Errors throw, unless they are being collected, in
+// which case the malformed entries are skipped.
+class LibraryIndexBuilder : public tinyxml2::XMLVisitor
+{
+    public:
+        LibraryIndexBuilder( LibraryIndex& index, std::vector< std::string >* errors ) :
+            index_( index ),
+            errors_( errors ),
+            entryFailed_( false )
+        {}
+
+
+        virtual bool VisitEnter( const tinyxml2::XMLElement& element,
+                                 const tinyxml2::XMLAttribute* )
+        {
+            const std::string name = element.Name();
+            const std::string parent = path_.empty() ? "" : path_.back();
+            path_.push_back( name );
+
+            if( parent.empty() ){
+                if( name != "library" ){
+                    fail( "No <library> element" );
+                    return false;
+                }
+            }else if( name == "tileset" && ( parent == "library" || parent == "animation" ) ){
+                if( parent == "library" ){
+                    entryFailed_ = false;
+                }
+                tileset_ = TilesetDescriptor();
+                tileset_.collisionCategory = DEFAULT_COLLISION_CATEGORY;
+                tileset_.collisionMask = ALL_COLLISION_CATEGORIES;
+                tileset_.packed = false;
+                tileset_.atlasPage = 0;
+                hasTileDimensions_ = false;
+            }else if( parent == "tileset" ){
+                readTilesetChild( element );
+            }else if( name == "collision_rect" && parent == "collision_rects" ){
+                tileset_.collisionRects.push_back( readCollisionRect( element ) );
+                if( !readBits( element, "layers", tileset_.collisionRects.back().layers ) ){
+                    fail( "Invalid collision rect layers in tileset [" + tileset_.src + "]" );
+                }
+            }else if( name == "animation" && parent == "library" ){
+                entryFailed_ = false;
+                animation_ = AnimationDescriptor();
+                animation_.refreshRate = DEFAULT_ANIMATION_REFRESH_RATE;
+                if( element.Attribute( "fps" ) != nullptr ){
+                    animation_.refreshRate = element.UnsignedAttribute( "fps" );
+                }
+            }else if( name == "animation_state" && parent == "animation_states" ){
+                try{
+                    animation_.states.push_back(
+                                AnimationState( element.UnsignedAttribute( "first_frame" ),
+                                                element.UnsignedAttribute( "last_frame" ),
+                                                element.UnsignedAttribute( "back_frame" ),
+                                                readTileTransform( element ) ) );
+                }catch( std::exception& e ){
+                    fail( "Animation [" + animation_.tileset.name + "]: " + e.what() );
+                }
+            }else if( name == "group" && parent == "library" ){
+                group_ = GroupDescriptor();
+                if( element.Attribute( "name" ) == nullptr ){
+                    fail( "<group> without name" );
+                }else{
+                    group_.name = element.Attribute( "name" );
+                }
+            }else if( ( name == "tileset" || name == "animation" ) && parent == "group" ){
+                if( element.Attribute( "name" ) == nullptr ){
+                    fail( "<" + name + "> without name in group [" + group_.name + "]" );
+                }else{
+                    ( name == "tileset" ? group_.tilesets : group_.animations ).push_back( element.Attribute( "name" ) );
+                }
+            }else if( name == "include" && parent == "library" ){
+                if( element.Attribute( "src" ) == nullptr ){
+                    fail( "<include> without src" );
+                }else{
+                    index_.includes_.push_back( element.Attribute( "src" ) );
+                }
+            }else if( name == "atlas_page" && parent == "library" ){
+                if( element.Attribute( "src" ) == nullptr ){
+                    fail( "<atlas_page> without src" );
+                }else{
+                    index_.atlasPages_[element.UnsignedAttribute( "index" )] = element.Attribute( "src" );
+                }
+            }
+
+            return true;
+        }
+
+
+        virtual bool VisitExit( const tinyxml2::XMLElement& element )
+        {
+            const std::string name = element.Name();
+            path_.pop_back();
+            const std::string parent = path_.empty() ? "" : path_.back();
+
+            if( name == "tileset" && ( parent == "library" || parent == "animation" ) ){
+                finishTileset();
+                if( parent == "animation" ){
+                    animation_.tileset = tileset_;
+                }else if( !entryFailed_ ){
+                    index_.tilesets_.push_back( tileset_ );
+                }
+            }else if( name == "animation" && parent == "library" && !entryFailed_ ){
+                index_.animations_.push_back( animation_ );
+            }else if( name == "group" && parent == "library" && !group_.name.empty() ){
+                index_.groups_.push_back( group_ );
+            }
+
+            return true;
+        }
+
+
+    private:
+        void fail( const std::string& message )
+        {
+            const std::string error = message + " in library [" + index_.libraryPath_ + "]";
+            if( errors_ == nullptr ){
+                throw std::runtime_error( error );
+            }
+            errors_->push_back( error );
+            entryFailed_ = true;
+        }
+
+
+        void readTilesetChild( const tinyxml2::XMLElement& element )
+        {
+            const std::string name = element.Name();
+
+            if( name == "name" || name == "src" ){
+                const std::string text = ( element.GetText() != nullptr ) ? element.GetText() : "";
+                ( name == "name" ? tileset_.name : tileset_.src ) = text;
+            }else if( name == "tile_dimensions" ){
+                tileset_.tileDimensions.x = element.UnsignedAttribute( "width" );
+                tileset_.tileDimensions.y = element.UnsignedAttribute( "height" );
+                hasTileDimensions_ = true;
+            }else if( name == "collision_filter" ){
+                if( !readBits( element, "category", tileset_.collisionCategory ) ||
+                        !readBits( element, "mask", tileset_.collisionMask ) ){
+                    fail( "Invalid <collision_filter> in tileset [" + tileset_.src + "]" );
+                }
+            }else if( name == "atlas" ){
+                tileset_.packed = true;
+                tileset_.atlasPage = element.UnsignedAttribute( "page" );
+                tileset_.atlasRect = sf::IntRect( element.UnsignedAttribute( "x" ),
+                                                  element.UnsignedAttribute( "y" ),
+                                                  element.UnsignedAttribute( "width" ),
+                                                  element.UnsignedAttribute( "height" ) );
+            }
+        }
+
+
+        void finishTileset()
+        {
+            if( tileset_.src.empty() ){
+                fail( "Tileset without <src>" );
+            }
+            if( !hasTileDimensions_ ){
+                fail( "Tileset [" + tileset_.src + "] without <tile_dimensions>" );
+            }
+
+            if( tileset_.name.empty() ){
+                // name = filename
+                size_t slashPos = tileset_.src.find_last_of( '/' );
+                if( slashPos != std::string::npos ){
+                    tileset_.name = tileset_.src.substr( slashPos + 1 );
+                }else{
+                    tileset_.name = tileset_.src;
+                }
+            }
+        }
+
+
+        static CollisionRectDescriptor readCollisionRect( const tinyxml2::XMLElement& element )
+        {
+            CollisionRectDescriptor collisionRect;
+            collisionRect.allTiles = false;
+            collisionRect.firstTile = collisionRect.lastTile = 0;
+            collisionRect.layers = ALL_COLLISION_CATEGORIES;
+
+            const std::string tilesStr =
+                    ( element.Attribute( "tiles" ) != nullptr ) ? element.Attribute( "tiles" ) : "";
+            if( tilesStr == "all" ){
+                collisionRect.allTiles = true;
+            }else{
+                std::size_t separatorPos = tilesStr.find( '-' );
+                if( separatorPos != std::string::npos ){
+                    collisionRect.firstTile = atoi( tilesStr.substr( 0, separatorPos ).c_str() );
+                    collisionRect.lastTile = atoi( tilesStr.substr( separatorPos + 1, tilesStr.size() ).c_str() );
+                }else{
+                    collisionRect.firstTile = collisionRect.lastTile = element.UnsignedAttribute( "tiles" );
+                }
+            }
+
+            collisionRect.rect.left = element.UnsignedAttribute( "x" );
+            collisionRect.rect.top = element.UnsignedAttribute( "y" );
+            collisionRect.rect.width = element.UnsignedAttribute( "width" );
+            collisionRect.rect.height = element.UnsignedAttribute( "height" );
+
+            return collisionRect;
+        }
+
+
+        // Reads a bit field written in decimal or hexadecimal (0x...). Leaves
+        // bits untouched if the attribute is missing, and returns false if
+        // it is malformed.
+        static bool readBits( const tinyxml2::XMLElement& element,
+                              const char* attribute,
+                              std::uint32_t& bits )
+        {
+            const char* text = element.Attribute( attribute );
+            if( text == nullptr ){
+                return true;
+            }
+
+            char* end = nullptr;
+            errno = 0;
+            const unsigned long value = std::strtoul( text, &end, 0 );
+            if( end == text || *end != '\0' || errno == ERANGE || value > 0xFFFFFFFFul ||
+                    text[0] == '-' ){
+                return false;
+            }
+            bits = static_cast< std::uint32_t >( value );
+            return true;
+        }
+
+
+        static TileTransform readTileTransform( const tinyxml2::XMLElement& element )
+        {
+            TileTransform transform = TILE_TRANSFORM_NONE;
+
+            // flip="horizontal | vertical | both", rotate="90"
+            if( element.Attribute( "flip" ) != nullptr ){
+                const std::string flip = element.Attribute( "flip" );
+                if( flip == "horizontal" ){
+                    transform |= TILE_FLIP_HORIZONTALLY;
+                }else if( flip == "vertical" ){
+                    transform |= TILE_FLIP_VERTICALLY;
+                }else if( flip == "both" ){
+                    transform |= TILE_FLIP_HORIZONTALLY | TILE_FLIP_VERTICALLY;
+                }else{
+                    throw std::runtime_error( "Invalid flip value [" + flip + "]" );
+                }
+            }
+            if( element.Attribute( "rotate" ) != nullptr ){
+                if( element.UnsignedAttribute( "rotate" ) == 90 ){
+                    transform |= TILE_ROTATE_90;
+                }else if( element.UnsignedAttribute( "rotate" ) != 0 ){
+                    throw std::runtime_error( "Only 90 degrees rotations are supported" );
+                }
+            }
+
+            return transform;
+        }
+
+
+        LibraryIndex& index_;
+        std::vector< std::string >* errors_;
+        bool entryFailed_;
+        std::vector< std::string > path_;
+        TilesetDescriptor tileset_;
+        bool hasTileDimensions_;
+        AnimationDescriptor animation_;
+        GroupDescriptor group_;
+};
+
+
+/***
+ * 1. Construction
+ ***/
+
+LibraryIndex::LibraryIndex( const std::string& libraryPath,
+                            std::vector< std::string >* errors ) :
+    libraryPath_( libraryPath )
+{
+    M2G_TRACE_SCOPE( "LibraryIndex::LibraryIndex" );
+
+    // The document only lives while the index is built.
+    tinyxml2::XMLDocument libraryFile;
+    {
+        M2G_TRACE_SCOPE( "LibraryIndex::parseXML" );
+        if( libraryFile.LoadFile( libraryPath_.c_str() ) != tinyxml2::XML_SUCCESS ){
+            const std::string error = "Couldn't load library [" + libraryPath_ + "]";
+            if( errors == nullptr ){
+                throw std::runtime_error( error );
+            }
+            errors->push_back( error );
+            return;
+        }
+        Stats::increment( STAT_LIBRARY_XML_PARSES );
+    }
+
+    if( libraryFile.FirstChildElement( "library" ) == nullptr ){
+        const std::string error = "Library [" + libraryPath_ + "] has no <library> element";
+        if( errors == nullptr ){
+            throw std::runtime_error( error );
+        }
+        errors->push_back( error );
+        return;
+    }
+
+    LibraryIndexBuilder builder( *this, errors );
+    libraryFile.FirstChildElement( "library" )->Accept( &builder );
+}
+
+
+/***
+ * 2. Getters
+ ***/
+
+const std::string& LibraryIndex::libraryPath() const
+{
+    return libraryPath_;
+}
+
+
+const std::vector< TilesetDescriptor >& LibraryIndex::tilesets() const
+{
+    return tilesets_;
+}
+
+
+const std::vector< AnimationDescriptor >& LibraryIndex::animations() const
+{
+    return animations_;
+}
+
+
+const std::vector< GroupDescriptor >& LibraryIndex::groups() const
+{
+    return groups_;
+}
+
+
+const std::vector< std::string >& LibraryIndex::includes() const
+{
+    return includes_;
+}
+
+
+const std::string& LibraryIndex::atlasPageSrc( unsigned int pageIndex ) const
+{
+    auto it = atlasPages_.find( pageIndex );
+    if( it == atlasPages_.end() ){
+        throw std::runtime_error( "Atlas page " +
+                                  std::to_string( pageIndex ) +
+                                  " not found in library" );
+    }
+    return it->second;
+}
+
+} // namespace m2g
@@ -0,0 +1,137 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef LIBRARY_INDEX_HPP
+#define LIBRARY_INDEX_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "drawables/animation_state.hpp"
+
+namespace m2g {
+
+struct CollisionRectDescriptor
+{
+    sf::IntRect rect;
+    unsigned int firstTile;
+    unsigned int lastTile;
+
+    // tiles="all" (the number of tiles isn't known until the image is
+    // loaded).
+    bool allTiles;
+
+    // layers attribute (see TilesetCollisionRect).
+    std::uint32_t layers;
+
+    bool operator == ( const CollisionRectDescriptor& b ) const;
+};
+
+
+// Everything needed to load a tileset, without the XML.
+struct TilesetDescriptor
+{
+    std::string name;
+    std::string src;
+    sf::Vector2u tileDimensions;
+    std::vector< CollisionRectDescriptor > collisionRects;
+    // <collision_filter> element.
+    std::uint32_t collisionCategory;
+    std::uint32_t collisionMask;
+
+    // Region of an offline packed atlas page (<atlas> element).
+    bool packed;
+    unsigned int atlasPage;
+    sf::IntRect atlasRect;
+
+    bool operator == ( const TilesetDescriptor& b ) const;
+};
+
+
+struct AnimationDescriptor
+{
+    TilesetDescriptor tileset;
+    unsigned int refreshRate;
+    std::vector< AnimationState > states;
+
+    bool operator == ( const AnimationDescriptor& b ) const;
+};
+
+
+// Named set of assets loaded and released together (ie. the assets of a
+// level), by entry name.
+struct GroupDescriptor
+{
+    std::string name;
+    std::vector< std::string > tilesets;
+    std::vector< std::string > animations;
+};
+
+
+// Compact index of a library file. The file is parsed and walked once by a
+// visitor which keeps only the descriptors above; the XML document is
+// released as soon as the index is built.
+class LibraryIndex
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        // Throws std::runtime_error if the file can't be loaded or it is
+        // malformed. If errors is given, every error is appended to it
+        // instead and malformed entries are left out of the index.
+        explicit LibraryIndex( const std::string& libraryPath,
+                               std::vector< std::string >* errors = nullptr );
+
+
+        /***
+         * 2. Getters
+         ***/
+        const std::string& libraryPath() const;
+        const std::vector< TilesetDescriptor >& tilesets() const;
+        const std::vector< AnimationDescriptor >& animations() const;
+        const std::vector< GroupDescriptor >& groups() const;
+
+        // src of the <include> elements, as written in the file.
+        const std::vector< std::string >& includes() const;
+
+        // Throws std::runtime_error if the library has no such page.
+        const std::string& atlasPageSrc( unsigned int pageIndex ) const;
+
+
+    private:
+        friend class LibraryIndexBuilder;
+
+
+        /***
+         * Attributes
+         ***/
+        std::string libraryPath_;
+        std::vector< TilesetDescriptor > tilesets_;
+        std::vector< AnimationDescriptor > animations_;
+        std::vector< GroupDescriptor > groups_;
+        std::map< unsigned int, std::string > atlasPages_;
+        std::vector< std::string > includes_;
+};
+
+} // namespace m2g
+
+#endif // LIBRARY_INDEX_HPP
@@ -0,0 +1,82 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../atlas_packer.hpp"
+#include "../graphics_library.hpp"
+
+namespace m2g {
+
+TEST_CASE( "AtlasPacker packs every distinct tileset image once" )
+{
+    AtlasPacker atlasPacker;
+
+    // All the tilesets in the test library share the same image.
+    REQUIRE( atlasPacker.pack( "data/test_graphics_library.xml",
+                               "data/packed_graphics_library.xml" ) == 1 );
+
+    sf::Image page;
+    REQUIRE( page.loadFromFile( "data/packed_graphics_library_atlas_0.png" ) );
+    REQUIRE( page.getSize() == sf::Vector2u( 64, 64 ) );
+}
+
+
+TEST_CASE( "Tilesets loaded from a packed library share their atlas page" )
+{
+    AtlasPacker atlasPacker;
+    atlasPacker.pack( "data/test_graphics_library.xml",
+                      "data/packed_graphics_library.xml" );
+    GraphicsLibrary graphicsLibrary( "data/packed_graphics_library.xml" );
+
+    TilesetPtr tileset1 =
+            graphicsLibrary.getTilesetByName( "Tileset64x64 - tile32x32" );
+    TilesetPtr tileset2 =
+            graphicsLibrary.getTilesetByName( "Tileset64x64 - tile64x16" );
+
+    REQUIRE( &( tileset1->texture() ) == &( tileset2->texture() ) );
+    REQUIRE( tileset1->dimensions() == sf::Vector2u( 64, 64 ) );
+    REQUIRE( tileset2->tileRect( 3 ) == sf::IntRect( 0, 48, 64, 16 ) );
+    REQUIRE( tileset2->collisionRects( 0 ).size() == 2 );
+}
+
+
+TEST_CASE( "Tileset::tileRect() is relative to the atlas region" )
+{
+    std::shared_ptr< sf::Texture > texture( new sf::Texture );
+    REQUIRE( texture->create( 128, 128 ) );
+
+    Tileset tileset( texture, sf::IntRect( 64, 32, 64, 64 ), 32, 32 );
+
+    REQUIRE( tileset.dimensions() == sf::Vector2u( 64, 64 ) );
+    REQUIRE( tileset.nTiles() == 4 );
+    REQUIRE( tileset.tileRect( 0 ) == sf::IntRect( 64, 32, 32, 32 ) );
+    REQUIRE( tileset.tileRect( 3 ) == sf::IntRect( 96, 64, 32, 32 ) );
+}
+
+
+TEST_CASE( "Tileset constructor throws if the atlas region is out of the texture" )
+{
+    std::shared_ptr< sf::Texture > texture( new sf::Texture );
+    REQUIRE( texture->create( 64, 64 ) );
+
+    REQUIRE_THROWS_AS( Tileset( texture, sf::IntRect( 32, 0, 64, 64 ), 32, 32 ),
+                       std::out_of_range );
+}
+
+} // namespace m2g
@@ -0,0 +1,257 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../collision/collision_world.hpp"
+#include "../../collision/sweep_and_prune.hpp"
+#include "../../utilities/stats.hpp"
+#include <stdexcept>
+
+namespace m2g {
+
+TEST_CASE( "CollisionWorld finds the same pairs than TileSprite::collide" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 4, 4, 24, 24 ) );
+
+    std::vector< TileSpritePtr > sprites;
+    for( unsigned int i = 0; i < 300; i++ ){
+        TileSpritePtr sprite( new TileSprite( tileset ) );
+        sprite->setPosition( ( i * 37 ) % 400, ( i * 91 ) % 400 );
+        sprites.push_back( std::move( sprite ) );
+    }
+
+    std::vector< CollisionPair > expectedPairs;
+    for( unsigned int i = 0; i < sprites.size(); i++ ){
+        for( unsigned int j = i + 1; j < sprites.size(); j++ ){
+            if( sprites[i]->collide( *sprites[j] ) ){
+                expectedPairs.push_back( CollisionPair{ i, j } );
+            }
+        }
+    }
+    REQUIRE( expectedPairs.size() > 0 );
+
+    // Same pairs, in the same order, whatever the number of threads and
+    // the broadphase.
+    const unsigned int nThreads[] = { 1, 2, 4 };
+    for( unsigned int n : nThreads ){
+        CollisionWorld world( n );
+        for( const TileSpritePtr& sprite : sprites ){
+            world.add( *sprite );
+        }
+        REQUIRE( world.findCollisions() == expectedPairs );
+
+        world.setBroadphase( BroadphasePtr( new SweepAndPrune ) );
+        REQUIRE( world.findCollisions() == expectedPairs );
+    }
+}
+
+
+TEST_CASE( "CollisionWorld follows the sprites it contains" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ) );
+    TileSprite a( tileset ), b( tileset ), c( tileset );
+    b.setPosition( 16, 16 );
+    c.setPosition( 100, 0 );
+
+    CollisionWorld world;
+    const unsigned int idA = world.add( a );
+    const unsigned int idB = world.add( b );
+    const unsigned int idC = world.add( c );
+    REQUIRE( world.size() == 3 );
+    REQUIRE( &( world.sprite( idB ) ) == &b );
+    REQUIRE_THROWS_AS( world.add( b ), std::invalid_argument );
+    REQUIRE( world.size() == 3 );
+
+    REQUIRE( world.findCollisions() == std::vector< CollisionPair >{ { idA, idB } } );
+
+    c.setPosition( 40, 40 );
+    REQUIRE( world.findCollisions() == std::vector< CollisionPair >{ { idA, idB }, { idB, idC } } );
+
+    world.remove( idA );
+    REQUIRE( !world.contains( idA ) );
+    REQUIRE_THROWS_AS( world.remove( idA ), std::out_of_range );
+    REQUIRE( world.findCollisions() == std::vector< CollisionPair >{ { idB, idC } } );
+
+    // Ids of removed sprites are reused.
+    REQUIRE( world.add( a ) == idA );
+}
+
+
+TEST_CASE( "CollisionWorld only tests again pairs whose sprites changed" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 16, 16 ), 0, 0 );
+    // L shaped tile.
+    tileset.addCollisionRect( sf::IntRect( 16, 0, 16, 4 ), 1, 1 );
+    tileset.addCollisionRect( sf::IntRect( 0, 16, 4, 16 ), 1, 1 );
+    TileSprite platform( tileset ), player( tileset ), trigger( tileset );
+    player.setPosition( 8, 8 );
+    trigger.setPosition( 500, 500 );
+
+    CollisionWorld world;
+    const unsigned int idPlatform = world.add( platform );
+    const unsigned int idPlayer = world.add( player );
+    world.add( trigger );
+
+    REQUIRE( world.findCollisions().size() == 1 );
+    REQUIRE( world.nNarrowphaseTests() == 1 );
+
+    // Nothing changed: the previous result is reused.
+    REQUIRE( world.findCollisions().size() == 1 );
+    REQUIRE( world.nNarrowphaseTests() == 0 );
+
+    // Boxes still overlap but the new tile's rects are away from the
+    // platform's one.
+    player.setTile( 1 );
+    REQUIRE( world.findCollisions().empty() );
+    REQUIRE( world.nNarrowphaseTests() == 1 );
+
+    // Moving a sprite far from the others needs no test at all.
+    trigger.move( 10, 0 );
+    REQUIRE( world.findCollisions().empty() );
+    REQUIRE( world.nNarrowphaseTests() == 0 );
+
+    // A new sprite in a reused id is always tested.
+    world.remove( idPlatform );
+    REQUIRE( world.add( platform ) == idPlatform );
+    player.setTile( 0 );
+    REQUIRE( world.findCollisions().size() == 1 );
+    REQUIRE( world.nNarrowphaseTests() == 1 );
+    REQUIRE( world.findCollisions().front() == CollisionPair{ idPlatform, idPlayer } );
+}
+
+
+TEST_CASE( "CollisionWorld accounts its narrowphase tests in the stats" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ) );
+    std::vector< TileSpritePtr > sprites;
+    CollisionWorld world( 4 );
+    for( unsigned int i = 0; i < 40; i++ ){
+        sprites.push_back( TileSpritePtr( new TileSprite( tileset ) ) );
+        sprites.back()->setPosition( i, i );
+        world.add( *( sprites.back() ) );
+    }
+
+    Stats::snapshot( true );
+    world.findCollisions();
+
+    REQUIRE( world.nNarrowphaseTests() > 0 );
+    REQUIRE( Stats::snapshot().counters[STAT_SPRITE_COLLIDES] == world.nNarrowphaseTests() );
+}
+
+
+TEST_CASE( "CollisionWorld reports contacts beginning, persisting and ending" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ) );
+    TileSprite a( tileset ), b( tileset ), c( tileset );
+    b.setPosition( 100, 0 );
+    c.setPosition( 16, 16 );
+
+    CollisionWorld world;
+    const unsigned int idA = world.add( a );
+    const unsigned int idB = world.add( b );
+    const unsigned int idC = world.add( c );
+    const CollisionPair ab{ idA, idB }, ac{ idA, idC };
+
+    world.findCollisions();
+    REQUIRE( world.begunContacts() == std::vector< CollisionPair >{ ac } );
+    REQUIRE( world.persistingContacts().empty() );
+    REQUIRE( world.endedContacts().empty() );
+
+    b.setPosition( 20, 0 );
+    world.findCollisions();
+    REQUIRE( world.begunContacts().size() == 2 );
+    REQUIRE( world.begunContacts().front() == ab );
+    REQUIRE( world.persistingContacts() == std::vector< CollisionPair >{ ac } );
+    REQUIRE( world.endedContacts().empty() );
+
+    b.setPosition( 100, 0 );
+    world.findCollisions();
+    REQUIRE( world.begunContacts().empty() );
+    REQUIRE( world.persistingContacts() == std::vector< CollisionPair >{ ac } );
+    REQUIRE( world.endedContacts().size() == 2 );
+    REQUIRE( world.endedContacts().front() == ab );
+
+    // Removing a sprite ends its contacts.
+    world.remove( idC );
+    world.findCollisions();
+    REQUIRE( world.persistingContacts().empty() );
+    REQUIRE( world.endedContacts() == std::vector< CollisionPair >{ ac } );
+}
+
+
+TEST_CASE( "CollisionWorld skips the pairs filtered out by collision filters" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ) );
+    TileSprite a( tileset ), b( tileset ), c( tileset );
+    b.setPosition( 8, 0 );
+    c.setPosition( 16, 0 );
+    c.setCollisionFilter( 0x2, 0x2 );
+
+    CollisionWorld world;
+    const unsigned int idA = world.add( a );
+    const unsigned int idB = world.add( b );
+    world.add( c );
+
+    REQUIRE( world.findCollisions() == std::vector< CollisionPair >{ { idA, idB } } );
+    REQUIRE( world.nNarrowphaseTests() == 1 );
+
+    // Changing a filter is seen as a change of the sprite.
+    c.useTilesetCollisionFilter();
+    REQUIRE( world.findCollisions().size() == 3 );
+}
+
+
+TEST_CASE( "CollisionWorld::sweep finds the first sprite hit by a fast one" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 4, 32 ) );
+    TileSprite bullet( tileset ), nearWall( tileset ), farWall( tileset ), offside( tileset );
+    nearWall.setPosition( 100, 0 );
+    farWall.setPosition( 200, 0 );
+    offside.setPosition( 150, 100 );
+
+    CollisionWorld world;
+    const unsigned int bulletId = world.add( bullet );
+    world.add( farWall );
+    const unsigned int nearWallId = world.add( nearWall );
+    world.add( offside );
+    REQUIRE( world.findCollisions().empty() );
+
+    const sf::Transform previousTransform = bullet.getTransform();
+    bullet.setPosition( 300, 0 );
+
+    unsigned int collider = bulletId;
+    SweepHit hit;
+    REQUIRE( world.sweep( bullet, previousTransform, collider, hit ) );
+    REQUIRE( collider == nearWallId );
+    REQUIRE( hit.time == Approx( 0.32f ) );
+
+    // Nothing in the way back to its previous position.
+    const sf::Transform farTransform = bullet.getTransform();
+    bullet.setPosition( 250, 0 );
+    REQUIRE( !world.sweep( bullet, farTransform, collider, hit ) );
+}
+
+} // namespace m2g
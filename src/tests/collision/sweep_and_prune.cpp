@@ -0,0 +1,174 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../collision/sweep_and_prune.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace m2g {
+
+// Pairs of the given colliders whose boxes intersect, found by brute force.
+std::vector< CollisionPair > overlappingPairs( const std::vector< sf::FloatRect >& boxes,
+                                               const std::vector< unsigned int >& colliders )
+{
+    std::vector< CollisionPair > pairs;
+    for( unsigned int i = 0; i < colliders.size(); i++ ){
+        for( unsigned int j = i + 1; j < colliders.size(); j++ ){
+            if( boxes[colliders[i]].intersects( boxes[colliders[j]] ) ){
+                pairs.push_back( CollisionPair{ std::min( colliders[i], colliders[j] ),
+                                                std::max( colliders[i], colliders[j] ) } );
+            }
+        }
+    }
+    std::sort( pairs.begin(), pairs.end() );
+    return pairs;
+}
+
+
+TEST_CASE( "SweepAndPrune finds every overlapping pair once while colliders move" )
+{
+    const SweepAxis axes[] = { SWEEP_AXIS_X, SWEEP_AXIS_Y };
+    for( SweepAxis axis : axes ){
+        SweepAndPrune sweepAndPrune( axis );
+        std::vector< sf::FloatRect > boxes;
+        for( unsigned int i = 0; i < 150; i++ ){
+            boxes.push_back( sf::FloatRect( ( i * 37 ) % 600, ( i * 91 ) % 200,
+                                            10 + i % 20, 10 + i % 15 ) );
+        }
+        // Touching boxes don't intersect.
+        boxes.push_back( sf::FloatRect( 1000, 1000, 10, 10 ) );
+        boxes.push_back( sf::FloatRect( 1010, 1000, 10, 10 ) );
+        boxes.push_back( sf::FloatRect( 1000, 1010, 10, 10 ) );
+
+        for( unsigned int frame = 0; frame < 20; frame++ ){
+            // Some colliders come and go.
+            std::vector< unsigned int > colliders;
+            for( unsigned int i = 0; i < boxes.size(); i++ ){
+                if( ( i + frame / 5 ) % 7 != 0 ){
+                    colliders.push_back( i );
+                }
+            }
+
+            sweepAndPrune.update( boxes, colliders );
+            std::vector< CollisionPair > pairs;
+            sweepAndPrune.findPairs( pairs );
+            std::sort( pairs.begin(), pairs.end() );
+            REQUIRE( pairs == overlappingPairs( boxes, colliders ) );
+
+            // Small motions.
+            for( unsigned int i = 0; i < 150; i++ ){
+                boxes[i].left += ( i % 3 ) * 2.0f - 2.0f;
+                boxes[i].top += ( i % 5 ) - 2.0f;
+            }
+        }
+    }
+}
+
+
+TEST_CASE( "SweepAndPrune handles negative sizes and NaN boxes" )
+{
+    const float INF = std::numeric_limits< float >::infinity();
+    const float NOT_A_NUMBER = std::numeric_limits< float >::quiet_NaN();
+    const SweepAxis axes[] = { SWEEP_AXIS_X, SWEEP_AXIS_Y };
+    for( SweepAxis axis : axes ){
+        SweepAndPrune sweepAndPrune( axis );
+        std::vector< sf::FloatRect > boxes;
+        std::vector< unsigned int > colliders;
+        for( unsigned int i = 0; i < 60; i++ ){
+            // Every third box is flipped.
+            const float sign = ( i % 3 == 0 ) ? -1.0f : 1.0f;
+            boxes.push_back( sf::FloatRect( ( i * 37 ) % 200, ( i * 91 ) % 200,
+                                            sign * ( 10 + i % 20 ), sign * ( 10 + i % 15 ) ) );
+            colliders.push_back( i );
+        }
+
+        for( unsigned int frame = 0; frame < 10; frame++ ){
+            sweepAndPrune.update( boxes, colliders );
+            std::vector< CollisionPair > pairs;
+            sweepAndPrune.findPairs( pairs );
+            std::sort( pairs.begin(), pairs.end() );
+            REQUIRE( pairs == overlappingPairs( boxes, colliders ) );
+
+            for( unsigned int i = 0; i < boxes.size(); i++ ){
+                boxes[i].left += ( i % 3 ) * 2.0f - 2.0f;
+                boxes[i].top += ( i % 5 ) - 2.0f;
+            }
+        }
+
+        // Intersections with NaN boxes aren't well defined, but they must not
+        // break the sweep.
+        const std::vector< CollisionPair > expectedPairs = overlappingPairs( boxes, colliders );
+        boxes.push_back( sf::FloatRect( NOT_A_NUMBER, NOT_A_NUMBER, 10.0f, 10.0f ) );
+        boxes.push_back( sf::FloatRect( INF, INF, -INF, -INF ) );
+        boxes.push_back( sf::FloatRect( 0.0f, 0.0f, NOT_A_NUMBER, NOT_A_NUMBER ) );
+        for( unsigned int i = 60; i < boxes.size(); i++ ){
+            colliders.push_back( i );
+        }
+        for( unsigned int frame = 0; frame < 2; frame++ ){
+            sweepAndPrune.update( boxes, colliders );
+            std::vector< CollisionPair > pairs;
+            sweepAndPrune.findPairs( pairs );
+            REQUIRE( pairs.size() >= expectedPairs.size() );
+
+            std::vector< unsigned int > found;
+            sweepAndPrune.query( sf::FloatRect( NOT_A_NUMBER, 0.0f, 10.0f, 10.0f ), found );
+            sweepAndPrune.query( sf::FloatRect( 200.0f, 200.0f, -100.0f, -100.0f ), found );
+        }
+    }
+}
+
+
+TEST_CASE( "SweepAndPrune barely reorders colliders which don't cross each other" )
+{
+    SweepAndPrune sweepAndPrune;
+    std::vector< sf::FloatRect > boxes;
+    std::vector< unsigned int > colliders;
+    for( unsigned int i = 0; i < 100; i++ ){
+        boxes.push_back( sf::FloatRect( i * 20.0f, 0.0f, 10.0f, 10.0f ) );
+        colliders.push_back( i );
+    }
+    sweepAndPrune.update( boxes, colliders );
+
+    for( sf::FloatRect& box : boxes ){
+        box.left += 5.0f;
+    }
+    sweepAndPrune.update( boxes, colliders );
+    REQUIRE( sweepAndPrune.nSwaps() == 0 );
+}
+
+
+TEST_CASE( "SweepAndPrune returns the colliders in an area" )
+{
+    SweepAndPrune sweepAndPrune( SWEEP_AXIS_Y );
+    const std::vector< sf::FloatRect > boxes =
+    {
+        sf::FloatRect( 0, 0, 10, 10 ),
+        sf::FloatRect( 50, 0, 10, 10 ),
+        sf::FloatRect( 0, 50, 10, 10 ),
+        sf::FloatRect( 5, 5, 10, 10 )
+    };
+    sweepAndPrune.update( boxes, std::vector< unsigned int >{ 0, 1, 2 } );
+
+    std::vector< unsigned int > colliders;
+    sweepAndPrune.query( sf::FloatRect( -5, -5, 20, 20 ), colliders );
+    REQUIRE( colliders == std::vector< unsigned int >{ 0 } );
+}
+
+} // namespace m2g
@@ -0,0 +1,173 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../collision/uniform_grid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace m2g {
+
+// Boxes of several sizes, some spanning many cells and some outside the
+// positive quadrant.
+std::vector< sf::FloatRect > generateBoxes()
+{
+    std::vector< sf::FloatRect > boxes;
+    for( unsigned int i = 0; i < 200; i++ ){
+        boxes.push_back( sf::FloatRect( static_cast< float >( ( i * 37 ) % 500 ) - 100.0f,
+                                        static_cast< float >( ( i * 91 ) % 500 ) - 100.0f,
+                                        5 + ( i * 13 ) % 150,
+                                        5 + ( i * 7 ) % 90 ) );
+    }
+    return boxes;
+}
+
+
+TEST_CASE( "UniformGrid finds every overlapping pair once" )
+{
+    const std::vector< sf::FloatRect > boxes = generateBoxes();
+    std::vector< unsigned int > colliders;
+    for( unsigned int i = 0; i < boxes.size(); i++ ){
+        // Ignored boxes.
+        if( i % 10 != 3 ){
+            colliders.push_back( i );
+        }
+    }
+
+    std::vector< CollisionPair > expectedPairs;
+    for( unsigned int i = 0; i < colliders.size(); i++ ){
+        for( unsigned int j = i + 1; j < colliders.size(); j++ ){
+            if( boxes[colliders[i]].intersects( boxes[colliders[j]] ) ){
+                expectedPairs.push_back( CollisionPair{ colliders[i], colliders[j] } );
+            }
+        }
+    }
+
+    const float cellSizes[] = { 16.0f, 64.0f, 1000.0f };
+    for( float cellSize : cellSizes ){
+        UniformGrid grid( cellSize );
+        grid.update( boxes, colliders );
+
+        std::vector< CollisionPair > pairs;
+        grid.findPairs( pairs );
+        std::sort( pairs.begin(), pairs.end() );
+        REQUIRE( pairs == expectedPairs );
+    }
+}
+
+
+TEST_CASE( "UniformGrid returns the colliders in an area once" )
+{
+    const std::vector< sf::FloatRect > boxes = generateBoxes();
+    std::vector< unsigned int > colliders;
+    for( unsigned int i = 0; i < boxes.size(); i++ ){
+        colliders.push_back( i );
+    }
+
+    UniformGrid grid( 32.0f );
+    grid.update( boxes, colliders );
+
+    const sf::FloatRect area( 50, -20, 120, 90 );
+    std::vector< unsigned int > expected;
+    for( unsigned int i = 0; i < boxes.size(); i++ ){
+        if( boxes[i].intersects( area ) ){
+            expected.push_back( i );
+        }
+    }
+
+    std::vector< unsigned int > found;
+    grid.query( area, found );
+    REQUIRE( found == expected );
+
+    // Colliders not given in the last update are forgotten.
+    grid.update( boxes, std::vector< unsigned int >() );
+    found.clear();
+    grid.query( area, found );
+    REQUIRE( found.empty() );
+}
+
+
+TEST_CASE( "UniformGrid handles huge, infinite and NaN boxes" )
+{
+    const float INF = std::numeric_limits< float >::infinity();
+    const float NOT_A_NUMBER = std::numeric_limits< float >::quiet_NaN();
+    std::vector< sf::FloatRect > boxes = generateBoxes();
+    boxes.push_back( sf::FloatRect( -1e30f, -1e30f, 2e30f, 2e30f ) );
+    boxes.push_back( sf::FloatRect( 0.0f, 0.0f, INF, 10.0f ) );
+    boxes.push_back( sf::FloatRect( 1e20f, 1e20f, 10.0f, 10.0f ) );
+    std::vector< unsigned int > colliders;
+    for( unsigned int i = 0; i < boxes.size(); i++ ){
+        colliders.push_back( i );
+    }
+
+    std::vector< CollisionPair > expectedPairs;
+    for( unsigned int i = 0; i < boxes.size(); i++ ){
+        for( unsigned int j = i + 1; j < boxes.size(); j++ ){
+            if( boxes[i].intersects( boxes[j] ) ){
+                expectedPairs.push_back( CollisionPair{ i, j } );
+            }
+        }
+    }
+
+    UniformGrid grid( 16.0f );
+    grid.update( boxes, colliders );
+
+    std::vector< CollisionPair > pairs;
+    grid.findPairs( pairs );
+    std::sort( pairs.begin(), pairs.end() );
+    REQUIRE( pairs == expectedPairs );
+
+    const sf::FloatRect areas[] = {
+        sf::FloatRect( -1e25f, -1e25f, 2e25f, 2e25f ),
+        sf::FloatRect( 50.0f, -20.0f, INF, 90.0f )
+    };
+    for( const sf::FloatRect& area : areas ){
+        std::vector< unsigned int > expected;
+        for( unsigned int i = 0; i < boxes.size(); i++ ){
+            if( boxes[i].intersects( area ) ){
+                expected.push_back( i );
+            }
+        }
+
+        std::vector< unsigned int > found;
+        grid.query( area, found );
+        REQUIRE( found == expected );
+    }
+
+    // Intersections with NaN boxes aren't well defined, but they must not
+    // break the grid.
+    boxes.push_back( sf::FloatRect( NOT_A_NUMBER, 0.0f, 10.0f, 10.0f ) );
+    colliders.push_back( boxes.size() - 1 );
+    grid.update( boxes, colliders );
+    pairs.clear();
+    grid.findPairs( pairs );
+    std::vector< unsigned int > found;
+    grid.query( sf::FloatRect( NOT_A_NUMBER, NOT_A_NUMBER, 10.0f, 10.0f ), found );
+    REQUIRE( pairs.size() >= expectedPairs.size() );
+}
+
+
+TEST_CASE( "UniformGrid rejects non positive cell sizes" )
+{
+    REQUIRE_THROWS_AS( UniformGrid( 0.0f ), std::invalid_argument );
+}
+
+} // namespace m2g
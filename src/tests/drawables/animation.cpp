@@ -295,4 +295,42 @@ TEST_CASE( "An animation can be time-updated" )
 }
 
 
+TEST_CASE( "Animation applies the tile transform of its current state" )
+{
+    const Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    AnimationData animData( tileset );
+    animData.addState( AnimationState( 0, 3 ) );
+    animData.addState( AnimationState( 0, 3, 0, TILE_FLIP_HORIZONTALLY ) );
+
+    Animation animation( animData );
+    REQUIRE( animation.tileTransform() == TILE_TRANSFORM_NONE );
+
+    animation.setState( 1 );
+    REQUIRE( animation.tileTransform() == TILE_FLIP_HORIZONTALLY );
+
+    animation.setState( 0 );
+    REQUIRE( animation.tileTransform() == TILE_TRANSFORM_NONE );
+}
+
+
+
+TEST_CASE( "Animation keeps a valid state when its AnimationData is reloaded" )
+{
+    AnimationData animData(
+                TilesetPtr( new Tileset( "./data/tileset_w64_h64.png", 32, 32 ) ), 10 );
+    animData.addState( AnimationState( 0, 1 ) );
+    animData.addState( AnimationState( 2, 3 ) );
+    Animation animation( animData );
+    animation.setState( 1 );
+
+    AnimationData newAnimData(
+                TilesetPtr( new Tileset( "./data/tileset_w64_h64.png", 32, 32 ) ), 10 );
+    newAnimData.addState( AnimationState( 1, 2 ) );
+    animData.reload( newAnimData );
+    animation.update( 0 );
+
+    REQUIRE( animation.currentState() == 0 );
+    REQUIRE( animation.currentFrame() == 1 );
+}
+
 } // namespace m2g
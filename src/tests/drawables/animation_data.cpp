@@ -113,4 +113,28 @@ TEST_CASE( "Animation states management" )
     }
 }
 
+
+
+TEST_CASE( "Reloading an AnimationData updates its copies and their tilesets" )
+{
+    AnimationData animData(
+                TilesetPtr( new Tileset( "./data/tileset_w64_h64.png", 32, 32 ) ), 10 );
+    animData.addState( AnimationState( 0, 3 ) );
+    AnimationData copy( animData );
+
+    AnimationData newAnimData(
+                TilesetPtr( new Tileset( "./data/tileset_w64_h64.png", 64, 16 ) ), 20 );
+    newAnimData.addState( AnimationState( 0, 1 ) );
+    newAnimData.addState( AnimationState( 2, 3 ) );
+    const unsigned int revision = copy.revision();
+
+    animData.reload( newAnimData );
+
+    REQUIRE( copy.revision() != revision );
+    REQUIRE( copy.refreshRate() == 20 );
+    REQUIRE( copy.nStates() == 2 );
+    REQUIRE( copy.state( 1 ) == AnimationState( 2, 3 ) );
+    REQUIRE( copy.tileset().tileDimensions() == sf::Vector2u( 64, 16 ) );
+}
+
 } // namespace m2g
@@ -91,4 +91,24 @@ TEST_CASE( "Equality tests" )
     REQUIRE( !( animStateA1 == animStateD ) );
 }
 
+TEST_CASE( "AnimationState has no tile transform unless otherwise specified" )
+{
+    REQUIRE( AnimationState( 1, 3 ).tileTransform == TILE_TRANSFORM_NONE );
+    REQUIRE( AnimationState( 1, 3, 2 ).tileTransform == TILE_TRANSFORM_NONE );
+    REQUIRE( AnimationState( 1, 3, 2, TILE_ROTATE_90 ).tileTransform == TILE_ROTATE_90 );
+}
+
+
+TEST_CASE( "AnimationStates with different tile transforms are different" )
+{
+    REQUIRE( !( AnimationState( 1, 3, 2 ) ==
+                AnimationState( 1, 3, 2, TILE_FLIP_VERTICALLY ) ) );
+}
+
+
+TEST_CASE( "AnimationState's constructor throws with an invalid tile transform" )
+{
+    REQUIRE_THROWS_AS( AnimationState( 1, 3, 2, 8 ), std::invalid_argument );
+}
+
 } // namespace m2g
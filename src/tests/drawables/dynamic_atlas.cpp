@@ -0,0 +1,123 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../drawables/tileset.hpp"
+#include "../../drawables/tile_sprite.hpp"
+#include <thread>
+#include <vector>
+
+namespace m2g {
+
+TEST_CASE( "Tilesets constructed into a DynamicAtlas share its page" )
+{
+    DynamicAtlas atlas( 256 );
+
+    Tileset tileset1( atlas, "./data/tileset_w64_h64.png", 32, 32 );
+    Tileset tileset2( atlas, "./data/test_tileset.png", 32, 64 );
+
+    REQUIRE( atlas.nPages() == 1 );
+    REQUIRE( &( tileset1.texture() ) == &( tileset2.texture() ) );
+    REQUIRE( tileset1.dimensions() == sf::Vector2u( 64, 64 ) );
+    REQUIRE( tileset2.dimensions() == sf::Vector2u( 256, 128 ) );
+    REQUIRE( tileset1.region().intersects( tileset2.region() ) == false );
+}
+
+
+TEST_CASE( "Tileset rects in a DynamicAtlas are relative to the page" )
+{
+    DynamicAtlas atlas( 256 );
+    Tileset tileset( atlas, "./data/tileset_w64_h64.png", 32, 32 );
+    const sf::IntRect region = tileset.region();
+
+    REQUIRE( tileset.tileRect( 3 ) ==
+             sf::IntRect( region.left + 32, region.top + 32, 32, 32 ) );
+}
+
+
+TEST_CASE( "Destroying a Tileset gives its region back to the DynamicAtlas" )
+{
+    DynamicAtlas atlas( 128 );
+
+    {
+        Tileset tileset( atlas, "./data/tileset_w64_h64.png", 32, 32 );
+        REQUIRE( atlas.usedArea( 0 ) > 0 );
+    }
+
+    REQUIRE( atlas.usedArea( 0 ) == 0 );
+}
+
+
+TEST_CASE( "DynamicAtlas opens a new page when the current one is full" )
+{
+    DynamicAtlas atlas( 64, 0 );
+
+    Tileset tileset1( atlas, "./data/tileset_w64_h64.png", 32, 32 );
+    Tileset tileset2( atlas, "./data/tileset_w64_h64.png", 32, 32 );
+
+    REQUIRE( atlas.nPages() == 2 );
+    REQUIRE( &( tileset1.texture() ) != &( tileset2.texture() ) );
+}
+
+
+TEST_CASE( "DynamicAtlas rejects images bigger than its pages" )
+{
+    DynamicAtlas atlas( 32 );
+
+    REQUIRE_THROWS_AS( Tileset( atlas, "./data/tileset_w64_h64.png", 32, 32 ),
+                       std::invalid_argument );
+}
+
+
+TEST_CASE( "DynamicAtlas regions can be allocated and released from several threads" )
+{
+    DynamicAtlas atlas( 128 );
+    sf::Image image;
+    REQUIRE( image.loadFromFile( "./data/tileset_w64_h64.png" ) );
+
+    std::vector< std::thread > threads;
+    for( unsigned int i = 0; i < 4; i++ ){
+        threads.emplace_back( [&](){
+            for( unsigned int j = 0; j < 50; j++ ){
+                Tileset tileset( atlas, image, 32, 32 );
+            }
+        });
+    }
+    for( std::thread& thread : threads ){
+        thread.join();
+    }
+
+    for( unsigned int page = 0; page < atlas.nPages(); page++ ){
+        REQUIRE( atlas.usedArea( page ) == 0 );
+    }
+}
+
+
+TEST_CASE( "TileSprite draws from a DynamicAtlas tileset" )
+{
+    DynamicAtlas atlas( 256 );
+    Tileset tileset( atlas, "./data/tileset_w64_h64.png", 32, 32 );
+    TileSprite sprite( tileset );
+
+    sprite.setTile( 1 );
+
+    REQUIRE( &( sprite.tileset().texture() ) == atlas.page( 0 ).get() );
+}
+
+} // namespace m2g
@@ -0,0 +1,160 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../drawables/sprite_store.hpp"
+#include "../drawables/tile_sprite.hpp"
+#include <stdexcept>
+#include <algorithm>
+
+namespace m2g {
+
+TEST_CASE( "Sprite handles become invalid when their sprite is destroyed" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    SpriteStore store;
+    const unsigned int tilesetId = store.addTileset( tileset );
+
+    const SpriteHandle a = store.create( tilesetId, 1, sf::Vector2f( 10.0f, 20.0f ) );
+    const SpriteHandle b = store.create( tilesetId, 2 );
+    REQUIRE( store.size() == 2 );
+    REQUIRE( store.valid( a ) );
+    REQUIRE( store.valid( b ) );
+
+    store.destroy( a );
+    REQUIRE( store.size() == 1 );
+    REQUIRE( !store.valid( a ) );
+    REQUIRE_THROWS_AS( store.position( a ), std::out_of_range );
+    REQUIRE_THROWS_AS( store.destroy( a ), std::out_of_range );
+
+    // The sprite moved to fill the gap keeps its data.
+    REQUIRE( store.valid( b ) );
+    REQUIRE( store.tile( b ) == 2 );
+    REQUIRE( store.denseIndex( b ) == 0 );
+    REQUIRE( store.handle( 0 ) == b );
+
+    // A new sprite reusing the slot doesn't revive old handles.
+    const SpriteHandle c = store.create( tilesetId, 3 );
+    REQUIRE( c.index == a.index );
+    REQUIRE( c != a );
+    REQUIRE( !store.valid( a ) );
+    REQUIRE( store.tile( c ) == 3 );
+
+    store.clear();
+    REQUIRE( store.size() == 0 );
+    REQUIRE( !store.valid( b ) );
+    REQUIRE( !store.valid( c ) );
+}
+
+
+TEST_CASE( "Sprite store rejects tiles and tilesets out of range" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    SpriteStore store;
+    const unsigned int tilesetId = store.addTileset( tileset );
+
+    REQUIRE_THROWS_AS( store.create( tilesetId + 1 ), std::out_of_range );
+    REQUIRE_THROWS_AS( store.create( tilesetId, tileset.nTiles() ), std::out_of_range );
+
+    const SpriteHandle sprite = store.create( tilesetId );
+    REQUIRE_THROWS_AS( store.setTile( sprite, tileset.nTiles() ), std::out_of_range );
+}
+
+
+TEST_CASE( "Sprite store computes the same boundary boxes as TileSprite" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    SpriteStore store;
+    const unsigned int tilesetId = store.addTileset( tileset );
+    TileSprite tileSprite( tileset );
+    const SpriteHandle sprite = store.create( tilesetId );
+
+    const float rotations[] = { 0.0f, 30.0f, 90.0f, 200.0f };
+    for( float rotation : rotations ){
+        tileSprite.setPosition( 15.0f, -7.0f );
+        tileSprite.setScale( 2.0f, -0.5f );
+        tileSprite.setRotation( rotation );
+        store.setPosition( sprite, sf::Vector2f( 15.0f, -7.0f ) );
+        store.setScale( sprite, sf::Vector2f( 2.0f, -0.5f ) );
+        store.setRotation( sprite, rotation );
+        store.updateBounds();
+
+        const sf::FloatRect expected = tileSprite.getBoundaryBox();
+        const sf::FloatRect bounds = store.boundaryBox( sprite );
+        REQUIRE( bounds.left == Approx( expected.left ) );
+        REQUIRE( bounds.top == Approx( expected.top ) );
+        REQUIRE( bounds.width == Approx( expected.width ) );
+        REQUIRE( bounds.height == Approx( expected.height ) );
+    }
+}
+
+
+TEST_CASE( "Sprite store culls sprites outside the given area" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    SpriteStore store;
+    const unsigned int tilesetId = store.addTileset( tileset );
+
+    const SpriteHandle inside = store.create( tilesetId, 0, sf::Vector2f( 10.0f, 10.0f ) );
+    const SpriteHandle partiallyInside = store.create( tilesetId, 0, sf::Vector2f( -16.0f, 50.0f ) );
+    store.create( tilesetId, 0, sf::Vector2f( 200.0f, 10.0f ) );
+
+    // Moved into the area in bulk.
+    const SpriteHandle moved = store.create( tilesetId, 0, sf::Vector2f( 500.0f, 500.0f ) );
+    std::vector< float > offsetsX( store.size(), 0.0f );
+    std::vector< float > offsetsY( store.size(), 0.0f );
+    offsetsX[store.denseIndex( moved )] = -450.0f;
+    offsetsY[store.denseIndex( moved )] = -450.0f;
+    store.move( offsetsX.data(), offsetsY.data() );
+    store.updateBounds();
+
+    std::vector< SpriteHandle > visibleSprites;
+    store.cull( sf::FloatRect( 0.0f, 0.0f, 100.0f, 100.0f ), visibleSprites );
+
+    REQUIRE( visibleSprites.size() == 3 );
+    REQUIRE( std::count( visibleSprites.begin(), visibleSprites.end(), inside ) == 1 );
+    REQUIRE( std::count( visibleSprites.begin(), visibleSprites.end(), partiallyInside ) == 1 );
+    REQUIRE( std::count( visibleSprites.begin(), visibleSprites.end(), moved ) == 1 );
+}
+
+
+TEST_CASE( "Sprite store finds collisions through collision rects" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 8, 8, 16, 16 ) );
+    SpriteStore store;
+    const unsigned int tilesetId = store.addTileset( tileset );
+
+    const SpriteHandle player = store.create( tilesetId, 0, sf::Vector2f( 0.0f, 0.0f ) );
+    const SpriteHandle hit = store.create( tilesetId, 0, sf::Vector2f( 10.0f, 10.0f ) );
+    // Boundary boxes overlap, collision rects don't.
+    const SpriteHandle nearMiss = store.create( tilesetId, 0, sf::Vector2f( 20.0f, 0.0f ) );
+    store.create( tilesetId, 0, sf::Vector2f( 300.0f, 300.0f ) );
+    store.updateBounds();
+
+    REQUIRE( store.collide( player, hit ) );
+    REQUIRE( !store.collide( player, nearMiss ) );
+
+    std::vector< SpriteHandle > collisions;
+    store.findCollisions( player, collisions );
+    REQUIRE( collisions.size() == 1 );
+    REQUIRE( collisions[0] == hit );
+}
+
+} // namespace m2g
@@ -0,0 +1,130 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../drawables/tile_layer.hpp"
+#include <limits>
+#include <stdexcept>
+
+namespace m2g {
+
+TEST_CASE( "TileLayer keeps a tile per cell" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    TileLayer layer( tileset, 10, 5 );
+    REQUIRE( layer.nColumns() == 10 );
+    REQUIRE( layer.nRows() == 5 );
+    REQUIRE( layer.tile( 9, 4 ) == NO_TILE );
+
+    layer.setTile( 9, 4, 3 );
+    REQUIRE( layer.tile( 9, 4 ) == 3 );
+    REQUIRE_THROWS_AS( layer.setTile( 10, 0, 0 ), std::out_of_range );
+    REQUIRE_THROWS_AS( layer.setTile( 0, 0, 4 ), std::out_of_range );
+
+    layer.setPosition( sf::Vector2f( 100, 50 ) );
+    REQUIRE( layer.bounds() == sf::FloatRect( 100, 50, 320, 160 ) );
+}
+
+
+TEST_CASE( "TileLayer collides with the rects of the tiles in the overlapped cells" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 16, 32, 16 ), 1, 1 );
+
+    TileLayer layer( tileset, 100, 100 );
+    layer.setPosition( sf::Vector2f( -320, 0 ) );
+    layer.setTile( 10, 2, 1 );
+    layer.setTile( 11, 2, 1 );
+    layer.setTile( 12, 2, 0 );
+
+    // Lower half of cells (10, 2) and (11, 2).
+    REQUIRE( layer.collide( sf::FloatRect( 10, 80, 4, 4 ) ) );
+    REQUIRE( !layer.collide( sf::FloatRect( 10, 70, 4, 4 ) ) );
+    REQUIRE( !layer.collide( sf::FloatRect( 70, 80, 4, 4 ) ) );
+    REQUIRE( !layer.collide( sf::FloatRect( -1000, -1000, 10, 10 ) ) );
+
+    std::vector< sf::Vector2u > cells;
+    layer.findCollisions( sf::FloatRect( -10, 90, 100, 100 ), cells );
+    REQUIRE( cells == std::vector< sf::Vector2u >{ { 10, 2 }, { 11, 2 } } );
+
+    // Collision rects added later are seen too.
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ), 0, 0 );
+    REQUIRE( layer.collide( sf::FloatRect( 70, 70, 4, 4 ) ) );
+}
+
+
+TEST_CASE( "TileLayer clamps huge, infinite and NaN areas to its cells" )
+{
+    const float INF = std::numeric_limits< float >::infinity();
+    const float NOT_A_NUMBER = std::numeric_limits< float >::quiet_NaN();
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 16, 32, 16 ), 1, 1 );
+
+    TileLayer layer( tileset, 100, 100 );
+    layer.setTile( 10, 2, 1 );
+
+    REQUIRE( layer.collide( sf::FloatRect( -1e30f, -1e30f, 2e30f, 2e30f ) ) );
+    REQUIRE( layer.collide( sf::FloatRect( 0.0f, 0.0f, INF, INF ) ) );
+    REQUIRE( !layer.collide( sf::FloatRect( 1e30f, 1e30f, 10.0f, 10.0f ) ) );
+    REQUIRE( !layer.collide( sf::FloatRect( NOT_A_NUMBER, 0.0f, 10.0f, 10.0f ) ) );
+
+    std::vector< sf::Vector2u > cells;
+    layer.findCollisions( sf::FloatRect( -INF, 0.0f, INF, 1e30f ), cells );
+    layer.findCollisions( sf::FloatRect( 0.0f, 0.0f, 1e30f, 1e30f ), cells );
+    REQUIRE( cells == std::vector< sf::Vector2u >{ { 10, 2 } } );
+}
+
+
+TEST_CASE( "TileLayer follows the collision filter of its tileset" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ) );
+    tileset.setCollisionFilter( 0x1, 0x2 );
+    TileLayer layer( tileset, 4, 4 );
+    layer.setTile( 0, 0, 0 );
+
+    TileSprite actor( tileset );
+    actor.setPosition( 16, 16 );
+    REQUIRE( !layer.collide( actor ) );
+
+    actor.setCollisionFilter( 0x2, 0x1 );
+    REQUIRE( layer.collide( actor ) );
+    REQUIRE( !layer.collide( actor.getBoundaryBox(), 0x2 ) );
+}
+
+
+TEST_CASE( "TileLayer::sweep finds the first cell hit by a moving rect" )
+{
+    Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ) );
+    TileLayer layer( tileset, 20, 20 );
+    layer.setTile( 5, 0, 0 );
+    layer.setTile( 15, 0, 0 );
+
+    sf::Vector2u cell;
+    SweepHit hit;
+    REQUIRE( layer.sweep( sf::FloatRect( 0, 8, 16, 16 ), sf::Vector2f( 600, 0 ), cell, hit ) );
+    REQUIRE( cell == sf::Vector2u( 5, 0 ) );
+    REQUIRE( hit.time == Approx( 0.24f ) );
+    REQUIRE( hit.normal == sf::Vector2f( -1, 0 ) );
+
+    REQUIRE( !layer.sweep( sf::FloatRect( 0, 40, 16, 16 ), sf::Vector2f( 600, 0 ), cell, hit ) );
+}
+
+} // namespace m2g
@@ -151,6 +151,116 @@ TEST_CASE( "Rotating one sprite next to another makes them both collide" )
 }
 
 
+TEST_CASE( "Sprites only collide when their collision filters match" )
+{
+    m2g::Tileset players( "./data/tileset_w64_h64.png", 32, 32 );
+    m2g::Tileset bullets( "./data/tileset_w64_h64.png", 32, 32 );
+    players.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ) );
+    bullets.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ) );
+
+    // Bullets hit players, but not other bullets.
+    players.setCollisionFilter( 0x1, 0x2 );
+    bullets.setCollisionFilter( 0x2, 0x1 );
+
+    m2g::TileSprite player( players );
+    m2g::TileSprite bullet1( bullets );
+    m2g::TileSprite bullet2( bullets );
+    REQUIRE( player.collide( bullet1 ) == true );
+    REQUIRE( bullet1.collide( player ) == true );
+    REQUIRE( bullet1.collide( bullet2 ) == false );
+
+    // A sprite can override the filter of its tileset.
+    bullet2.setCollisionFilter( 0x2, 0x3 );
+    REQUIRE( bullet1.collide( bullet2 ) == false );
+    bullet1.setCollisionFilter( 0x2, 0x3 );
+    REQUIRE( bullet1.collide( bullet2 ) == true );
+    bullet1.useTilesetCollisionFilter();
+    REQUIRE( bullet1.collisionMask() == 0x1 );
+    REQUIRE( bullet1.collide( bullet2 ) == false );
+}
+
+
+TEST_CASE( "Collision rects can belong to their own collision layers" )
+{
+    // Tile with a small hurt box inside a bigger hit box.
+    m2g::Tileset fighters( "./data/tileset_w64_h64.png", 32, 32 );
+    fighters.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ), 0, 0, 0x1 );
+    fighters.addCollisionRect( sf::IntRect( 12, 12, 8, 8 ), 0, 0, 0x2 );
+    fighters.setCollisionFilter( 0x3, 0x3 );
+
+    m2g::TileSprite fighter( fighters );
+    m2g::TileSprite hit( fighters );
+    hit.setCollisionFilter( 0x1, 0x2 );
+
+    // The hit box only collides with the hurt box.
+    hit.setPosition( 24, 0 );
+    REQUIRE( fighter.collide( hit ) == false );
+    REQUIRE( hit.collide( fighter ) == false );
+    hit.setPosition( 16, 0 );
+    REQUIRE( fighter.collide( hit ) == true );
+    REQUIRE( hit.collide( fighter ) == true );
+}
+
+
+TEST_CASE( "Oriented collision tests rotated sprites with their rotated rects" )
+{
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 32, 32 ) );
+
+    // Rotated 45 degrees around its center, so the corners of its bounds
+    // are out of the sprite.
+    m2g::TileSprite projectile( tileset );
+    projectile.setOrigin( 16, 16 );
+    projectile.setPosition( 16, 16 );
+    projectile.setRotation( 45 );
+
+    m2g::TileSprite corner( tileset );
+    corner.setPosition( -30, -30 );
+    REQUIRE( projectile.collide( corner ) == true );
+
+    projectile.setOrientedCollision( true );
+    REQUIRE( projectile.collide( corner ) == false );
+    REQUIRE( corner.collide( projectile ) == false );
+
+    // Still colliding with what the rotated sprite covers.
+    corner.setPosition( -16, 0 );
+    REQUIRE( projectile.collide( corner ) == true );
+    REQUIRE( corner.collide( projectile ) == true );
+}
+
+
+TEST_CASE( "TileSprite::sweep finds sprites skipped between frames" )
+{
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 12, 12, 8, 8 ) );
+
+    m2g::TileSprite bullet( tileset );
+    m2g::TileSprite wall( tileset );
+    wall.setPosition( 100, 0 );
+
+    // The bullet jumps over the wall.
+    const sf::Transform previousTransform = bullet.getTransform();
+    bullet.setPosition( 200, 0 );
+    REQUIRE( bullet.collide( wall ) == false );
+
+    m2g::SweepHit hit;
+    REQUIRE( bullet.sweep( previousTransform, wall, hit ) == true );
+    REQUIRE( hit.time == Approx( 0.46f ) );
+    REQUIRE( hit.normal == sf::Vector2f( -1, 0 ) );
+
+    // Filtered out sprites are never hit.
+    wall.setCollisionFilter( 0x2, 0x2 );
+    REQUIRE( bullet.sweep( previousTransform, wall, hit ) == false );
+
+    // Previous rects must match the current ones, even when filtered out.
+    std::list< sf::FloatRect > previousRects = bullet.collisionRects( previousTransform );
+    previousRects.push_back( previousRects.front() );
+    REQUIRE_THROWS_AS( bullet.sweep( previousRects, wall, hit ), std::invalid_argument );
+    REQUIRE_THROWS_AS( bullet.sweep( std::list< sf::FloatRect >(), wall, hit ),
+                       std::invalid_argument );
+}
+
+
 TEST_CASE( "Moving sprite rendering" )
 {
     const sf::Vector2u SPRITE_POS( 8, 16 );
@@ -257,4 +367,132 @@ TEST_CASE( "TileSprite::setTile() updates the current tile" )
     }
 }
 
+TEST_CASE( "TileSprite draws tiles from every page of a paged tileset" )
+{
+    const sf::Vector2u TEXTURE_SIZE( 32, 32 );
+    const std::array< sf::Color, 4 > expectedColors =
+    {
+        sf::Color( 255, 0, 0, 255 ),
+        sf::Color( 0, 255, 0, 255 ),
+        sf::Color( 0, 0, 255, 255 ),
+        sf::Color( 255, 255, 255, 255 )
+    };
+
+    // One 32x32 page per tile.
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 32, 32, 32 );
+    REQUIRE( tileset.nPages() == 4 );
+    m2g::TileSprite sprite( tileset );
+
+    sf::RenderTexture renderTexture;
+    renderTexture.create( TEXTURE_SIZE.x, TEXTURE_SIZE.y );
+
+    for( unsigned int i = 0; i < expectedColors.size(); i++ ){
+        sprite.setTile( i );
+
+        renderTexture.clear();
+        renderTexture.draw( sprite );
+        renderTexture.display();
+
+        const sf::Image image = renderTexture.getTexture().copyToImage();
+        REQUIRE( image.getPixel( 0, 0 ) == expectedColors.at( i ) );
+        REQUIRE( image.getPixel( 31, 31 ) == expectedColors.at( i ) );
+    }
+}
+
+TEST_CASE( "Flipped TileSprite is drawn mirrored" )
+{
+    // Top half of the image: red (left) and green (right).
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 64, 32 );
+    m2g::TileSprite sprite( tileset );
+
+    sf::RenderTexture renderTexture;
+    renderTexture.create( 64, 32 );
+
+    sprite.setTileTransform( TILE_FLIP_HORIZONTALLY );
+    REQUIRE( sprite.tileTransform() == TILE_FLIP_HORIZONTALLY );
+
+    renderTexture.clear();
+    renderTexture.draw( sprite );
+    renderTexture.display();
+
+    const sf::Image image = renderTexture.getTexture().copyToImage();
+    REQUIRE( image.getPixel( 0, 0 ) == sf::Color( 0, 255, 0, 255 ) );
+    REQUIRE( image.getPixel( 63, 0 ) == sf::Color( 255, 0, 0, 255 ) );
+}
+
+
+TEST_CASE( "Rotated TileSprite swaps its boundary box dimensions" )
+{
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 64, 32 );
+    m2g::TileSprite sprite( tileset );
+
+    sprite.setTileTransform( TILE_ROTATE_90 );
+
+    REQUIRE( sprite.getBoundaryBox() == sf::FloatRect( 0, 0, 32, 64 ) );
+}
+
+
+TEST_CASE( "TileSprite collision rects are mirrored with the tile" )
+{
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 8, 32 ) );
+
+    m2g::TileSprite sprite1( tileset );
+    m2g::TileSprite sprite2( tileset );
+    sprite2.move( 24, 0 );
+
+    // sprite1's collision rect is on its left side.
+    REQUIRE( sprite1.collide( sprite2 ) == false );
+
+    // ... and on its right side once flipped.
+    sprite1.setTileTransform( TILE_FLIP_HORIZONTALLY );
+    REQUIRE( sprite1.collisionRects().front() == sf::FloatRect( 24, 0, 8, 32 ) );
+    REQUIRE( sprite1.collide( sprite2 ) == true );
+}
+
+
+
+TEST_CASE( "TileSprite cached collision rects follow its changes" )
+{
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 8, 8 ), 0, 0 );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 16, 16 ), 1, 1 );
+    m2g::TileSprite sprite( tileset );
+
+    // Queries without changes in between return the same cached rects.
+    const std::list< sf::FloatRect >* rects = &( sprite.collisionRects() );
+    REQUIRE( rects->front() == sf::FloatRect( 0, 0, 8, 8 ) );
+    REQUIRE( &( sprite.collisionRects() ) == rects );
+
+    sprite.setPosition( 10, 20 );
+    REQUIRE( sprite.collisionRects().front() == sf::FloatRect( 10, 20, 8, 8 ) );
+    REQUIRE( sprite.getBoundaryBox() == sf::FloatRect( 10, 20, 32, 32 ) );
+
+    sprite.setScale( 2, 2 );
+    REQUIRE( sprite.collisionRects().front() == sf::FloatRect( 10, 20, 16, 16 ) );
+    REQUIRE( sprite.getBoundaryBox() == sf::FloatRect( 10, 20, 64, 64 ) );
+
+    sprite.setTile( 1 );
+    REQUIRE( sprite.collisionRects().front() == sf::FloatRect( 10, 20, 32, 32 ) );
+
+    // New collision rects in the tileset are seen too.
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 4, 4 ), 1, 1 );
+    REQUIRE( sprite.collisionRects().size() == 2 );
+}
+
+
+
+TEST_CASE( "TileSprite follows the reloads of its tileset" )
+{
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    m2g::TileSprite sprite( tileset );
+    sprite.setTile( 3 );
+    REQUIRE( sprite.getBoundaryBox() == sf::FloatRect( 0, 0, 32, 32 ) );
+
+    // The current tile is out of the new tileset, so it's reset.
+    tileset.reload( m2g::Tileset( "./data/tileset_w64_h64.png", 64, 32 ) );
+    REQUIRE( sprite.getBoundaryBox() == sf::FloatRect( 0, 0, 64, 32 ) );
+    REQUIRE( sprite.currentTile() == 0 );
+}
+
 } // namespace m2g
@@ -0,0 +1,91 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../drawables/tile_transform.hpp"
+
+namespace m2g {
+
+TEST_CASE( "Rotated tiles swap their dimensions" )
+{
+    const sf::Vector2u tileDimensions( 32, 16 );
+
+    REQUIRE( transformedTileDimensions( tileDimensions, TILE_FLIP_HORIZONTALLY ) ==
+             sf::Vector2f( 32, 16 ) );
+    REQUIRE( transformedTileDimensions( tileDimensions, TILE_ROTATE_90 ) ==
+             sf::Vector2f( 16, 32 ) );
+}
+
+
+TEST_CASE( "Tile rects are mirrored with the tile" )
+{
+    const sf::Vector2u tileDimensions( 32, 16 );
+    const sf::FloatRect rect( 2, 3, 10, 4 );
+
+    REQUIRE( transformTileRect( rect, tileDimensions, TILE_TRANSFORM_NONE ) == rect );
+    REQUIRE( transformTileRect( rect, tileDimensions, TILE_FLIP_HORIZONTALLY ) ==
+             sf::FloatRect( 20, 3, 10, 4 ) );
+    REQUIRE( transformTileRect( rect, tileDimensions, TILE_FLIP_VERTICALLY ) ==
+             sf::FloatRect( 2, 9, 10, 4 ) );
+    REQUIRE( transformTileRect( rect, tileDimensions,
+                                TILE_FLIP_HORIZONTALLY | TILE_FLIP_VERTICALLY ) ==
+             sf::FloatRect( 20, 9, 10, 4 ) );
+}
+
+
+TEST_CASE( "Tile rects are rotated clockwise with the tile" )
+{
+    const sf::Vector2u tileDimensions( 32, 16 );
+    const sf::FloatRect rect( 2, 3, 10, 4 );
+
+    // Rotated tile is 16x32; the rect's top-left corner goes to the right.
+    REQUIRE( transformTileRect( rect, tileDimensions, TILE_ROTATE_90 ) ==
+             sf::FloatRect( 9, 2, 4, 10 ) );
+    REQUIRE( transformTileRect( rect, tileDimensions,
+                                TILE_ROTATE_90 | TILE_FLIP_HORIZONTALLY ) ==
+             sf::FloatRect( 3, 2, 4, 10 ) );
+}
+
+
+TEST_CASE( "Tile texture coordinates follow the tile transform" )
+{
+    const sf::IntRect tileRect( 64, 32, 32, 16 );
+    sf::Vector2f texCoords[4];
+
+    transformTileTexCoords( tileRect, TILE_TRANSFORM_NONE, texCoords );
+    REQUIRE( texCoords[0] == sf::Vector2f( 64, 32 ) );
+    REQUIRE( texCoords[2] == sf::Vector2f( 96, 48 ) );
+
+    transformTileTexCoords( tileRect, TILE_FLIP_HORIZONTALLY, texCoords );
+    REQUIRE( texCoords[0] == sf::Vector2f( 96, 32 ) );
+    REQUIRE( texCoords[1] == sf::Vector2f( 64, 32 ) );
+
+    transformTileTexCoords( tileRect, TILE_FLIP_VERTICALLY, texCoords );
+    REQUIRE( texCoords[0] == sf::Vector2f( 64, 48 ) );
+    REQUIRE( texCoords[3] == sf::Vector2f( 64, 32 ) );
+
+    // Clockwise rotation: the bottom-left source corner goes top-left.
+    transformTileTexCoords( tileRect, TILE_ROTATE_90, texCoords );
+    REQUIRE( texCoords[0] == sf::Vector2f( 64, 48 ) );
+    REQUIRE( texCoords[1] == sf::Vector2f( 64, 32 ) );
+    REQUIRE( texCoords[2] == sf::Vector2f( 96, 32 ) );
+    REQUIRE( texCoords[3] == sf::Vector2f( 96, 48 ) );
+}
+
+} // namespace m2g
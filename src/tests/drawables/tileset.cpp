@@ -176,4 +176,142 @@ TEST_CASE( "Tileset::collisionRects() returns the collision rects added to a ran
     REQUIRE( tileset.collisionRects( 3 ).size() == 0 );
 }
 
+TEST_CASE( "Tileset::tileCollisionRects() returns the rects and layers of a tile" )
+{
+    m2g::Tileset tileset( "./data/test_tileset.png", 32, 32 );
+    tileset.addCollisionRect( { 1, 0, 24, 15 }, 1, 2, 4 );
+    tileset.addCollisionRect( { 3, 6, 5, 9 }, 2, 3 );
+    m2g::Tileset copy( tileset );
+    copy.addCollisionRect( { 0, 0, 8, 8 }, 0, 3 );
+
+    REQUIRE( tileset.tileCollisionRects( 0 ).empty() );
+    REQUIRE( tileset.tileCollisionRects( 1 ).size() == 1 );
+    REQUIRE( tileset.tileCollisionRects( 1 )[0].layers == 4 );
+    REQUIRE( tileset.tileCollisionRects( 2 ).size() == 2 );
+    REQUIRE( tileset.tileCollisionRects( 3 ).size() == 1 );
+    REQUIRE( tileset.tileCollisionRects( 3 )[0].rect == sf::IntRect( 3, 6, 5, 9 ) );
+    REQUIRE( tileset.tileCollisionRects( tileset.nTiles() ).empty() );
+    REQUIRE( copy.tileCollisionRects( 0 ).size() == 1 );
+    REQUIRE( copy.tileCollisionRects( 2 ).size() == 3 );
+}
+
+
+TEST_CASE( "Tileset bigger than the maximum texture size is split into pages" )
+{
+    // 256x128 image with 32x64 tiles and 128x128 pages: two pages of 4x2
+    // tiles each.
+    m2g::Tileset tileset( "./data/test_tileset.png", 32, 64, 128 );
+
+    REQUIRE( tileset.nPages() == 2 );
+    REQUIRE( tileset.nTiles() == 16 );
+    REQUIRE( tileset.dimensions() == sf::Vector2u( 256, 128 ) );
+    REQUIRE( tileset.texture( 0 ).getSize() == sf::Vector2u( 128, 128 ) );
+    REQUIRE( tileset.texture( 1 ).getSize() == sf::Vector2u( 128, 128 ) );
+
+    REQUIRE( tileset.tilePage( 3 ) == 0 );
+    REQUIRE( tileset.tilePage( 4 ) == 1 );
+    REQUIRE( tileset.tilePage( 11 ) == 0 );
+    REQUIRE( tileset.tilePage( 15 ) == 1 );
+
+    REQUIRE( tileset.tileRect( 4 ) == sf::IntRect( 0, 0, 32, 64 ) );
+    REQUIRE( tileset.tileRect( 13 ) == sf::IntRect( 32, 64, 32, 64 ) );
+}
+
+
+TEST_CASE( "Tileset fitting in the maximum texture size has a single page" )
+{
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+
+    REQUIRE( tileset.nPages() == 1 );
+    for( unsigned int tile = 0; tile < tileset.nTiles(); tile++ ){
+        REQUIRE( tileset.tilePage( tile ) == 0 );
+    }
+}
+
+
+TEST_CASE( "Tileset with tiles bigger than the maximum texture size throws" )
+{
+    REQUIRE_THROWS_AS( m2g::Tileset( "./data/tileset_w64_h64.png", 64, 64, 32 ),
+                       std::invalid_argument );
+}
+
+TEST_CASE( "Tileset keeps a single copy of duplicated tiles when asked to" )
+{
+    // 3x2 grid of 32x32 tiles: red green red / green blue red.
+    m2g::Tileset tileset( "./data/tileset_duplicated_tiles.png",
+                          32, 32,
+                          m2g::TilesetLoadOptions( 0, true ) );
+
+    REQUIRE( tileset.nTiles() == 6 );
+    REQUIRE( tileset.dimensions() == sf::Vector2u( 96, 64 ) );
+    REQUIRE( tileset.texture().getSize() == sf::Vector2u( 96, 32 ) );
+
+    REQUIRE( tileset.tileSlot( 2 ) == tileset.tileSlot( 0 ) );
+    REQUIRE( tileset.tileSlot( 5 ) == tileset.tileSlot( 0 ) );
+    REQUIRE( tileset.tileSlot( 3 ) == tileset.tileSlot( 1 ) );
+    REQUIRE( tileset.tileRect( 3 ) == tileset.tileRect( 1 ) );
+    REQUIRE( tileset.tileRect( 4 ) == sf::IntRect( 64, 0, 32, 32 ) );
+
+    const m2g::TileDeduplicationStats stats = tileset.deduplicationStats();
+    REQUIRE( stats.nTiles == 6 );
+    REQUIRE( stats.nUniqueTiles == 3 );
+    REQUIRE( stats.savedBytes == 96 * 32 * 4 );
+}
+
+
+TEST_CASE( "Tileset keeps duplicated tiles by default" )
+{
+    m2g::Tileset tileset( "./data/tileset_duplicated_tiles.png", 32, 32 );
+
+    REQUIRE( tileset.texture().getSize() == sf::Vector2u( 96, 64 ) );
+    REQUIRE( tileset.tileSlot( 5 ) == 5 );
+    REQUIRE( tileset.deduplicationStats().nUniqueTiles == 6 );
+    REQUIRE( tileset.deduplicationStats().savedBytes == 0 );
+}
+
+
+TEST_CASE( "Collision rects keep referencing logical tiles after deduplication" )
+{
+    m2g::Tileset tileset( "./data/tileset_duplicated_tiles.png",
+                          32, 32,
+                          m2g::TilesetLoadOptions( 0, true ) );
+    tileset.addCollisionRect( sf::IntRect( 0, 0, 8, 8 ), 5, 5 );
+
+    REQUIRE( tileset.collisionRects( 0 ).size() == 0 );
+    REQUIRE( tileset.collisionRects( 5 ).size() == 1 );
+}
+
+
+
+TEST_CASE( "Tileset copies share their contents until modified" )
+{
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    m2g::Tileset copy( tileset );
+    const unsigned int revision = copy.revision();
+
+    copy.addCollisionRect( sf::IntRect( 0, 0, 4, 4 ) );
+
+    REQUIRE( copy.revision() != revision );
+    REQUIRE( copy.collisionRects( 0 ).size() == 1 );
+    REQUIRE( tileset.revision() == revision );
+    REQUIRE( tileset.collisionRects( 0 ).empty() );
+}
+
+
+TEST_CASE( "Reloading a tileset updates every copy sharing its contents" )
+{
+    m2g::Tileset tileset( "./data/tileset_w64_h64.png", 32, 32 );
+    m2g::Tileset copy( tileset );
+    m2g::Tileset newTileset( "./data/tileset_w64_h64.png", 64, 16 );
+    newTileset.addCollisionRect( sf::IntRect( 1, 2, 3, 4 ) );
+    const unsigned int revision = copy.revision();
+
+    tileset.reload( newTileset );
+
+    REQUIRE( copy.revision() != revision );
+    REQUIRE( copy.tileDimensions() == sf::Vector2u( 64, 16 ) );
+    REQUIRE( copy.nTiles() == 4 );
+    REQUIRE( copy.collisionRects( 3 ).size() == 1 );
+}
+
 } // namespace m2g
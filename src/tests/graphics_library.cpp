@@ -19,7 +19,13 @@
 
 #include <catch.hpp>
 #include <array>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
 #include "../graphics_library.hpp"
+#include "../utilities/stats.hpp"
 
 namespace m2g {
 
@@ -157,4 +163,300 @@ TEST_CASE( "AnimationData objects can be loaded from file by prefix" )
     }
 }
 
+TEST_CASE( "GraphicsLibrary reports tile deduplication stats" )
+{
+    GraphicsLibrary graphicsLibrary( "data/test_graphics_library.xml" );
+    graphicsLibrary.setTileDeduplication( true );
+
+    TilesetPtr tileset =
+            graphicsLibrary.getTilesetByName( "Tileset64x64 - tile32x32" );
+
+    // All the tiles in the image are different.
+    REQUIRE( graphicsLibrary.deduplicationStats().nTiles == 4 );
+    REQUIRE( graphicsLibrary.deduplicationStats().nUniqueTiles == 4 );
+    REQUIRE( graphicsLibrary.deduplicationStats().savedBytes == 0 );
+}
+
+TEST_CASE( "AnimationData states' tile transforms are loaded from file" )
+{
+    GraphicsLibrary graphicsLibrary( "data/test_graphics_library.xml" );
+    AnimationDataPtr animData =
+            graphicsLibrary.getAnimationDataByName( "Flipped animation" );
+
+    REQUIRE( animData->nStates() == 3 );
+    REQUIRE( animData->state( 0 ).tileTransform == TILE_TRANSFORM_NONE );
+    REQUIRE( animData->state( 1 ).tileTransform == TILE_FLIP_HORIZONTALLY );
+    REQUIRE( animData->state( 2 ).tileTransform ==
+             ( TILE_ROTATE_90 | TILE_FLIP_HORIZONTALLY | TILE_FLIP_VERTICALLY ) );
+}
+
+TEST_CASE( "GraphicsLibrary throws if the library file can't be loaded" )
+{
+    REQUIRE_THROWS_AS( GraphicsLibrary( "data/not_found.xml" ), std::runtime_error );
+}
+
+
+TEST_CASE( "GraphicsLibrary returns independent copies of cached tilesets" )
+{
+    GraphicsLibrary graphicsLibrary( "data/test_graphics_library.xml" );
+
+    TilesetPtr tileset1 =
+            graphicsLibrary.getTilesetByName( "Tileset64x64 - tile32x32" );
+    tileset1->addCollisionRect( sf::IntRect( 0, 0, 1, 1 ) );
+    TilesetPtr tileset2 =
+            graphicsLibrary.getTilesetByName( "Tileset64x64 - tile32x32" );
+
+    REQUIRE( tileset1 != tileset2 );
+    REQUIRE( &( tileset1->texture() ) == &( tileset2->texture() ) );
+    REQUIRE( tileset2->collisionRects( 0 ).empty() );
+    REQUIRE( graphicsLibrary.getTilesetByName( "Unknown tileset" ) == nullptr );
+}
+
+
+TEST_CASE( "GraphicsLibrary loads an asset requested by several threads only once" )
+{
+    const unsigned int N_THREADS = 8;
+    GraphicsLibrary graphicsLibrary( "data/test_graphics_library.xml" );
+    const std::uint64_t initialLoads =
+            Stats::snapshot().counters[STAT_TILESETS_LOADED];
+
+    std::vector< TilesetPtr > tilesets( N_THREADS );
+    std::vector< AnimationDataPtr > animations( N_THREADS );
+    std::vector< std::thread > threads;
+    for( unsigned int i = 0; i < N_THREADS; i++ ){
+        threads.emplace_back( [&, i](){
+            tilesets[i] = graphicsLibrary.getTilesetByName( "Tileset64x64 - tile64x16" );
+            animations[i] = graphicsLibrary.getAnimationDataByName( "Animation 1" );
+        });
+    }
+    for( std::thread& thread : threads ){
+        thread.join();
+    }
+
+    // One tileset plus the animation's one.
+    REQUIRE( Stats::snapshot().counters[STAT_TILESETS_LOADED] == initialLoads + 2 );
+    for( unsigned int i = 0; i < N_THREADS; i++ ){
+        REQUIRE( tilesets[i]->tileDimensions() == sf::Vector2u( 64, 16 ) );
+        REQUIRE( animations[i]->refreshRate() == 3 );
+    }
+}
+
+TEST_CASE( "GraphicsLibrary merges the libraries it includes" )
+{
+    GraphicsLibrary graphicsLibrary( "data/composed_library.xml" );
+
+    REQUIRE( graphicsLibrary.getTilesetByName( "Root tileset" ) != nullptr );
+
+    // Paths are relative to the file each entry is defined in.
+    TilesetPtr tileset = graphicsLibrary.getTilesetByName( "Included tileset" );
+    REQUIRE( tileset != nullptr );
+    REQUIRE( tileset->tileDimensions() == sf::Vector2u( 64, 16 ) );
+
+    AnimationDataPtr animData = graphicsLibrary.getAnimationDataByName( "Included animation" );
+    REQUIRE( animData != nullptr );
+    REQUIRE( animData->refreshRate() == 12 );
+}
+
+
+TEST_CASE( "GraphicsLibrary throws on names repeated across included libraries" )
+{
+    REQUIRE_THROWS_AS( GraphicsLibrary( "data/library_with_repeated_names.xml" ),
+                       std::runtime_error );
+}
+
+
+TEST_CASE( "GraphicsLibrary resolves names into stable handles" )
+{
+    GraphicsLibrary graphicsLibrary( "data/test_graphics_library.xml" );
+
+    const TilesetHandle tilesetHandle =
+            graphicsLibrary.tilesetHandle( "Tileset64x64 - tile64x16" );
+    const AnimationHandle animationHandle =
+            graphicsLibrary.animationHandle( "Animation 1" );
+    REQUIRE( tilesetHandle.valid() );
+    REQUIRE( animationHandle.valid() );
+    REQUIRE( tilesetHandle == graphicsLibrary.tilesetHandle( "Tileset64x64 - tile64x16" ) );
+    REQUIRE( graphicsLibrary.tilesetHandle( "Unknown tileset" ).valid() == false );
+    REQUIRE( graphicsLibrary.animationHandle( "Unknown animation" ).valid() == false );
+
+    // Handles give the cached asset itself.
+    std::shared_ptr< const Tileset > tileset = graphicsLibrary.getTileset( tilesetHandle );
+    REQUIRE( tileset->tileDimensions() == sf::Vector2u( 64, 16 ) );
+    REQUIRE( graphicsLibrary.getTileset( tilesetHandle ) == tileset );
+    REQUIRE( &( graphicsLibrary.getTilesetByName( "Tileset64x64 - tile64x16" )->texture() ) ==
+             &( tileset->texture() ) );
+    REQUIRE( graphicsLibrary.getAnimationData( animationHandle )->refreshRate() == 3 );
+
+    REQUIRE_THROWS_AS( graphicsLibrary.getTileset( TilesetHandle( 1000 ) ), std::out_of_range );
+    REQUIRE_THROWS_AS( graphicsLibrary.getTileset( TilesetHandle() ), std::out_of_range );
+}
+
+
+void waitForGroup( GraphicsLibrary& graphicsLibrary, const std::string& groupName )
+{
+    for( unsigned int i = 0; i < 500; i++ ){
+        const GroupProgress progress = graphicsLibrary.groupProgress( groupName );
+        if( progress.nLoaded + progress.nFailed == progress.nAssets ){
+            return;
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+}
+
+
+TEST_CASE( "GraphicsLibrary prefetches groups in the background" )
+{
+    GraphicsLibrary graphicsLibrary( "data/library_with_groups.xml" );
+    GroupProgress progress = graphicsLibrary.groupProgress( "level_1" );
+    REQUIRE( progress.nAssets == 3 );
+    REQUIRE( progress.nLoaded == 0 );
+
+    graphicsLibrary.prefetchGroup( "level_1", 1 );
+    waitForGroup( graphicsLibrary, "level_1" );
+    progress = graphicsLibrary.groupProgress( "level_1" );
+    REQUIRE( progress.nLoaded == 3 );
+    REQUIRE( progress.nFailed == 0 );
+
+    // Prefetched assets aren't loaded again.
+    const std::uint64_t initialLoads =
+            Stats::snapshot().counters[STAT_TILESETS_LOADED];
+    REQUIRE( graphicsLibrary.getAnimationDataByName( "Animation 1" ) != nullptr );
+    REQUIRE( Stats::snapshot().counters[STAT_TILESETS_LOADED] == initialLoads );
+
+    REQUIRE_THROWS_AS( graphicsLibrary.prefetchGroup( "Unknown group" ), std::out_of_range );
+}
+
+
+TEST_CASE( "GraphicsLibrary releases the group assets no longer used" )
+{
+    GraphicsLibrary graphicsLibrary( "data/library_with_groups.xml" );
+    graphicsLibrary.prefetchGroup( "level_1" );
+    graphicsLibrary.prefetchGroup( "level_2" );
+    waitForGroup( graphicsLibrary, "level_1" );
+    waitForGroup( graphicsLibrary, "level_2" );
+
+    // "Tileset64x64 - tile32x32" is still needed by level_2 and
+    // "Tileset64x64 - tile64x16" is still in use.
+    TilesetPtr tileset = graphicsLibrary.getTilesetByName( "Tileset64x64 - tile64x16" );
+    REQUIRE( graphicsLibrary.releaseGroup( "level_1" ) == 1 );
+    REQUIRE( graphicsLibrary.groupProgress( "level_1" ).nLoaded == 2 );
+
+    tileset.reset();
+    REQUIRE( graphicsLibrary.releaseUnusedAssets() == 1 );
+    REQUIRE( graphicsLibrary.groupProgress( "level_1" ).nLoaded == 1 );
+    REQUIRE( graphicsLibrary.groupProgress( "level_2" ).nLoaded == 1 );
+}
+
+
+TEST_CASE( "GraphicsLibrary throws on groups listing unknown entries" )
+{
+    REQUIRE_THROWS_AS( GraphicsLibrary( "data/library_with_invalid_group.xml" ),
+                       std::runtime_error );
+}
+
+
+TEST_CASE( "GraphicsLibrary::validate() accepts valid libraries" )
+{
+    REQUIRE( GraphicsLibrary::validate( "data/test_graphics_library.xml" ).empty() );
+    REQUIRE( GraphicsLibrary::validate( "data/composed_library.xml" ).empty() );
+    REQUIRE( GraphicsLibrary::validate( "data/library_with_groups.xml" ).empty() );
+}
+
+
+TEST_CASE( "GraphicsLibrary::validate() reports every error at once" )
+{
+    // The missing include, the 6 invalid entries and the group.
+    REQUIRE( GraphicsLibrary::validate( "data/invalid_library.xml" ).size() == 8 );
+    REQUIRE( GraphicsLibrary::validate( "data/library_with_repeated_names.xml" ).size() == 1 );
+    REQUIRE( GraphicsLibrary::validate( "data/not_found.xml" ).size() == 1 );
+}
+
+#ifdef __linux__
+
+void writeHotReloadLibrary( const std::string& filePath,
+                            unsigned int tileHeight,
+                            unsigned int fps )
+{
+    std::ofstream file( filePath.c_str() );
+    file << "<library>"
+         << "<tileset><name>Edited</name><src>tileset_w64_h64.png</src>"
+         << "<tile_dimensions width=\"64\" height=\"" << tileHeight << "\"/></tileset>"
+         << "<tileset><name>Untouched</name><src>tileset_w64_h64.png</src>"
+         << "<tile_dimensions width=\"32\" height=\"32\"/></tileset>"
+         << "<animation fps=\"" << fps << "\"><tileset><name>Animation</name>"
+         << "<src>tileset_w64_h64.png</src><tile_dimensions width=\"32\" height=\"32\"/>"
+         << "</tileset><animation_states>"
+         << "<animation_state first_frame=\"0\" last_frame=\"3\" back_frame=\"0\" />"
+         << "</animation_states></animation></library>";
+}
+
+
+TEST_CASE( "GraphicsLibrary reloads in place the entries changed on disk" )
+{
+    const std::string libraryPath = "data/hot_reload_library.xml";
+    writeHotReloadLibrary( libraryPath, 32, 5 );
+
+    GraphicsLibrary graphicsLibrary( libraryPath );
+    graphicsLibrary.enableHotReload();
+    TilesetPtr edited = graphicsLibrary.getTilesetByName( "Edited" );
+    TilesetPtr untouched = graphicsLibrary.getTilesetByName( "Untouched" );
+    AnimationDataPtr animData = graphicsLibrary.getAnimationDataByName( "Animation" );
+    const unsigned int untouchedRevision = untouched->revision();
+    REQUIRE( graphicsLibrary.pollChanges() == 0 );
+
+    writeHotReloadLibrary( libraryPath, 16, 10 );
+
+    // Reloads are applied by the first poll after they finish.
+    unsigned int nReloaded = 0;
+    for( unsigned int i = 0; i < 500 && nReloaded < 2; i++ ){
+        nReloaded += graphicsLibrary.pollChanges();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+
+    REQUIRE( nReloaded == 2 );
+    REQUIRE( edited->tileDimensions() == sf::Vector2u( 64, 16 ) );
+    REQUIRE( edited->nTiles() == 4 );
+    REQUIRE( animData->refreshRate() == 10 );
+    REQUIRE( untouched->revision() == untouchedRevision );
+    REQUIRE( graphicsLibrary.getTileset( graphicsLibrary.tilesetHandle( "Edited" ) )->nTiles() == 4 );
+
+    std::remove( libraryPath.c_str() );
+}
+
+
+TEST_CASE( "GraphicsLibrary keeps retrying a changed file until it loads" )
+{
+    const std::string libraryPath = "data/hot_reload_library.xml";
+    writeHotReloadLibrary( libraryPath, 32, 5 );
+
+    GraphicsLibrary graphicsLibrary( libraryPath );
+    graphicsLibrary.enableHotReload();
+    TilesetPtr edited = graphicsLibrary.getTilesetByName( "Edited" );
+
+    {
+        std::ofstream file( libraryPath.c_str() );
+        file << "<library><tileset>";
+    }
+
+    // No new change is reported by the watcher for the second poll.
+    REQUIRE_THROWS_AS( graphicsLibrary.pollChanges(), std::runtime_error );
+    REQUIRE_THROWS_AS( graphicsLibrary.pollChanges(), std::runtime_error );
+    REQUIRE( edited->tileDimensions() == sf::Vector2u( 64, 32 ) );
+
+    writeHotReloadLibrary( libraryPath, 16, 5 );
+
+    unsigned int nReloaded = 0;
+    for( unsigned int i = 0; i < 500 && nReloaded < 1; i++ ){
+        nReloaded += graphicsLibrary.pollChanges();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    }
+
+    REQUIRE( nReloaded == 1 );
+    REQUIRE( edited->tileDimensions() == sf::Vector2u( 64, 16 ) );
+
+    std::remove( libraryPath.c_str() );
+}
+
+#endif
+
 } // namespace m2g
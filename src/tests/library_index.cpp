@@ -0,0 +1,132 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../library_index.hpp"
+#include "../drawables/tileset.hpp"
+#include <stdexcept>
+
+namespace m2g {
+
+TEST_CASE( "LibraryIndex keeps a descriptor per tileset and animation" )
+{
+    LibraryIndex index( "data/test_graphics_library.xml" );
+
+    REQUIRE( index.libraryPath() == "data/test_graphics_library.xml" );
+    REQUIRE( index.tilesets().size() == 2 );
+    REQUIRE( index.animations().size() == 4 );
+
+    const TilesetDescriptor& tileset = index.tilesets()[1];
+    REQUIRE( tileset.name == "Tileset64x64 - tile64x16" );
+    REQUIRE( tileset.src == "tileset_w64_h64.png" );
+    REQUIRE( tileset.tileDimensions == sf::Vector2u( 64, 16 ) );
+    REQUIRE( tileset.packed == false );
+
+    REQUIRE( tileset.collisionRects.size() == 4 );
+    REQUIRE( tileset.collisionRects[0].allTiles );
+    REQUIRE( tileset.collisionRects[0].rect == sf::IntRect( 14, 7, 5, 10 ) );
+    REQUIRE( tileset.collisionRects[3].allTiles == false );
+    REQUIRE( tileset.collisionRects[3].firstTile == 2 );
+    REQUIRE( tileset.collisionRects[3].lastTile == 3 );
+
+    const AnimationDescriptor& animation = index.animations()[0];
+    REQUIRE( animation.tileset.name == "Animation 1" );
+    REQUIRE( animation.refreshRate == 3 );
+    REQUIRE( animation.states.size() == 2 );
+    REQUIRE( animation.states[0] == AnimationState( 0, 3, 1 ) );
+
+    REQUIRE( index.animations()[3].states[2].tileTransform ==
+             ( TILE_ROTATE_90 | TILE_FLIP_HORIZONTALLY | TILE_FLIP_VERTICALLY ) );
+}
+
+
+TEST_CASE( "LibraryIndex reads the collision filters and layers of tilesets" )
+{
+    LibraryIndex index( "data/library_with_collision_filters.xml" );
+    REQUIRE( index.tilesets().size() == 2 );
+
+    const TilesetDescriptor& fighter = index.tilesets()[0];
+    REQUIRE( fighter.collisionCategory == 0x3 );
+    REQUIRE( fighter.collisionMask == 0x2 );
+    REQUIRE( fighter.collisionRects.size() == 2 );
+    REQUIRE( fighter.collisionRects[0].layers == ALL_COLLISION_CATEGORIES );
+    REQUIRE( fighter.collisionRects[1].layers == 0x2 );
+
+    const TilesetDescriptor& scenery = index.tilesets()[1];
+    REQUIRE( scenery.collisionCategory == DEFAULT_COLLISION_CATEGORY );
+    REQUIRE( scenery.collisionMask == ALL_COLLISION_CATEGORIES );
+}
+
+
+TEST_CASE( "LibraryIndex names tilesets without <name> after their file" )
+{
+    LibraryIndex index( "data/library_with_unnamed_tileset.xml" );
+
+    REQUIRE( index.tilesets().size() == 1 );
+    REQUIRE( index.tilesets()[0].name == "tileset_w64_h64.png" );
+}
+
+
+TEST_CASE( "LibraryIndex throws on missing or malformed libraries" )
+{
+    REQUIRE_THROWS_AS( LibraryIndex( "data/not_found.xml" ), std::runtime_error );
+    REQUIRE_THROWS_AS( LibraryIndex( "data/library_without_src.xml" ), std::runtime_error );
+    REQUIRE_THROWS_AS( LibraryIndex( "data/test_graphics_library.xml" ).atlasPageSrc( 0 ),
+                       std::runtime_error );
+}
+
+TEST_CASE( "LibraryIndex keeps the <include> elements as written" )
+{
+    LibraryIndex index( "data/composed_library.xml" );
+
+    REQUIRE( index.includes() ==
+             std::vector< std::string >( { "included/tilesets.xml", "included/animations.xml" } ) );
+    REQUIRE( index.tilesets().size() == 1 );
+}
+
+
+
+TEST_CASE( "LibraryIndex keeps the groups by entry name" )
+{
+    LibraryIndex index( "data/library_with_groups.xml" );
+
+    REQUIRE( index.groups().size() == 2 );
+    REQUIRE( index.groups()[0].name == "level_1" );
+    REQUIRE( index.groups()[0].tilesets ==
+             std::vector< std::string >( { "Tileset64x64 - tile32x32", "Tileset64x64 - tile64x16" } ) );
+    REQUIRE( index.groups()[0].animations == std::vector< std::string >( { "Animation 1" } ) );
+    REQUIRE( index.groups()[1].animations.empty() );
+}
+
+
+
+TEST_CASE( "LibraryIndex can collect the errors instead of throwing" )
+{
+    REQUIRE_THROWS_AS( LibraryIndex( "data/invalid_library.xml" ), std::runtime_error );
+
+    std::vector< std::string > errors;
+    LibraryIndex index( "data/invalid_library.xml", &errors );
+
+    // Without <src> and with last_frame < first_frame.
+    REQUIRE( errors.size() == 2 );
+    REQUIRE( index.tilesets().size() == 4 );
+    REQUIRE( index.animations().size() == 1 );
+}
+
+} // namespace m2g
@@ -0,0 +1,104 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/cache_slot.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace m2g {
+
+TEST_CASE( "CacheSlot loads its value once and until cleared" )
+{
+    CacheSlot< const int > slot;
+    unsigned int nLoads = 0;
+    auto load = [&](){
+        nLoads++;
+        return std::make_shared< const int >( 4 );
+    };
+
+    REQUIRE( slot.find() == nullptr );
+    REQUIRE( *slot.get( load ) == 4 );
+    REQUIRE( slot.get( load ) == slot.find() );
+    REQUIRE( nLoads == 1 );
+
+    slot.clear();
+    REQUIRE( slot.find() == nullptr );
+    slot.get( load );
+    REQUIRE( nLoads == 2 );
+}
+
+
+TEST_CASE( "CacheSlot coalesces concurrent loads" )
+{
+    const unsigned int N_THREADS = 8;
+    CacheSlot< const int > slot;
+    std::atomic< unsigned int > nLoads( 0 );
+
+    std::vector< std::thread > threads;
+    for( unsigned int i = 0; i < N_THREADS; i++ ){
+        threads.emplace_back( [&](){
+            slot.get( [&](){
+                nLoads++;
+                std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+                return std::make_shared< const int >( 3 );
+            });
+        });
+    }
+    for( std::thread& thread : threads ){
+        thread.join();
+    }
+
+    REQUIRE( nLoads == 1 );
+}
+
+TEST_CASE( "CacheSlot values can be found while the slot is cleared" )
+{
+    const unsigned int N_THREADS = 4;
+    CacheSlot< const int > slot;
+    auto load = [](){
+        return std::make_shared< const int >( 7 );
+    };
+    std::atomic< bool > stop( false );
+    std::atomic< unsigned int > nWrongValues( 0 );
+
+    std::vector< std::thread > threads;
+    for( unsigned int i = 0; i < N_THREADS; i++ ){
+        threads.emplace_back( [&](){
+            while( !stop ){
+                CacheSlot< const int >::ValuePtr value = slot.find();
+                nWrongValues += ( value != nullptr && *value != 7 );
+            }
+        });
+    }
+    for( unsigned int i = 0; i < 1000; i++ ){
+        slot.get( load );
+        slot.clear();
+    }
+    stop = true;
+    for( std::thread& thread : threads ){
+        thread.join();
+    }
+
+    REQUIRE( nWrongValues == 0 );
+}
+
+} // namespace m2g
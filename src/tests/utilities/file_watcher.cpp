@@ -0,0 +1,60 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/file_watcher.hpp"
+#include <cstdio>
+#include <fstream>
+
+namespace m2g {
+
+#ifdef __linux__
+
+TEST_CASE( "FileWatcher reports the watched files which changed" )
+{
+    const std::string watchedPath = "data/watched_file.txt";
+    const std::string unwatchedPath = "data/unwatched_file.txt";
+    std::ofstream( watchedPath.c_str() ) << "a";
+
+    FileWatcher watcher;
+    watcher.watch( watchedPath );
+    REQUIRE( watcher.watches( watchedPath ) );
+    REQUIRE( watcher.watches( unwatchedPath ) == false );
+    REQUIRE( watcher.changedFiles().empty() );
+
+    std::ofstream( unwatchedPath.c_str() ) << "b";
+    REQUIRE( watcher.changedFiles().empty() );
+
+    // Several writes are reported once.
+    std::ofstream( watchedPath.c_str() ) << "c";
+    std::ofstream( watchedPath.c_str() ) << "d";
+    REQUIRE( watcher.changedFiles() == std::vector< std::string >{ watchedPath } );
+    REQUIRE( watcher.changedFiles().empty() );
+
+    // Replacing the file (as many editors do) is reported too.
+    std::ofstream( unwatchedPath.c_str() ) << "e";
+    std::rename( unwatchedPath.c_str(), watchedPath.c_str() );
+    REQUIRE( watcher.changedFiles() == std::vector< std::string >{ watchedPath } );
+
+    std::remove( watchedPath.c_str() );
+}
+
+#endif
+
+} // namespace m2g
@@ -0,0 +1,115 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/guillotine_packer.hpp"
+#include <vector>
+
+namespace m2g {
+
+TEST_CASE( "GuillotinePacker fills a page with equally sized rects" )
+{
+    GuillotinePacker packer( 64, 64 );
+    sf::Vector2u position;
+
+    for( unsigned int i = 0; i < 16; i++ ){
+        REQUIRE( packer.insert( 16, 16, position ) );
+    }
+
+    REQUIRE( packer.usedArea() == 64 * 64 );
+    REQUIRE( packer.insert( 1, 1, position ) == false );
+}
+
+
+TEST_CASE( "GuillotinePacker never overlaps rects" )
+{
+    GuillotinePacker packer( 128, 128 );
+    std::vector< sf::IntRect > rects;
+    const unsigned int sizes[][2] =
+    {
+        { 40, 30 }, { 20, 50 }, { 64, 16 }, { 10, 10 }, { 33, 47 },
+        { 25, 25 }, { 8, 60 }, { 30, 30 }, { 16, 16 }
+    };
+
+    for( const auto& size : sizes ){
+        sf::Vector2u position;
+        REQUIRE( packer.insert( size[0], size[1], position ) );
+        rects.push_back( sf::IntRect( position.x, position.y, size[0], size[1] ) );
+    }
+
+    for( unsigned int i = 0; i < rects.size(); i++ ){
+        REQUIRE( rects[i].left + rects[i].width <= 128 );
+        REQUIRE( rects[i].top + rects[i].height <= 128 );
+        for( unsigned int j = i + 1; j < rects.size(); j++ ){
+            REQUIRE( rects[i].intersects( rects[j] ) == false );
+        }
+    }
+}
+
+
+TEST_CASE( "GuillotinePacker reuses released rects" )
+{
+    GuillotinePacker packer( 64, 64 );
+    sf::Vector2u positions[4];
+
+    for( sf::Vector2u& position : positions ){
+        REQUIRE( packer.insert( 32, 32, position ) );
+    }
+    REQUIRE( packer.insert( 32, 32, positions[0] ) == false );
+
+    packer.release( sf::IntRect( positions[2].x, positions[2].y, 32, 32 ) );
+
+    sf::Vector2u position;
+    REQUIRE( packer.insert( 32, 32, position ) );
+    REQUIRE( position == positions[2] );
+}
+
+
+TEST_CASE( "GuillotinePacker merges neighbour released rects" )
+{
+    GuillotinePacker packer( 64, 64 );
+    sf::Vector2u positions[4];
+
+    for( sf::Vector2u& position : positions ){
+        REQUIRE( packer.insert( 64, 16, position ) );
+    }
+
+    packer.release( sf::IntRect( positions[1].x, positions[1].y, 64, 16 ) );
+    packer.release( sf::IntRect( positions[2].x, positions[2].y, 64, 16 ) );
+
+    sf::Vector2u position;
+    REQUIRE( packer.insert( 64, 32, position ) );
+}
+
+
+TEST_CASE( "GuillotinePacker is reset when every rect is released" )
+{
+    GuillotinePacker packer( 64, 64 );
+    sf::Vector2u a, b;
+
+    packer.insert( 10, 20, a );
+    packer.insert( 30, 5, b );
+    packer.release( sf::IntRect( a.x, a.y, 10, 20 ) );
+    packer.release( sf::IntRect( b.x, b.y, 30, 5 ) );
+
+    REQUIRE( packer.empty() );
+    REQUIRE( packer.nFreeRects() == 1 );
+}
+
+} // namespace m2g
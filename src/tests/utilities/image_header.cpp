@@ -0,0 +1,38 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/image_header.hpp"
+#include <stdexcept>
+
+namespace m2g {
+
+TEST_CASE( "readImageSize reads the dimensions from the PNG header" )
+{
+    REQUIRE( readImageSize( "data/tileset_w64_h64.png" ) == sf::Vector2u( 64, 64 ) );
+}
+
+
+TEST_CASE( "readImageSize throws on missing or non PNG files" )
+{
+    REQUIRE_THROWS_AS( readImageSize( "data/not_found.png" ), std::runtime_error );
+    REQUIRE_THROWS_AS( readImageSize( "data/test_graphics_library.xml" ), std::runtime_error );
+}
+
+} // namespace m2g
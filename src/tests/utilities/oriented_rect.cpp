@@ -0,0 +1,64 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/oriented_rect.hpp"
+
+namespace m2g {
+
+TEST_CASE( "Unrotated oriented rects agree with sf::FloatRect::intersects" )
+{
+    const sf::FloatRect rect( 0, 0, 10, 10 );
+    for( int x = -15; x <= 15; x += 5 ){
+        for( int y = -15; y <= 15; y += 5 ){
+            const sf::FloatRect other( x, y, 10, 10 );
+            REQUIRE( intersects( orientedRect( rect ), orientedRect( other ) ) ==
+                     rect.intersects( other ) );
+        }
+    }
+}
+
+
+TEST_CASE( "Oriented rects are tested with their rotated sides" )
+{
+    // Square rotated 45 degrees around its center, a diamond whose bounds
+    // almost cover the whole [0, 20] x [0, 20] area.
+    sf::Transform rotation;
+    rotation.rotate( 45, 10, 10 );
+    const OrientedRect diamond =
+            transformOrientedRect( rotation, sf::FloatRect( 3, 3, 14, 14 ) );
+    REQUIRE( diamond.center.x == Approx( 10 ) );
+    REQUIRE( diamond.center.y == Approx( 10 ) );
+
+    // Inside its bounds, but out of the diamond.
+    REQUIRE( !intersects( diamond, orientedRect( sf::FloatRect( 0, 0, 3, 3 ) ) ) );
+    REQUIRE( !intersects( orientedRect( sf::FloatRect( 17, 17, 3, 3 ) ), diamond ) );
+
+    REQUIRE( intersects( diamond, orientedRect( sf::FloatRect( 0, 8, 3, 4 ) ) ) );
+    REQUIRE( intersects( diamond, diamond ) );
+}
+
+
+TEST_CASE( "Degenerated oriented rects intersect nothing" )
+{
+    const OrientedRect line = orientedRect( sf::FloatRect( 0, 5, 10, 0 ) );
+    REQUIRE( !intersects( line, orientedRect( sf::FloatRect( 0, 0, 10, 10 ) ) ) );
+}
+
+} // namespace m2g
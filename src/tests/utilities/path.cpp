@@ -0,0 +1,42 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/path.hpp"
+
+namespace m2g {
+
+TEST_CASE( "getDirPath returns the directory of a file" )
+{
+    REQUIRE( getDirPath( "data/library.xml" ) == "data" );
+    REQUIRE( getDirPath( "/data/images/tileset.png" ) == "/data/images" );
+    REQUIRE( getDirPath( "library.xml" ) == "." );
+}
+
+
+TEST_CASE( "resolvePath resolves paths relative to a file" )
+{
+    REQUIRE( resolvePath( "data/library.xml", "tileset.png" ) == "data/tileset.png" );
+    REQUIRE( resolvePath( "data/library.xml", "../images/./tileset.png" ) == "images/tileset.png" );
+    REQUIRE( resolvePath( "data/library.xml", "/images/tileset.png" ) == "/images/tileset.png" );
+    REQUIRE( resolvePath( "data/./library.xml", "" ) == "data/library.xml" );
+    REQUIRE( resolvePath( "library.xml", "../tileset.png" ) == "../tileset.png" );
+}
+
+} // namespace m2g
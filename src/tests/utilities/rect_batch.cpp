@@ -0,0 +1,123 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/rect_batch.hpp"
+#include <stdexcept>
+
+namespace m2g {
+
+TEST_CASE( "RectBatch stores normalized rects" )
+{
+    RectBatch rects;
+    REQUIRE( rects.empty() );
+
+    rects.push_back( sf::FloatRect( 10, 20, 30, 40 ) );
+    rects.push_back( sf::FloatRect( 10, 20, -5, -10 ) );
+
+    REQUIRE( rects.size() == 2 );
+    REQUIRE( rects.paddedSize() % RECT_BATCH_PADDING == 0 );
+    REQUIRE( rects.rect( 0 ) == sf::FloatRect( 10, 20, 30, 40 ) );
+    REQUIRE( rects.rect( 1 ) == sf::FloatRect( 5, 10, 5, 10 ) );
+    REQUIRE_THROWS_AS( rects.rect( 2 ), std::out_of_range );
+
+    rects.clear();
+    REQUIRE( rects.size() == 0 );
+}
+
+
+TEST_CASE( "Rect batch kernels agree with sf::FloatRect::intersects" )
+{
+    // Enough rects to cover every lane width and a partial last block, some
+    // of them with zero width or height.
+    RectBatch rects;
+    std::vector< sf::FloatRect > plainRects;
+    for( unsigned int i = 0; i < 37; i++ ){
+        const sf::FloatRect rect( ( i * 37 ) % 100, ( i * 91 ) % 100,
+                                  ( i % 9 == 4 ) ? 0 : 5 + i % 7,
+                                  ( i % 11 == 7 ) ? 0 : 5 + i % 5 );
+        rects.push_back( rect );
+        plainRects.push_back( rect );
+    }
+
+    const sf::Vector2f querySizes[] =
+    {
+        sf::Vector2f( 4, 6 ),
+        sf::Vector2f( 0, 6 ),
+        sf::Vector2f( 4, 0 )
+    };
+    for( const sf::Vector2f& querySize : querySizes ){
+        for( int x = -10; x < 110; x += 3 ){
+            for( int y = -10; y < 110; y += 3 ){
+                const sf::FloatRect query( x, y, querySize.x, querySize.y );
+                unsigned int expected = plainRects.size();
+                for( unsigned int i = 0; i < plainRects.size() && expected == plainRects.size(); i++ ){
+                    if( query.intersects( plainRects[i] ) ){
+                        expected = i;
+                    }
+                }
+                REQUIRE( findIntersection( query, rects ) == expected );
+            }
+        }
+    }
+}
+
+
+TEST_CASE( "Empty rects don't intersect in a rect batch" )
+{
+    RectBatch rects;
+    rects.push_back( sf::FloatRect( 0, 0, 10, 10 ) );
+
+    REQUIRE( !intersectsAny( sf::FloatRect( 5, 5, 0, 4 ), rects ) );
+    REQUIRE( !intersectsAny( sf::FloatRect( 5, 5, 4, 0 ), rects ) );
+
+    RectBatch emptyRects;
+    emptyRects.push_back( sf::FloatRect( 5, 5, 0, 4 ) );
+    emptyRects.push_back( sf::FloatRect( 5, 5, 4, 0 ) );
+    REQUIRE( !intersectsAny( sf::FloatRect( 0, 0, 10, 10 ), emptyRects ) );
+}
+
+
+TEST_CASE( "Touching rects don't intersect in a rect batch" )
+{
+    RectBatch rects;
+    rects.push_back( sf::FloatRect( 0, 0, 10, 10 ) );
+
+    REQUIRE( !intersectsAny( sf::FloatRect( 10, 0, 10, 10 ), rects ) );
+    REQUIRE( !intersectsAny( sf::FloatRect( 0, -10, 10, 10 ), rects ) );
+    REQUIRE( intersectsAny( sf::FloatRect( 9, 9, 10, 10 ), rects ) );
+    REQUIRE( !intersectsAny( sf::FloatRect( 0, 0, 10, 10 ), RectBatch() ) );
+}
+
+
+TEST_CASE( "Rect batches can be tested against each other" )
+{
+    RectBatch a, b;
+    a.push_back( sf::FloatRect( 0, 0, 10, 10 ) );
+    a.push_back( sf::FloatRect( 50, 50, 10, 10 ) );
+    b.push_back( sf::FloatRect( 20, 20, 10, 10 ) );
+
+    REQUIRE( !intersectsAny( a, b ) );
+
+    b.push_back( sf::FloatRect( 55, 45, 2, 10 ) );
+    REQUIRE( intersectsAny( a, b ) );
+    REQUIRE( intersectsAny( b, a ) );
+}
+
+} // namespace m2g
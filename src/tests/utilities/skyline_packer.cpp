@@ -0,0 +1,100 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/skyline_packer.hpp"
+#include <vector>
+
+namespace m2g {
+
+TEST_CASE( "SkylinePacker places the first rect at the origin" )
+{
+    SkylinePacker packer( 64, 64 );
+    sf::Vector2u position;
+
+    REQUIRE( packer.insert( 16, 32, position ) );
+    REQUIRE( position == sf::Vector2u( 0, 0 ) );
+    REQUIRE( packer.usedArea() == 16 * 32 );
+}
+
+
+TEST_CASE( "SkylinePacker fills a page with equally sized rects" )
+{
+    SkylinePacker packer( 64, 64 );
+    sf::Vector2u position;
+
+    for( unsigned int i = 0; i < 16; i++ ){
+        REQUIRE( packer.insert( 16, 16, position ) );
+    }
+
+    REQUIRE( packer.occupancy() == 1.0f );
+    REQUIRE( packer.insert( 1, 1, position ) == false );
+}
+
+
+TEST_CASE( "SkylinePacker never overlaps rects" )
+{
+    SkylinePacker packer( 128, 128 );
+    std::vector< sf::IntRect > rects;
+    const unsigned int sizes[][2] =
+    {
+        { 40, 30 }, { 20, 50 }, { 64, 16 }, { 10, 10 }, { 33, 47 },
+        { 25, 25 }, { 70, 12 }, { 8, 60 }, { 30, 30 }, { 16, 16 }
+    };
+
+    for( const auto& size : sizes ){
+        sf::Vector2u position;
+        REQUIRE( packer.insert( size[0], size[1], position ) );
+        REQUIRE( position.x + size[0] <= 128 );
+        REQUIRE( position.y + size[1] <= 128 );
+        rects.push_back( sf::IntRect( position.x, position.y, size[0], size[1] ) );
+    }
+
+    for( unsigned int i = 0; i < rects.size(); i++ ){
+        for( unsigned int j = i + 1; j < rects.size(); j++ ){
+            REQUIRE( rects[i].intersects( rects[j] ) == false );
+        }
+    }
+}
+
+
+TEST_CASE( "SkylinePacker rejects rects bigger than the page" )
+{
+    SkylinePacker packer( 64, 64 );
+    sf::Vector2u position;
+
+    REQUIRE( packer.insert( 65, 1, position ) == false );
+    REQUIRE( packer.insert( 1, 65, position ) == false );
+}
+
+
+TEST_CASE( "SkylinePacker::clear() empties the page" )
+{
+    SkylinePacker packer( 32, 32 );
+    sf::Vector2u position;
+
+    REQUIRE( packer.insert( 32, 32, position ) );
+    packer.clear();
+
+    REQUIRE( packer.usedArea() == 0 );
+    REQUIRE( packer.insert( 32, 32, position ) );
+    REQUIRE( position == sf::Vector2u( 0, 0 ) );
+}
+
+} // namespace m2g
@@ -0,0 +1,123 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/stats.hpp"
+#include "../../drawables/tileset.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace m2g {
+
+TEST_CASE( "Stats counters can be reset when taking a snapshot" )
+{
+    Stats::snapshot( true );
+
+    Stats::increment( STAT_SPRITE_COLLIDES );
+    Stats::increment( STAT_SPRITE_COLLIDES, 4 );
+
+    REQUIRE( Stats::snapshot().counters[STAT_SPRITE_COLLIDES] == 5 );
+    REQUIRE( Stats::snapshot( true ).counters[STAT_SPRITE_COLLIDES] == 5 );
+    REQUIRE( Stats::snapshot().counters[STAT_SPRITE_COLLIDES] == 0 );
+}
+
+
+TEST_CASE( "StatContribution is accounted while it and its copies live" )
+{
+    const std::int64_t initialValue = Stats::snapshot().gauges[STAT_COLLISION_RECTS];
+    {
+        StatContribution contribution( STAT_COLLISION_RECTS, 2 );
+        contribution.add( 1 );
+        REQUIRE( Stats::snapshot().gauges[STAT_COLLISION_RECTS] == initialValue + 3 );
+        {
+            StatContribution copy( contribution );
+            REQUIRE( Stats::snapshot().gauges[STAT_COLLISION_RECTS] == initialValue + 6 );
+
+            copy = StatContribution( STAT_COLLISION_RECTS, 1 );
+            REQUIRE( Stats::snapshot().gauges[STAT_COLLISION_RECTS] == initialValue + 4 );
+        }
+        REQUIRE( Stats::snapshot().gauges[STAT_COLLISION_RECTS] == initialValue + 3 );
+    }
+    REQUIRE( Stats::snapshot().gauges[STAT_COLLISION_RECTS] == initialValue );
+}
+
+
+TEST_CASE( "Tilesets feed the stats registry" )
+{
+    const StatsSnapshot initialStats = Stats::snapshot();
+    {
+        Tileset tileset( "data/tileset_w64_h64.png", 32, 32 );
+        tileset.addCollisionRect( sf::IntRect( 0, 0, 4, 4 ) );
+        tileset.addCollisionRect( sf::IntRect( 4, 4, 4, 4 ), 0, 1 );
+
+        const StatsSnapshot stats = Stats::snapshot();
+        REQUIRE( stats.counters[STAT_TILESETS_LOADED] == initialStats.counters[STAT_TILESETS_LOADED] + 1 );
+        REQUIRE( stats.gauges[STAT_TILESETS] == initialStats.gauges[STAT_TILESETS] + 1 );
+        REQUIRE( stats.gauges[STAT_TEXTURES] == initialStats.gauges[STAT_TEXTURES] + 1 );
+        REQUIRE( stats.gauges[STAT_TEXTURE_BYTES] == initialStats.gauges[STAT_TEXTURE_BYTES] + 64 * 64 * 4 );
+        REQUIRE( stats.gauges[STAT_COLLISION_RECTS] == initialStats.gauges[STAT_COLLISION_RECTS] + 2 );
+
+        // Copies share the contents until they are modified.
+        Tileset copy( tileset );
+        REQUIRE( Stats::snapshot().gauges[STAT_TILESETS] == initialStats.gauges[STAT_TILESETS] + 1 );
+        copy.addCollisionRect( sf::IntRect( 0, 0, 8, 8 ) );
+        REQUIRE( Stats::snapshot().gauges[STAT_TILESETS] == initialStats.gauges[STAT_TILESETS] + 2 );
+    }
+
+    const StatsSnapshot stats = Stats::snapshot();
+    REQUIRE( stats.gauges[STAT_TILESETS] == initialStats.gauges[STAT_TILESETS] );
+    REQUIRE( stats.gauges[STAT_TEXTURES] == initialStats.gauges[STAT_TEXTURES] );
+    REQUIRE( stats.gauges[STAT_TEXTURE_BYTES] == initialStats.gauges[STAT_TEXTURE_BYTES] );
+    REQUIRE( stats.gauges[STAT_COLLISION_RECTS] == initialStats.gauges[STAT_COLLISION_RECTS] );
+}
+
+
+TEST_CASE( "Stats snapshots are written as JSON" )
+{
+    std::ostringstream out;
+    Stats::snapshot().writeJSON( out );
+
+    REQUIRE( out.str().front() == '{' );
+    REQUIRE( out.str().back() == '}' );
+    for( unsigned int i = 0; i < N_STAT_COUNTERS; i++ ){
+        REQUIRE( out.str().find( Stats::name( static_cast< StatCounter >( i ) ) ) != std::string::npos );
+    }
+    for( unsigned int i = 0; i < N_STAT_GAUGES; i++ ){
+        REQUIRE( out.str().find( Stats::name( static_cast< StatGauge >( i ) ) ) != std::string::npos );
+    }
+}
+
+
+TEST_CASE( "StatsDumper writes at least one snapshot" )
+{
+    const std::string filePath = "data/stats_dump.json";
+    std::remove( filePath.c_str() );
+    {
+        StatsDumper dumper( filePath, 1 );
+    }
+
+    std::ifstream file( filePath );
+    std::string line;
+    REQUIRE( std::getline( file, line ) );
+    REQUIRE( line.find( "\"textures\":" ) != std::string::npos );
+    std::remove( filePath.c_str() );
+}
+
+} // namespace m2g
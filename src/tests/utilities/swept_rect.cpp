@@ -0,0 +1,71 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/swept_rect.hpp"
+
+namespace m2g {
+
+TEST_CASE( "sweepRect finds when a moving rect first hits a target" )
+{
+    const sf::FloatRect wall( 100, 0, 2, 100 );
+    SweepHit hit;
+
+    // Going through the wall in a single step.
+    REQUIRE( sweepRect( sf::FloatRect( 0, 40, 10, 10 ), sf::Vector2f( 200, 0 ), wall, hit ) );
+    REQUIRE( hit.time == Approx( 0.45f ) );
+    REQUIRE( hit.normal == sf::Vector2f( -1, 0 ) );
+
+    // Coming back from the other side.
+    REQUIRE( sweepRect( sf::FloatRect( 150, 40, 10, 10 ), sf::Vector2f( -100, 0 ), wall, hit ) );
+    REQUIRE( hit.time == Approx( 0.48f ) );
+    REQUIRE( hit.normal == sf::Vector2f( 1, 0 ) );
+
+    // Falling onto it.
+    REQUIRE( sweepRect( sf::FloatRect( 95, -20, 10, 10 ), sf::Vector2f( 0, 20 ), wall, hit ) );
+    REQUIRE( hit.time == Approx( 0.5f ) );
+    REQUIRE( hit.normal == sf::Vector2f( 0, -1 ) );
+}
+
+
+TEST_CASE( "sweepRect misses targets out of the way" )
+{
+    const sf::FloatRect wall( 100, 0, 2, 100 );
+    SweepHit hit;
+
+    // Stopping short, passing over, and sliding along the wall.
+    REQUIRE( !sweepRect( sf::FloatRect( 0, 40, 10, 10 ), sf::Vector2f( 90, 0 ), wall, hit ) );
+    REQUIRE( !sweepRect( sf::FloatRect( 0, -40, 10, 10 ), sf::Vector2f( 200, 20 ), wall, hit ) );
+    REQUIRE( !sweepRect( sf::FloatRect( 90, 0, 10, 10 ), sf::Vector2f( 0, 50 ), wall, hit ) );
+
+    // Moving away.
+    REQUIRE( !sweepRect( sf::FloatRect( 0, 40, 10, 10 ), sf::Vector2f( -50, 0 ), wall, hit ) );
+}
+
+
+TEST_CASE( "sweepRect reports rects already intersecting at time 0" )
+{
+    SweepHit hit;
+    REQUIRE( sweepRect( sf::FloatRect( 0, 0, 10, 10 ), sf::Vector2f( 5, 5 ),
+                        sf::FloatRect( 5, 5, 10, 10 ), hit ) );
+    REQUIRE( hit.time == 0.0f );
+    REQUIRE( hit.normal == sf::Vector2f( 0, 0 ) );
+}
+
+} // namespace m2g
@@ -0,0 +1,62 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/thread_pool.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace m2g {
+
+TEST_CASE( "ThreadPool runs every task once" )
+{
+    const unsigned int nThreads[] = { 1, 2, 4 };
+    for( unsigned int n : nThreads ){
+        ThreadPool pool( n );
+        REQUIRE( pool.nThreads() == n );
+
+        // Several batches reuse the same workers.
+        for( unsigned int batch = 0; batch < 10; batch++ ){
+            std::vector< unsigned int > runs( 1000, 0 );
+            pool.run( runs.size(), [&]( unsigned int i ){
+                runs[i]++;
+            });
+            REQUIRE( std::count( runs.begin(), runs.end(), 1u ) == 1000 );
+        }
+    }
+}
+
+
+TEST_CASE( "ThreadPool rethrows the exceptions of its tasks" )
+{
+    ThreadPool pool( 4 );
+
+    REQUIRE_THROWS_AS( pool.run( 100, []( unsigned int i ){
+        if( i == 50 ){
+            throw std::runtime_error( "Task failed" );
+        }
+    }), std::runtime_error );
+
+    // The pool is still usable afterwards.
+    std::atomic< unsigned int > nRuns( 0 );
+    pool.run( 100, [&]( unsigned int ){ nRuns++; } );
+    REQUIRE( nRuns == 100 );
+}
+
+} // namespace m2g
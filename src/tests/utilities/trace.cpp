@@ -0,0 +1,127 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include <catch.hpp>
+#include "../../utilities/trace.hpp"
+#include <sstream>
+#include <thread>
+
+namespace m2g {
+
+unsigned int countOccurrences( const std::string& str, const std::string& substr )
+{
+    unsigned int n = 0;
+    std::size_t pos = str.find( substr );
+    while( pos != std::string::npos ){
+        n++;
+        pos = str.find( substr, pos + substr.size() );
+    }
+    return n;
+}
+
+
+std::string chromeTrace()
+{
+    std::ostringstream out;
+    Trace::writeChromeTrace( out );
+    return out.str();
+}
+
+
+TEST_CASE( "TraceScope records a complete event when destroyed" )
+{
+    Trace::clear();
+    {
+        TraceScope scope( "test_zone" );
+        REQUIRE( countOccurrences( chromeTrace(), "test_zone" ) == 0 );
+    }
+
+    const std::string trace = chromeTrace();
+    REQUIRE( trace.find( "{\"traceEvents\":[" ) == 0 );
+    REQUIRE( countOccurrences( trace, "\"name\":\"test_zone\"" ) == 1 );
+    REQUIRE( countOccurrences( trace, "\"ph\":\"X\"" ) == 1 );
+}
+
+
+TEST_CASE( "Trace::clear discards the recorded events" )
+{
+    Trace::record( "cleared_zone", Trace::now(), 10 );
+    REQUIRE( countOccurrences( chromeTrace(), "cleared_zone" ) == 1 );
+
+    Trace::clear();
+
+    REQUIRE( countOccurrences( chromeTrace(), "\"ph\"" ) == 0 );
+}
+
+
+TEST_CASE( "Trace keeps only the latest events of every thread" )
+{
+    Trace::clear();
+    for( unsigned int i = 0; i < TRACE_BUFFER_CAPACITY + 10; i++ ){
+        Trace::record( ( i < 10 ) ? "old_zone" : "new_zone", i, 1 );
+    }
+
+    // The oldest slot may be being overwritten by the (still running)
+    // thread, so it is skipped too.
+    const std::string trace = chromeTrace();
+    REQUIRE( countOccurrences( trace, "old_zone" ) == 0 );
+    REQUIRE( countOccurrences( trace, "new_zone" ) == TRACE_BUFFER_CAPACITY - 1 );
+}
+
+
+TEST_CASE( "Trace records every thread with its own tid" )
+{
+    Trace::clear();
+    Trace::record( "main_thread_zone", Trace::now(), 1 );
+    std::thread thread( [](){
+        TraceScope scope( "worker_thread_zone" );
+    });
+    thread.join();
+
+    const std::string trace = chromeTrace();
+    const std::size_t mainPos = trace.find( "main_thread_zone" );
+    const std::size_t workerPos = trace.find( "worker_thread_zone" );
+    REQUIRE( mainPos != std::string::npos );
+    REQUIRE( workerPos != std::string::npos );
+
+    const std::string tidKey = "\"tid\":";
+    const std::string mainTid =
+            trace.substr( trace.find( tidKey, mainPos ) + tidKey.size(), 2 );
+    const std::string workerTid =
+            trace.substr( trace.find( tidKey, workerPos ) + tidKey.size(), 2 );
+    REQUIRE( mainTid != workerTid );
+}
+
+
+TEST_CASE( "Trace exports the events of exited threads once" )
+{
+    Trace::clear();
+    std::thread thread( [](){
+        for( unsigned int i = 0; i < TRACE_BUFFER_CAPACITY; i++ ){
+            Trace::record( "exited_thread_zone", i, 1 );
+        }
+    });
+    thread.join();
+
+    // Nothing can overwrite them anymore, so all of them are kept.
+    REQUIRE( countOccurrences( chromeTrace(), "exited_thread_zone" ) == TRACE_BUFFER_CAPACITY );
+    REQUIRE( countOccurrences( chromeTrace(), "exited_thread_zone" ) == 0 );
+}
+
+} // namespace m2g
@@ -0,0 +1,53 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "../atlas_packer.hpp"
+#include <iostream>
+#include <cstdlib>
+
+int main( int argc, char* argv[] )
+{
+    if( argc < 3 || argc > 5 ){
+        std::cerr << "Usage: " << argv[0]
+                  << " <library.xml> <output_library.xml> [page_size] [padding]"
+                  << std::endl;
+        return 1;
+    }
+
+    unsigned int pageSize = m2g::DEFAULT_ATLAS_PAGE_SIZE;
+    unsigned int padding = m2g::DEFAULT_ATLAS_PADDING;
+    if( argc > 3 ){
+        pageSize = atoi( argv[3] );
+    }
+    if( argc > 4 ){
+        padding = atoi( argv[4] );
+    }
+
+    try{
+        m2g::AtlasPacker atlasPacker( pageSize, padding );
+        const unsigned int nPages = atlasPacker.pack( argv[1], argv[2] );
+
+        std::cout << argv[2] << ": " << nPages << " atlas page(s)" << std::endl;
+    }catch( std::exception& ex ){
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
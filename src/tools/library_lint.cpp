@@ -0,0 +1,54 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "../graphics_library.hpp"
+#include <future>
+#include <iostream>
+#include <vector>
+
+int main( int argc, char* argv[] )
+{
+    if( argc < 2 ){
+        std::cerr << "Usage: " << argv[0] << " <library.xml> [<library.xml> ...]"
+                  << std::endl;
+        return 1;
+    }
+
+    // Libraries are validated in parallel (and so are their files).
+    std::vector< std::future< std::vector< std::string > > > results;
+    for( int i = 1; i < argc; i++ ){
+        results.push_back( std::async( std::launch::async,
+                                       &m2g::GraphicsLibrary::validate,
+                                       std::string( argv[i] ) ) );
+    }
+
+    unsigned int nErrors = 0;
+    for( int i = 1; i < argc; i++ ){
+        for( const std::string& error : results[i - 1].get() ){
+            std::cerr << argv[i] << ": " << error << std::endl;
+            nErrors++;
+        }
+    }
+
+    if( nErrors > 0 ){
+        std::cerr << nErrors << " error(s)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef CACHE_SLOT_HPP
+#define CACHE_SLOT_HPP
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace m2g {
+
+// Thread-safe cache of a single value, for callers which already know which
+// entry they want (ie. an array of slots indexed by handle). Getting a
+// cached value takes none of the slot mutexes. Concurrent requests of a
+// value being loaded wait for that load instead of repeating it; if it
+// throws, the next request tries to load it again.
+template < class Value >
+class CacheSlot
+{
+    public:
+        typedef std::shared_ptr< Value > ValuePtr;
+        typedef std::function< ValuePtr() > Loader;
+
+
+        /***
+         * 1. Construction
+         ***/
+        CacheSlot();
+        CacheSlot( const CacheSlot& ) = delete;
+        CacheSlot& operator = ( const CacheSlot& ) = delete;
+
+
+        /***
+         * 2. Getters
+         ***/
+        ValuePtr get( const Loader& load );
+
+        // Returns nullptr if the value isn't cached. Never waits for a load.
+        ValuePtr find() const;
+
+
+        /***
+         * 3. Cache management
+         ***/
+        // Loads already running when the slot is cleared don't cache their
+        // value. Readers still holding the old value keep it alive.
+        void clear();
+
+
+    private:
+        /***
+         * Attributes
+         ***/
+        // Published value, only accessed through std::atomic_load() and
+        // std::atomic_store(). The shared_ptr reference count frees the old
+        // value once its last reader drops it, so replacing it never waits.
+        ValuePtr value_;
+
+        unsigned int generation_;
+        std::mutex valueMutex_;
+
+        // Held while loading.
+        std::mutex loadMutex_;
+};
+
+
+/***
+ * 1. Construction
+ ***/
+
+template < class Value >
+CacheSlot< Value >::CacheSlot() :
+    generation_( 0 )
+{}
+
+
+/***
+ * 2. Getters
+ ***/
+
+template < class Value >
+typename CacheSlot< Value >::ValuePtr CacheSlot< Value >::get( const Loader& load )
+{
+    ValuePtr value = find();
+    if( value != nullptr ){
+        return value;
+    }
+
+    std::lock_guard< std::mutex > loadLock( loadMutex_ );
+    unsigned int generation;
+    {
+        std::lock_guard< std::mutex > lock( valueMutex_ );
+        value = std::atomic_load( &value_ );
+        if( value != nullptr ){
+            return value;
+        }
+        generation = generation_;
+    }
+
+    value = load();
+
+    std::lock_guard< std::mutex > lock( valueMutex_ );
+    if( generation == generation_ ){
+        std::atomic_store( &value_, value );
+    }
+    return value;
+}
+
+
+template < class Value >
+typename CacheSlot< Value >::ValuePtr CacheSlot< Value >::find() const
+{
+    return std::atomic_load( &value_ );
+}
+
+
+/***
+ * 3. Cache management
+ ***/
+
+template < class Value >
+void CacheSlot< Value >::clear()
+{
+    std::lock_guard< std::mutex > lock( valueMutex_ );
+    generation_++;
+    std::atomic_store( &value_, ValuePtr() );
+}
+
+} // namespace m2g
+
+#endif // CACHE_SLOT_HPP
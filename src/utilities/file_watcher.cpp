@@ -0,0 +1,141 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "file_watcher.hpp"
+#include <stdexcept>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace m2g {
+
+/***
+ * 1. Construction
+ ***/
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher() :
+    fd_( inotify_init1( IN_NONBLOCK | IN_CLOEXEC ) )
+{
+    if( fd_ < 0 ){
+        throw std::runtime_error( std::string( "Couldn't initialize inotify: " ) +
+                                  std::strerror( errno ) );
+    }
+}
+
+#else
+
+FileWatcher::FileWatcher() :
+    fd_( -1 )
+{
+    throw std::runtime_error( "File watching is only supported on Linux" );
+}
+
+#endif
+
+
+/***
+ * 2. Destruction
+ ***/
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+    close( fd_ );
+#endif
+}
+
+
+/***
+ * 3. Watching
+ ***/
+
+void FileWatcher::watch( const std::string& filePath )
+{
+    if( filePaths_.count( filePath ) ){
+        return;
+    }
+
+    std::string dirPath = ".";
+    std::string fileName = filePath;
+    const std::size_t lastSlash = filePath.rfind( '/' );
+    if( lastSlash != std::string::npos ){
+        dirPath = ( lastSlash == 0 ) ? "/" : filePath.substr( 0, lastSlash );
+        fileName = filePath.substr( lastSlash + 1 );
+    }
+
+#ifdef __linux__
+    // Watching an already watched directory returns its descriptor.
+    const int wd = inotify_add_watch( fd_, dirPath.c_str(),
+                                      IN_CLOSE_WRITE | IN_MOVED_TO );
+    if( wd < 0 ){
+        throw std::runtime_error( "Couldn't watch directory [" + dirPath + "]: " +
+                                  std::strerror( errno ) );
+    }
+    dirs_[wd].files[fileName] = filePath;
+#endif
+    filePaths_.insert( filePath );
+}
+
+
+bool FileWatcher::watches( const std::string& filePath ) const
+{
+    return filePaths_.count( filePath ) != 0;
+}
+
+
+/***
+ * 4. Polling
+ ***/
+
+std::vector< std::string > FileWatcher::changedFiles()
+{
+    std::set< std::string > changed;
+
+#ifdef __linux__
+    alignas( inotify_event ) char buffer[4096];
+    ssize_t length;
+    while( ( length = read( fd_, buffer, sizeof( buffer ) ) ) > 0 ){
+        ssize_t offset = 0;
+        while( offset < length ){
+            const inotify_event* event =
+                    reinterpret_cast< const inotify_event* >( buffer + offset );
+            offset += sizeof( inotify_event ) + event->len;
+
+            auto dir = dirs_.find( event->wd );
+            if( dir == dirs_.end() || event->len == 0 ){
+                continue;
+            }
+            auto file = dir->second.files.find( event->name );
+            if( file != dir->second.files.end() ){
+                changed.insert( file->second );
+            }
+        }
+    }
+#endif
+
+    return std::vector< std::string >( changed.begin(), changed.end() );
+}
+
+} // namespace m2g
@@ -0,0 +1,84 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef FILE_WATCHER_HPP
+#define FILE_WATCHER_HPP
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace m2g {
+
+// Reports the watched files that were written or replaced since
+// the last query. Directories are watched rather than files, so editors
+// saving through a temporary file and a rename are also reported.
+// Implemented with inotify, so it is only available on Linux.
+class FileWatcher
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        FileWatcher();
+        FileWatcher( const FileWatcher& ) = delete;
+        FileWatcher& operator = ( const FileWatcher& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~FileWatcher();
+
+
+        /***
+         * 3. Watching
+         ***/
+        void watch( const std::string& filePath );
+        bool watches( const std::string& filePath ) const;
+
+
+        /***
+         * 4. Polling
+         ***/
+        // Returns (as given to watch()) the watched files which changed since
+        // the previous call. Never blocks.
+        std::vector< std::string > changedFiles();
+
+
+    private:
+        struct WatchedDir
+        {
+            // File name -> path given to watch().
+            std::map< std::string, std::string > files;
+        };
+
+
+        /***
+         * Attributes
+         ***/
+        int fd_;
+        std::map< int, WatchedDir > dirs_;
+        std::set< std::string > filePaths_;
+};
+
+} // namespace m2g
+
+#endif // FILE_WATCHER_HPP
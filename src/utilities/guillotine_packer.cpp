@@ -0,0 +1,192 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "guillotine_packer.hpp"
+#include <limits>
+
+namespace m2g {
+
+/***
+ * 1. Construction
+ ***/
+
+GuillotinePacker::GuillotinePacker( unsigned int width, unsigned int height ) :
+    dimensions_( width, height )
+{
+    clear();
+}
+
+
+/***
+ * 2. Getters
+ ***/
+
+sf::Vector2u GuillotinePacker::dimensions() const
+{
+    return dimensions_;
+}
+
+
+unsigned int GuillotinePacker::usedArea() const
+{
+    return usedArea_;
+}
+
+
+unsigned int GuillotinePacker::nFreeRects() const
+{
+    return freeRects_.size();
+}
+
+
+bool GuillotinePacker::empty() const
+{
+    return ( usedArea_ == 0 );
+}
+
+
+/***
+ * 3. Packing
+ ***/
+
+bool GuillotinePacker::insert( unsigned int width,
+                               unsigned int height,
+                               sf::Vector2u& position )
+{
+    // Best area fit: the free rect which leaves the least space unused.
+    unsigned int bestIndex = freeRects_.size();
+    unsigned int bestLeftover = std::numeric_limits< unsigned int >::max();
+
+    for( unsigned int i = 0; i < freeRects_.size(); i++ ){
+        const sf::IntRect& freeRect = freeRects_[i];
+        if( static_cast< int >( width ) <= freeRect.width &&
+            static_cast< int >( height ) <= freeRect.height ){
+            const unsigned int leftover =
+                    freeRect.width * freeRect.height - width * height;
+            if( leftover < bestLeftover ){
+                bestIndex = i;
+                bestLeftover = leftover;
+            }
+        }
+    }
+
+    if( bestIndex == freeRects_.size() ){
+        return false;
+    }
+
+    const sf::IntRect freeRect = freeRects_[bestIndex];
+    freeRects_.erase( freeRects_.begin() + bestIndex );
+    position = sf::Vector2u( freeRect.left, freeRect.top );
+
+    // Split along the shorter leftover axis, so the bigger of the two new
+    // free rects is as big as possible.
+    const int leftoverWidth = freeRect.width - width;
+    const int leftoverHeight = freeRect.height - height;
+    sf::IntRect right, bottom;
+    if( leftoverWidth <= leftoverHeight ){
+        right = sf::IntRect( freeRect.left + width, freeRect.top,
+                             leftoverWidth, height );
+        bottom = sf::IntRect( freeRect.left, freeRect.top + height,
+                              freeRect.width, leftoverHeight );
+    }else{
+        right = sf::IntRect( freeRect.left + width, freeRect.top,
+                             leftoverWidth, freeRect.height );
+        bottom = sf::IntRect( freeRect.left, freeRect.top + height,
+                              width, leftoverHeight );
+    }
+
+    if( right.width > 0 && right.height > 0 ){
+        freeRects_.push_back( right );
+    }
+    if( bottom.width > 0 && bottom.height > 0 ){
+        freeRects_.push_back( bottom );
+    }
+
+    usedArea_ += width * height;
+
+    return true;
+}
+
+
+void GuillotinePacker::release( const sf::IntRect& rect )
+{
+    usedArea_ -= rect.width * rect.height;
+
+    if( usedArea_ == 0 ){
+        clear();
+        return;
+    }
+
+    freeRects_.push_back( rect );
+    mergeFreeRects();
+}
+
+
+void GuillotinePacker::clear()
+{
+    freeRects_.clear();
+    freeRects_.push_back( sf::IntRect( 0, 0, dimensions_.x, dimensions_.y ) );
+    usedArea_ = 0;
+}
+
+
+/***
+ * 4. Auxiliar methods
+ ***/
+
+void GuillotinePacker::mergeFreeRects()
+{
+    bool merged = true;
+
+    while( merged ){
+        merged = false;
+        for( unsigned int i = 0; i < freeRects_.size() && !merged; i++ ){
+            for( unsigned int j = i + 1; j < freeRects_.size() && !merged; j++ ){
+                sf::IntRect& a = freeRects_[i];
+                const sf::IntRect& b = freeRects_[j];
+
+                if( a.left == b.left && a.width == b.width ){
+                    if( a.top + a.height == b.top ){
+                        a.height += b.height;
+                        merged = true;
+                    }else if( b.top + b.height == a.top ){
+                        a.top = b.top;
+                        a.height += b.height;
+                        merged = true;
+                    }
+                }else if( a.top == b.top && a.height == b.height ){
+                    if( a.left + a.width == b.left ){
+                        a.width += b.width;
+                        merged = true;
+                    }else if( b.left + b.width == a.left ){
+                        a.left = b.left;
+                        a.width += b.width;
+                        merged = true;
+                    }
+                }
+
+                if( merged ){
+                    freeRects_.erase( freeRects_.begin() + j );
+                }
+            }
+        }
+    }
+}
+
+} // namespace m2g
@@ -0,0 +1,77 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef GUILLOTINE_PACKER_HPP
+#define GUILLOTINE_PACKER_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+#include <vector>
+
+namespace m2g {
+
+// Guillotine rectangle packer with support for releasing rects. Keeps a list
+// of free rects; every insertion takes the free rect which fits best and
+// splits the remaining space in two. Released rects are merged back with
+// their free neighbours.
+class GuillotinePacker
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        GuillotinePacker( unsigned int width, unsigned int height );
+
+
+        /***
+         * 2. Getters
+         ***/
+        sf::Vector2u dimensions() const;
+        unsigned int usedArea() const;
+        unsigned int nFreeRects() const;
+        bool empty() const;
+
+
+        /***
+         * 3. Packing
+         ***/
+        bool insert( unsigned int width,
+                     unsigned int height,
+                     sf::Vector2u& position );
+        void release( const sf::IntRect& rect );
+        void clear();
+
+
+    private:
+        /***
+         * 4. Auxiliar methods
+         ***/
+        void mergeFreeRects();
+
+
+        /***
+         * Attributes
+         ***/
+        sf::Vector2u dimensions_;
+        std::vector< sf::IntRect > freeRects_;
+        unsigned int usedArea_;
+};
+
+} // namespace m2g
+
+#endif // GUILLOTINE_PACKER_HPP
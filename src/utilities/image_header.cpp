@@ -0,0 +1,72 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "image_header.hpp"
+#include <fstream>
+#include <stdexcept>
+
+namespace m2g {
+
+namespace {
+
+// PNG signature followed by the length and type of the IHDR chunk, which
+// is always the first one.
+const unsigned char PNG_HEADER[] =
+{
+    0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n',
+    0x00, 0x00, 0x00, 0x0D, 'I', 'H', 'D', 'R'
+};
+const unsigned int PNG_HEADER_SIZE = sizeof( PNG_HEADER );
+
+
+unsigned int readBigEndian32( const unsigned char* bytes )
+{
+    return ( static_cast< unsigned int >( bytes[0] ) << 24 ) |
+           ( static_cast< unsigned int >( bytes[1] ) << 16 ) |
+           ( static_cast< unsigned int >( bytes[2] ) << 8 ) |
+           static_cast< unsigned int >( bytes[3] );
+}
+
+} // namespace
+
+
+sf::Vector2u readImageSize( const std::string& imagePath )
+{
+    std::ifstream file( imagePath.c_str(), std::ios::binary );
+    if( !file ){
+        throw std::runtime_error( "Couldn't open image [" + imagePath + "]" );
+    }
+
+    // Header followed by IHDR's width and height.
+    unsigned char header[PNG_HEADER_SIZE + 8];
+    file.read( reinterpret_cast< char* >( header ), sizeof( header ) );
+    if( file.gcount() != sizeof( header ) ){
+        throw std::runtime_error( "Image [" + imagePath + "] is truncated" );
+    }
+    for( unsigned int i = 0; i < PNG_HEADER_SIZE; i++ ){
+        if( header[i] != PNG_HEADER[i] ){
+            throw std::runtime_error( "Image [" + imagePath + "] isn't a PNG image" );
+        }
+    }
+
+    return sf::Vector2u( readBigEndian32( header + PNG_HEADER_SIZE ),
+                         readBigEndian32( header + PNG_HEADER_SIZE + 4 ) );
+}
+
+} // namespace m2g
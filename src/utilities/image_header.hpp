@@ -0,0 +1,35 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef IMAGE_HEADER_HPP
+#define IMAGE_HEADER_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include <string>
+
+namespace m2g {
+
+// Reads the dimensions of a PNG image from its header, without decoding
+// it. Throws std::runtime_error if the file can't be read or it isn't a
+// PNG image.
+sf::Vector2u readImageSize( const std::string& imagePath );
+
+} // namespace m2g
+
+#endif // IMAGE_HEADER_HPP
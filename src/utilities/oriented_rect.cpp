@@ -0,0 +1,91 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "oriented_rect.hpp"
+#include <cmath>
+
+namespace m2g {
+
+namespace {
+
+float dot( const sf::Vector2f& a, const sf::Vector2f& b )
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+
+// Returns true if the given axis separates both rects.
+bool separates( const sf::Vector2f& axis, const sf::Vector2f& distance,
+                const OrientedRect& a, const OrientedRect& b )
+{
+    const float radii =
+            std::fabs( dot( a.halfSides[0], axis ) ) +
+            std::fabs( dot( a.halfSides[1], axis ) ) +
+            std::fabs( dot( b.halfSides[0], axis ) ) +
+            std::fabs( dot( b.halfSides[1], axis ) );
+    return std::fabs( dot( distance, axis ) ) >= radii;
+}
+
+} // namespace
+
+
+/***
+ * Construction
+ ***/
+
+OrientedRect orientedRect( const sf::FloatRect& rect )
+{
+    return transformOrientedRect( sf::Transform(), rect );
+}
+
+
+OrientedRect transformOrientedRect( const sf::Transform& transform,
+                                    const sf::FloatRect& rect )
+{
+    const sf::Vector2f topLeft = transform.transformPoint( rect.left, rect.top );
+    const sf::Vector2f topRight =
+            transform.transformPoint( rect.left + rect.width, rect.top );
+    const sf::Vector2f bottomLeft =
+            transform.transformPoint( rect.left, rect.top + rect.height );
+
+    OrientedRect orientedRect;
+    orientedRect.halfSides[0] = ( topRight - topLeft ) * 0.5f;
+    orientedRect.halfSides[1] = ( bottomLeft - topLeft ) * 0.5f;
+    orientedRect.center = topLeft + orientedRect.halfSides[0] + orientedRect.halfSides[1];
+    return orientedRect;
+}
+
+
+/***
+ * Intersection
+ ***/
+
+bool intersects( const OrientedRect& a, const OrientedRect& b )
+{
+    // Two rects are disjoint if and only if one of their four side
+    // directions separates them. Degenerated rects (null sides) never
+    // intersect anything.
+    const sf::Vector2f distance = b.center - a.center;
+    return !separates( a.halfSides[0], distance, a, b ) &&
+            !separates( a.halfSides[1], distance, a, b ) &&
+            !separates( b.halfSides[0], distance, a, b ) &&
+            !separates( b.halfSides[1], distance, a, b );
+}
+
+} // namespace m2g
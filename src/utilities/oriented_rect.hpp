@@ -0,0 +1,57 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef ORIENTED_RECT_HPP
+#define ORIENTED_RECT_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Transform.hpp>
+
+namespace m2g {
+
+// Rect rotated around its center. Sides are given as half edge vectors
+// (from the center to the middle of two adjacent sides), which don't need
+// to be normalized for separating axis tests.
+struct OrientedRect
+{
+    sf::Vector2f center;
+    sf::Vector2f halfSides[2];
+};
+
+
+/***
+ * Construction
+ ***/
+OrientedRect orientedRect( const sf::FloatRect& rect );
+// The transform must keep right angles (translations, rotations and
+// scales, as the ones of sf::Transformable).
+OrientedRect transformOrientedRect( const sf::Transform& transform,
+                                    const sf::FloatRect& rect );
+
+
+/***
+ * Intersection
+ ***/
+// Separating axis test. As sf::FloatRect::intersects(), rects only touching
+// each other don't intersect.
+bool intersects( const OrientedRect& a, const OrientedRect& b );
+
+} // namespace m2g
+
+#endif // ORIENTED_RECT_HPP
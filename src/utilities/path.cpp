@@ -0,0 +1,72 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "path.hpp"
+#include <vector>
+
+namespace m2g {
+
+std::string getDirPath( const std::string& path )
+{
+    std::size_t slashPos = path.find_last_of( '/' );
+
+    if( slashPos != std::string::npos ){
+        return path.substr( 0, slashPos );
+    }else{
+        return ".";
+    }
+}
+
+
+std::string resolvePath( const std::string& filePath,
+                         const std::string& relativePath )
+{
+    std::string path = relativePath;
+    if( relativePath.empty() ){
+        path = filePath;
+    }else if( relativePath[0] != '/' ){
+        path = getDirPath( filePath ) + '/' + relativePath;
+    }
+
+    // Remove "." and "dir/.." segments, so every file has a single path.
+    std::vector< std::string > segments;
+    std::size_t begin = 0;
+    while( begin <= path.size() ){
+        std::size_t end = path.find( '/', begin );
+        if( end == std::string::npos ){
+            end = path.size();
+        }
+        const std::string segment = path.substr( begin, end - begin );
+
+        if( segment == ".." && !segments.empty() && segments.back() != ".." && !segments.back().empty() ){
+            segments.pop_back();
+        }else if( segment != "." && ( !segment.empty() || segments.empty() ) ){
+            segments.push_back( segment );
+        }
+        begin = end + 1;
+    }
+
+    std::string normalizedPath;
+    for( std::size_t i = 0; i < segments.size(); i++ ){
+        normalizedPath += ( i > 0 ? "/" : "" ) + segments[i];
+    }
+    return normalizedPath.empty() ? "." : normalizedPath;
+}
+
+} // namespace m2g
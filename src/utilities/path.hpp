@@ -0,0 +1,37 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef PATH_HPP
+#define PATH_HPP
+
+#include <string>
+
+namespace m2g {
+
+// Directory of the given file path ("." if it has none).
+std::string getDirPath( const std::string& path );
+
+// Path of a file referenced as relativePath from filePath (filePath itself
+// if relativePath is empty), normalized so every file has a single path.
+std::string resolvePath( const std::string& filePath,
+                         const std::string& relativePath );
+
+} // namespace m2g
+
+#endif // PATH_HPP
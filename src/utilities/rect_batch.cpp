@@ -0,0 +1,265 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "rect_batch.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#if defined( __AVX512F__ ) || defined( __AVX__ ) || defined( __SSE2__ )
+#include <immintrin.h>
+#endif
+
+namespace m2g {
+
+const float INFINITE = std::numeric_limits< float >::infinity();
+
+/***
+ * 1. Construction
+ ***/
+
+RectBatch::RectBatch() :
+    size_( 0 )
+{}
+
+
+/***
+ * 2. Modifiers
+ ***/
+
+void RectBatch::clear()
+{
+    lefts_.clear();
+    tops_.clear();
+    rights_.clear();
+    bottoms_.clear();
+    size_ = 0;
+}
+
+
+void RectBatch::reserve( unsigned int nRects )
+{
+    const unsigned int paddedSize =
+            ( nRects + RECT_BATCH_PADDING - 1 ) / RECT_BATCH_PADDING * RECT_BATCH_PADDING;
+    lefts_.reserve( paddedSize );
+    tops_.reserve( paddedSize );
+    rights_.reserve( paddedSize );
+    bottoms_.reserve( paddedSize );
+}
+
+
+void RectBatch::push_back( const sf::FloatRect& rect )
+{
+    if( size_ == lefts_.size() ){
+        // Padding rects are inverted (left = +inf, right = -inf), so no
+        // comparison against them succeeds.
+        lefts_.resize( size_ + RECT_BATCH_PADDING, INFINITE );
+        tops_.resize( size_ + RECT_BATCH_PADDING, INFINITE );
+        rights_.resize( size_ + RECT_BATCH_PADDING, -INFINITE );
+        bottoms_.resize( size_ + RECT_BATCH_PADDING, -INFINITE );
+    }
+
+    lefts_[size_] = std::min( rect.left, rect.left + rect.width );
+    tops_[size_] = std::min( rect.top, rect.top + rect.height );
+    rights_[size_] = std::max( rect.left, rect.left + rect.width );
+    bottoms_[size_] = std::max( rect.top, rect.top + rect.height );
+    size_++;
+}
+
+
+/***
+ * 3. Getters
+ ***/
+
+unsigned int RectBatch::size() const
+{
+    return size_;
+}
+
+
+bool RectBatch::empty() const
+{
+    return size_ == 0;
+}
+
+
+sf::FloatRect RectBatch::rect( unsigned int index ) const
+{
+    if( index >= size_ ){
+        throw std::out_of_range( "Rect index out of range" );
+    }
+    return sf::FloatRect( lefts_[index],
+                          tops_[index],
+                          rights_[index] - lefts_[index],
+                          bottoms_[index] - tops_[index] );
+}
+
+
+unsigned int RectBatch::paddedSize() const
+{
+    return lefts_.size();
+}
+
+
+const float* RectBatch::lefts() const
+{
+    return lefts_.data();
+}
+
+
+const float* RectBatch::tops() const
+{
+    return tops_.data();
+}
+
+
+const float* RectBatch::rights() const
+{
+    return rights_.data();
+}
+
+
+const float* RectBatch::bottoms() const
+{
+    return bottoms_.data();
+}
+
+
+/***
+ * Intersection kernels
+ ***/
+
+unsigned int findIntersection( const sf::FloatRect& rect, const RectBatch& rects )
+{
+    const float left = std::min( rect.left, rect.left + rect.width );
+    const float top = std::min( rect.top, rect.top + rect.height );
+    const float right = std::max( rect.left, rect.left + rect.width );
+    const float bottom = std::max( rect.top, rect.top + rect.height );
+
+    const float* lefts = rects.lefts();
+    const float* tops = rects.tops();
+    const float* rights = rects.rights();
+    const float* bottoms = rects.bottoms();
+    const unsigned int paddedSize = rects.paddedSize();
+
+    // Like sf::FloatRect::intersects(), the overlap is computed as
+    // max( lefts ) < min( rights ), so empty rects (either the query or
+    // the batch ones) never intersect. Padding rects are empty too, so any
+    // hit is a real rect.
+#if defined( __AVX512F__ )
+    const __m512 queryLeft = _mm512_set1_ps( left );
+    const __m512 queryTop = _mm512_set1_ps( top );
+    const __m512 queryRight = _mm512_set1_ps( right );
+    const __m512 queryBottom = _mm512_set1_ps( bottom );
+    for( unsigned int i = 0; i < paddedSize; i += 16 ){
+        const __mmask16 mask =
+                _mm512_cmp_ps_mask( _mm512_max_ps( _mm512_loadu_ps( lefts + i ), queryLeft ),
+                                    _mm512_min_ps( _mm512_loadu_ps( rights + i ), queryRight ),
+                                    _CMP_LT_OQ ) &
+                _mm512_cmp_ps_mask( _mm512_max_ps( _mm512_loadu_ps( tops + i ), queryTop ),
+                                    _mm512_min_ps( _mm512_loadu_ps( bottoms + i ), queryBottom ),
+                                    _CMP_LT_OQ );
+        if( mask ){
+            return i + __builtin_ctz( mask );
+        }
+    }
+#elif defined( __AVX__ )
+    const __m256 queryLeft = _mm256_set1_ps( left );
+    const __m256 queryTop = _mm256_set1_ps( top );
+    const __m256 queryRight = _mm256_set1_ps( right );
+    const __m256 queryBottom = _mm256_set1_ps( bottom );
+    for( unsigned int i = 0; i < paddedSize; i += 8 ){
+        const __m256 horizontal =
+                _mm256_cmp_ps( _mm256_max_ps( _mm256_loadu_ps( lefts + i ), queryLeft ),
+                               _mm256_min_ps( _mm256_loadu_ps( rights + i ), queryRight ),
+                               _CMP_LT_OQ );
+        const __m256 vertical =
+                _mm256_cmp_ps( _mm256_max_ps( _mm256_loadu_ps( tops + i ), queryTop ),
+                               _mm256_min_ps( _mm256_loadu_ps( bottoms + i ), queryBottom ),
+                               _CMP_LT_OQ );
+        const int mask = _mm256_movemask_ps( _mm256_and_ps( horizontal, vertical ) );
+        if( mask ){
+            return i + __builtin_ctz( mask );
+        }
+    }
+#elif defined( __SSE2__ )
+    const __m128 queryLeft = _mm_set1_ps( left );
+    const __m128 queryTop = _mm_set1_ps( top );
+    const __m128 queryRight = _mm_set1_ps( right );
+    const __m128 queryBottom = _mm_set1_ps( bottom );
+    for( unsigned int i = 0; i < paddedSize; i += 4 ){
+        const __m128 horizontal =
+                _mm_cmplt_ps( _mm_max_ps( _mm_loadu_ps( lefts + i ), queryLeft ),
+                              _mm_min_ps( _mm_loadu_ps( rights + i ), queryRight ) );
+        const __m128 vertical =
+                _mm_cmplt_ps( _mm_max_ps( _mm_loadu_ps( tops + i ), queryTop ),
+                              _mm_min_ps( _mm_loadu_ps( bottoms + i ), queryBottom ) );
+        const int mask = _mm_movemask_ps( _mm_and_ps( horizontal, vertical ) );
+        if( mask ){
+            return i + __builtin_ctz( mask );
+        }
+    }
+#else
+    for( unsigned int i = 0; i < paddedSize; i++ ){
+        if( std::max( lefts[i], left ) < std::min( rights[i], right ) &&
+                std::max( tops[i], top ) < std::min( bottoms[i], bottom ) ){
+            return i;
+        }
+    }
+#endif
+
+    return rects.size();
+}
+
+
+bool intersectsAny( const sf::FloatRect& rect, const RectBatch& rects )
+{
+    return findIntersection( rect, rects ) < rects.size();
+}
+
+
+bool intersectsAny( const RectBatch& a, const RectBatch& b )
+{
+    // The biggest batch is the one scanned with SIMD.
+    const RectBatch& small = ( a.size() <= b.size() ) ? a : b;
+    const RectBatch& big = ( a.size() <= b.size() ) ? b : a;
+
+    for( unsigned int i = 0; i < small.size(); i++ ){
+        if( intersectsAny( small.rect( i ), big ) ){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+const char* rectBatchInstructionSet()
+{
+#if defined( __AVX512F__ )
+    return "AVX-512";
+#elif defined( __AVX__ )
+    return "AVX";
+#elif defined( __SSE2__ )
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace m2g
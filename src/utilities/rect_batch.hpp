@@ -0,0 +1,97 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef RECT_BATCH_HPP
+#define RECT_BATCH_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+#include <vector>
+
+namespace m2g {
+
+// Rects packed as a structure of arrays (lefts, tops, rights and bottoms),
+// so they can be tested against another rect several at a time with SIMD
+// instructions. Arrays are padded with rects intersecting nothing up to a
+// multiple of RECT_BATCH_PADDING elements.
+class RectBatch
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        RectBatch();
+
+
+        /***
+         * 2. Modifiers
+         ***/
+        void clear();
+        void reserve( unsigned int nRects );
+        void push_back( const sf::FloatRect& rect );
+
+
+        /***
+         * 3. Getters
+         ***/
+        unsigned int size() const;
+        bool empty() const;
+        // Rects with negative dimensions are returned normalized.
+        sf::FloatRect rect( unsigned int index ) const;
+        // Padded arrays, with paddedSize() elements.
+        unsigned int paddedSize() const;
+        const float* lefts() const;
+        const float* tops() const;
+        const float* rights() const;
+        const float* bottoms() const;
+
+
+    private:
+        /***
+         * Attributes
+         ***/
+        std::vector< float > lefts_;
+        std::vector< float > tops_;
+        std::vector< float > rights_;
+        std::vector< float > bottoms_;
+        unsigned int size_;
+};
+
+// Widest SIMD lane count any kernel reads at once.
+const unsigned int RECT_BATCH_PADDING = 16;
+
+
+/***
+ * Intersection kernels
+ ***/
+// Intersections follow sf::FloatRect::intersects(): rects only touching
+// each other don't intersect.
+
+// Returns the index of the first rect in the batch intersecting the given
+// one, or rects.size() if there is none.
+unsigned int findIntersection( const sf::FloatRect& rect, const RectBatch& rects );
+bool intersectsAny( const sf::FloatRect& rect, const RectBatch& rects );
+bool intersectsAny( const RectBatch& a, const RectBatch& b );
+
+// Instruction set the kernels were compiled for ("AVX-512", "AVX", "SSE2"
+// or "scalar"). Build with NATIVE=1 to target the building machine.
+const char* rectBatchInstructionSet();
+
+} // namespace m2g
+
+#endif // RECT_BATCH_HPP
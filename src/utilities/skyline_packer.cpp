@@ -0,0 +1,169 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "skyline_packer.hpp"
+#include <limits>
+
+namespace m2g {
+
+/***
+ * 1. Construction
+ ***/
+
+SkylinePacker::SkylinePacker( unsigned int width, unsigned int height ) :
+    dimensions_( width, height )
+{
+    clear();
+}
+
+
+/***
+ * 2. Getters
+ ***/
+
+sf::Vector2u SkylinePacker::dimensions() const
+{
+    return dimensions_;
+}
+
+
+unsigned int SkylinePacker::usedArea() const
+{
+    return usedArea_;
+}
+
+
+float SkylinePacker::occupancy() const
+{
+    return static_cast< float >( usedArea_ ) /
+            ( dimensions_.x * dimensions_.y );
+}
+
+
+/***
+ * 3. Packing
+ ***/
+
+bool SkylinePacker::insert( unsigned int width,
+                            unsigned int height,
+                            sf::Vector2u& position )
+{
+    unsigned int bestIndex = skyline_.size();
+    unsigned int bestTop = std::numeric_limits< unsigned int >::max();
+    unsigned int bestWidth = std::numeric_limits< unsigned int >::max();
+
+    for( unsigned int i = 0; i < skyline_.size(); i++ ){
+        unsigned int y;
+        if( fits( i, width, height, y ) ){
+            if( ( y + height < bestTop ) ||
+                ( y + height == bestTop && skyline_[i].width < bestWidth ) ){
+                bestIndex = i;
+                bestTop = y + height;
+                bestWidth = skyline_[i].width;
+                position = sf::Vector2u( skyline_[i].x, y );
+            }
+        }
+    }
+
+    if( bestIndex == skyline_.size() ){
+        return false;
+    }
+
+    addNode( bestIndex, position.x, position.y + height, width );
+    usedArea_ += width * height;
+
+    return true;
+}
+
+
+void SkylinePacker::clear()
+{
+    skyline_.clear();
+    skyline_.push_back( { 0, 0, dimensions_.x } );
+    usedArea_ = 0;
+}
+
+
+/***
+ * 4. Auxiliar methods
+ ***/
+
+bool SkylinePacker::fits( unsigned int nodeIndex,
+                          unsigned int width,
+                          unsigned int height,
+                          unsigned int& y ) const
+{
+    const unsigned int x = skyline_[nodeIndex].x;
+    if( x + width > dimensions_.x ){
+        return false;
+    }
+
+    // The rect rests on the highest node it spans.
+    int remainingWidth = width;
+    y = skyline_[nodeIndex].y;
+    while( remainingWidth > 0 ){
+        y = std::max( y, skyline_[nodeIndex].y );
+        if( y + height > dimensions_.y ){
+            return false;
+        }
+        remainingWidth -= skyline_[nodeIndex].width;
+        nodeIndex++;
+    }
+
+    return true;
+}
+
+
+void SkylinePacker::addNode( unsigned int nodeIndex,
+                             unsigned int x,
+                             unsigned int y,
+                             unsigned int width )
+{
+    skyline_.insert( skyline_.begin() + nodeIndex, { x, y, width } );
+
+    // Shrink or remove the nodes now hidden below the new one.
+    unsigned int i = nodeIndex + 1;
+    while( i < skyline_.size() ){
+        const unsigned int previousRight =
+                skyline_[i - 1].x + skyline_[i - 1].width;
+        if( skyline_[i].x >= previousRight ){
+            break;
+        }
+
+        const unsigned int shrink = previousRight - skyline_[i].x;
+        if( skyline_[i].width > shrink ){
+            skyline_[i].x += shrink;
+            skyline_[i].width -= shrink;
+            break;
+        }
+        skyline_.erase( skyline_.begin() + i );
+    }
+
+    // Merge neighbour nodes at the same height.
+    for( i = 0; i + 1 < skyline_.size(); ){
+        if( skyline_[i].y == skyline_[i + 1].y ){
+            skyline_[i].width += skyline_[i + 1].width;
+            skyline_.erase( skyline_.begin() + i + 1 );
+        }else{
+            i++;
+        }
+    }
+}
+
+} // namespace m2g
@@ -0,0 +1,88 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef SKYLINE_PACKER_HPP
+#define SKYLINE_PACKER_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+namespace m2g {
+
+// Bottom-left skyline rectangle packer. Keeps the upper contour ("skyline")
+// of the already placed rects and puts every new rect where its top edge
+// ends up the lowest.
+class SkylinePacker
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        SkylinePacker( unsigned int width, unsigned int height );
+
+
+        /***
+         * 2. Getters
+         ***/
+        sf::Vector2u dimensions() const;
+        unsigned int usedArea() const;
+        float occupancy() const;
+
+
+        /***
+         * 3. Packing
+         ***/
+        bool insert( unsigned int width,
+                     unsigned int height,
+                     sf::Vector2u& position );
+        void clear();
+
+
+    private:
+        /***
+         * 4. Auxiliar methods
+         ***/
+        bool fits( unsigned int nodeIndex,
+                   unsigned int width,
+                   unsigned int height,
+                   unsigned int& y ) const;
+        void addNode( unsigned int nodeIndex,
+                      unsigned int x,
+                      unsigned int y,
+                      unsigned int width );
+
+
+        /***
+         * Attributes
+         ***/
+        struct SkylineNode
+        {
+            unsigned int x;
+            unsigned int y;
+            unsigned int width;
+        };
+
+        sf::Vector2u dimensions_;
+        std::vector< SkylineNode > skyline_;
+        unsigned int usedArea_;
+};
+
+} // namespace m2g
+
+#endif // SKYLINE_PACKER_HPP
@@ -0,0 +1,245 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "stats.hpp"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+
+namespace m2g {
+
+namespace {
+
+// Every value has its own cache line so threads updating different stats
+// don't contend.
+struct alignas( 64 ) CounterSlot
+{
+    std::atomic< std::uint64_t > value;
+};
+
+struct alignas( 64 ) GaugeSlot
+{
+    std::atomic< std::int64_t > value;
+};
+
+CounterSlot counters[N_STAT_COUNTERS];
+GaugeSlot gauges[N_STAT_GAUGES];
+
+const char* COUNTER_NAMES[N_STAT_COUNTERS] =
+{
+    "tilesets_loaded",
+    "library_lookups",
+    "library_xml_parses",
+    "sprite_draws",
+    "sprite_collides",
+    "animation_updates"
+};
+
+const char* GAUGE_NAMES[N_STAT_GAUGES] =
+{
+    "textures",
+    "texture_bytes",
+    "tilesets",
+    "collision_rects"
+};
+
+
+std::int64_t textureBytes( const sf::Texture& texture )
+{
+    return static_cast< std::int64_t >( texture.getSize().x ) * texture.getSize().y * 4;
+}
+
+} // namespace
+
+
+/***
+ * StatsSnapshot
+ ***/
+
+void StatsSnapshot::writeJSON( std::ostream& out ) const
+{
+    out << "{";
+    for( unsigned int i = 0; i < N_STAT_COUNTERS; i++ ){
+        out << "\"" << COUNTER_NAMES[i] << "\":" << counters[i] << ",";
+    }
+    for( unsigned int i = 0; i < N_STAT_GAUGES; i++ ){
+        out << "\"" << GAUGE_NAMES[i] << "\":" << gauges[i]
+            << ( ( i + 1 < N_STAT_GAUGES ) ? "," : "" );
+    }
+    out << "}";
+}
+
+
+/***
+ * 1. Updating
+ ***/
+
+void Stats::increment( StatCounter counter, std::uint64_t n )
+{
+    counters[counter].value.fetch_add( n, std::memory_order_relaxed );
+}
+
+
+void Stats::add( StatGauge gauge, std::int64_t delta )
+{
+    gauges[gauge].value.fetch_add( delta, std::memory_order_relaxed );
+}
+
+
+std::shared_ptr< sf::Texture > Stats::trackTexture( std::unique_ptr< sf::Texture > texture )
+{
+    // The size is saved now, the texture could be recreated later.
+    const std::int64_t bytes = textureBytes( *texture );
+    add( STAT_TEXTURES, 1 );
+    add( STAT_TEXTURE_BYTES, bytes );
+
+    return std::shared_ptr< sf::Texture >( texture.release(), [bytes]( sf::Texture* texture ){
+        Stats::add( STAT_TEXTURES, -1 );
+        Stats::add( STAT_TEXTURE_BYTES, -bytes );
+        delete texture;
+    });
+}
+
+
+/***
+ * 2. Getters
+ ***/
+
+StatsSnapshot Stats::snapshot( bool resetCounters )
+{
+    StatsSnapshot snapshot;
+
+    for( unsigned int i = 0; i < N_STAT_COUNTERS; i++ ){
+        if( resetCounters ){
+            snapshot.counters[i] = counters[i].value.exchange( 0, std::memory_order_relaxed );
+        }else{
+            snapshot.counters[i] = counters[i].value.load( std::memory_order_relaxed );
+        }
+    }
+    for( unsigned int i = 0; i < N_STAT_GAUGES; i++ ){
+        snapshot.gauges[i] = gauges[i].value.load( std::memory_order_relaxed );
+    }
+
+    return snapshot;
+}
+
+
+const char* Stats::name( StatCounter counter )
+{
+    return COUNTER_NAMES[counter];
+}
+
+
+const char* Stats::name( StatGauge gauge )
+{
+    return GAUGE_NAMES[gauge];
+}
+
+
+/***
+ * StatContribution
+ ***/
+
+StatContribution::StatContribution( StatGauge gauge, std::int64_t value ) :
+    gauge_( gauge ),
+    value_( value )
+{
+    Stats::add( gauge_, value_ );
+}
+
+
+StatContribution::StatContribution( const StatContribution& b ) :
+    StatContribution( b.gauge_, b.value_ )
+{}
+
+
+StatContribution& StatContribution::operator = ( const StatContribution& b )
+{
+    Stats::add( gauge_, -value_ );
+    gauge_ = b.gauge_;
+    value_ = b.value_;
+    Stats::add( gauge_, value_ );
+
+    return *this;
+}
+
+
+StatContribution::~StatContribution()
+{
+    Stats::add( gauge_, -value_ );
+}
+
+
+void StatContribution::add( std::int64_t delta )
+{
+    value_ += delta;
+    Stats::add( gauge_, delta );
+}
+
+
+/***
+ * StatsDumper
+ ***/
+
+StatsDumper::StatsDumper( const std::string& filePath, unsigned int periodMs ) :
+    periodMs_( periodMs ),
+    stop_( false )
+{
+    std::shared_ptr< std::ofstream > file( new std::ofstream( filePath, std::ios::app ) );
+    if( !file->is_open() ){
+        throw std::runtime_error( "Couldn't open stats file [" + filePath + "]" );
+    }
+
+    thread_ = std::thread( [this, file](){
+        run( *file );
+    });
+}
+
+
+StatsDumper::~StatsDumper()
+{
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        stop_ = true;
+    }
+    stopCondition_.notify_one();
+    thread_.join();
+}
+
+
+void StatsDumper::run( std::ostream& file )
+{
+    std::unique_lock< std::mutex > lock( mutex_ );
+
+    // A last snapshot is written when stopping.
+    bool stop = false;
+    while( !stop ){
+        stop = stopCondition_.wait_for( lock,
+                                        std::chrono::milliseconds( periodMs_ ),
+                                        [this](){ return stop_; } );
+
+        // Counters are not reset, so the application can still take its own
+        // per-frame snapshots.
+        Stats::snapshot().writeJSON( file );
+        file << std::endl;
+    }
+}
+
+} // namespace m2g
@@ -0,0 +1,168 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <SFML/Graphics/Texture.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace m2g {
+
+// Monotonic counters of the work done by m2g.
+enum StatCounter
+{
+    STAT_TILESETS_LOADED = 0,
+    STAT_LIBRARY_LOOKUPS, // Names resolved into handles.
+    STAT_LIBRARY_XML_PARSES,
+    STAT_SPRITE_DRAWS,
+    STAT_SPRITE_COLLIDES,
+    STAT_ANIMATION_UPDATES,
+
+    N_STAT_COUNTERS
+};
+
+// Current values of the resources held by m2g.
+enum StatGauge
+{
+    STAT_TEXTURES = 0,
+    STAT_TEXTURE_BYTES,
+    STAT_TILESETS,
+    STAT_COLLISION_RECTS,
+
+    N_STAT_GAUGES
+};
+
+
+struct StatsSnapshot
+{
+    std::uint64_t counters[N_STAT_COUNTERS];
+    std::int64_t gauges[N_STAT_GAUGES];
+
+    void writeJSON( std::ostream& out ) const;
+};
+
+
+// Process-wide registry of counters and gauges. Updates are relaxed atomic
+// operations, so it is always enabled.
+class Stats
+{
+    public:
+        /***
+         * 1. Updating
+         ***/
+        static void increment( StatCounter counter, std::uint64_t n = 1 );
+        static void add( StatGauge gauge, std::int64_t delta );
+
+        // Accounts the given (already loaded) texture in STAT_TEXTURES and
+        // STAT_TEXTURE_BYTES until the returned pointer releases it.
+        static std::shared_ptr< sf::Texture > trackTexture( std::unique_ptr< sf::Texture > texture );
+
+
+        /***
+         * 2. Getters
+         ***/
+        // When resetCounters is true, counters restart from zero after being
+        // read, so calling snapshot( true ) once per frame gives per-frame
+        // counts.
+        static StatsSnapshot snapshot( bool resetCounters = false );
+        static const char* name( StatCounter counter );
+        static const char* name( StatGauge gauge );
+};
+
+
+// Quantity accounted in a gauge for as long as its owner (and every copy of
+// it) lives. Meant to be an attribute of the accounted class.
+class StatContribution
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        explicit StatContribution( StatGauge gauge, std::int64_t value = 0 );
+        StatContribution( const StatContribution& b );
+        StatContribution& operator = ( const StatContribution& b );
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~StatContribution();
+
+
+        /***
+         * 3. Updating
+         ***/
+        void add( std::int64_t delta );
+
+
+    private:
+        /***
+         * Attributes
+         ***/
+        StatGauge gauge_;
+        std::int64_t value_;
+};
+
+
+// Appends a JSON snapshot line to a file periodically from a background
+// thread, until destroyed.
+class StatsDumper
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        StatsDumper( const std::string& filePath, unsigned int periodMs );
+        StatsDumper( const StatsDumper& ) = delete;
+        StatsDumper& operator = ( const StatsDumper& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~StatsDumper();
+
+
+    private:
+        /***
+         * 3. Auxiliar methods
+         ***/
+        void run( std::ostream& file );
+
+
+        /***
+         * Attributes
+         ***/
+        const unsigned int periodMs_;
+        std::mutex mutex_;
+        std::condition_variable stopCondition_;
+        bool stop_;
+        std::thread thread_;
+};
+
+} // namespace m2g
+
+#endif // STATS_HPP
@@ -0,0 +1,86 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "swept_rect.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace m2g {
+
+namespace {
+
+// Times the moving [min, max] interval starts and stops overlapping the
+// target one along an axis. Returns false if they never overlap.
+bool sweepAxis( float min, float max, float delta,
+                float targetMin, float targetMax,
+                float& entry, float& exit )
+{
+    if( delta > 0.0f ){
+        entry = ( targetMin - max ) / delta;
+        exit = ( targetMax - min ) / delta;
+    }else if( delta < 0.0f ){
+        entry = ( targetMax - min ) / delta;
+        exit = ( targetMin - max ) / delta;
+    }else{
+        if( max <= targetMin || min >= targetMax ){
+            return false;
+        }
+        entry = -std::numeric_limits< float >::infinity();
+        exit = std::numeric_limits< float >::infinity();
+    }
+    return true;
+}
+
+} // namespace
+
+
+bool sweepRect( const sf::FloatRect& rect,
+                const sf::Vector2f& displacement,
+                const sf::FloatRect& target,
+                SweepHit& hit )
+{
+    float entryX, exitX, entryY, exitY;
+    if( !sweepAxis( rect.left, rect.left + rect.width, displacement.x,
+                    target.left, target.left + target.width, entryX, exitX ) ||
+            !sweepAxis( rect.top, rect.top + rect.height, displacement.y,
+                        target.top, target.top + target.height, entryY, exitY ) ){
+        return false;
+    }
+
+    // Rects intersect while they overlap along both axes.
+    const float entry = std::max( entryX, entryY );
+    const float exit = std::min( exitX, exitY );
+    if( entry >= exit || entry >= 1.0f || exit <= 0.0f ){
+        return false;
+    }
+
+    if( entry < 0.0f ){
+        hit.time = 0.0f;
+        hit.normal = sf::Vector2f( 0.0f, 0.0f );
+    }else if( entryX > entryY ){
+        hit.time = entry;
+        hit.normal = sf::Vector2f( ( displacement.x > 0.0f ) ? -1.0f : 1.0f, 0.0f );
+    }else{
+        hit.time = entry;
+        hit.normal = sf::Vector2f( 0.0f, ( displacement.y > 0.0f ) ? -1.0f : 1.0f );
+    }
+    return true;
+}
+
+} // namespace m2g
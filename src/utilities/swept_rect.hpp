@@ -0,0 +1,50 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef SWEPT_RECT_HPP
+#define SWEPT_RECT_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+
+namespace m2g {
+
+// First contact of a moving rect.
+struct SweepHit
+{
+    // Fraction of the displacement done before the contact, in [0, 1).
+    float time;
+
+    // Normal of the surface hit, pointing against the displacement, or
+    // (0, 0) if both rects already intersected.
+    sf::Vector2f normal;
+};
+
+
+// Swept test of rect moving by displacement against a still target.
+// Returns false if they never intersect along the way. As with
+// sf::FloatRect::intersects(), rects only touching each other (even while
+// sliding along each other) don't intersect.
+bool sweepRect( const sf::FloatRect& rect,
+                const sf::Vector2f& displacement,
+                const sf::FloatRect& target,
+                SweepHit& hit );
+
+} // namespace m2g
+
+#endif // SWEPT_RECT_HPP
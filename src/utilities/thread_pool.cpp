@@ -0,0 +1,143 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "thread_pool.hpp"
+#include <algorithm>
+
+namespace m2g {
+
+/***
+ * 1. Construction
+ ***/
+
+ThreadPool::ThreadPool( unsigned int nThreads ) :
+    batch_( 0 ),
+    nBusyWorkers_( 0 ),
+    stopping_( false ),
+    task_( nullptr ),
+    nTasks_( 0 ),
+    nextTask_( 0 )
+{
+    if( nThreads == 0 ){
+        nThreads = std::max( std::thread::hardware_concurrency(), 1u );
+    }
+    for( unsigned int i = 1; i < nThreads; i++ ){
+        workers_.emplace_back( &ThreadPool::work, this );
+    }
+}
+
+
+/***
+ * 2. Destruction
+ ***/
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        stopping_ = true;
+    }
+    batchStarted_.notify_all();
+    for( std::thread& worker : workers_ ){
+        worker.join();
+    }
+}
+
+
+/***
+ * 3. Getters
+ ***/
+
+unsigned int ThreadPool::nThreads() const
+{
+    return workers_.size() + 1;
+}
+
+
+/***
+ * 4. Running
+ ***/
+
+void ThreadPool::run( unsigned int nTasks, const std::function< void( unsigned int ) >& task )
+{
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        task_ = &task;
+        nTasks_ = nTasks;
+        nextTask_ = 0;
+        nBusyWorkers_ = workers_.size();
+        exception_ = nullptr;
+        batch_++;
+    }
+    batchStarted_.notify_all();
+
+    runPendingTasks();
+
+    std::unique_lock< std::mutex > lock( mutex_ );
+    batchFinished_.wait( lock, [this](){ return nBusyWorkers_ == 0; } );
+    task_ = nullptr;
+    if( exception_ ){
+        std::rethrow_exception( exception_ );
+    }
+}
+
+
+/***
+ * 5. Auxiliar methods
+ ***/
+
+void ThreadPool::work()
+{
+    unsigned int lastBatch = 0;
+    std::unique_lock< std::mutex > lock( mutex_ );
+    while( true ){
+        batchStarted_.wait( lock, [&](){ return stopping_ || batch_ != lastBatch; } );
+        if( stopping_ ){
+            return;
+        }
+        lastBatch = batch_;
+
+        lock.unlock();
+        runPendingTasks();
+        lock.lock();
+
+        nBusyWorkers_--;
+        if( nBusyWorkers_ == 0 ){
+            batchFinished_.notify_one();
+        }
+    }
+}
+
+
+void ThreadPool::runPendingTasks()
+{
+    unsigned int i;
+    while( ( i = nextTask_++ ) < nTasks_ ){
+        try{
+            ( *task_ )( i );
+        }catch( ... ){
+            std::lock_guard< std::mutex > lock( mutex_ );
+            if( !exception_ ){
+                exception_ = std::current_exception();
+            }
+        }
+    }
+}
+
+} // namespace m2g
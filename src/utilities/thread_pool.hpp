@@ -0,0 +1,100 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace m2g {
+
+// Fixed set of worker threads running batches of numbered tasks. Meant for
+// per-frame work: workers sleep between batches instead of being created
+// every time.
+class ThreadPool
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        // nThreads counts the thread calling run(), which works too, so a
+        // pool of one thread has no workers. 0 means one thread per
+        // hardware thread.
+        explicit ThreadPool( unsigned int nThreads = 0 );
+        ThreadPool( const ThreadPool& ) = delete;
+        ThreadPool& operator = ( const ThreadPool& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~ThreadPool();
+
+
+        /***
+         * 3. Getters
+         ***/
+        unsigned int nThreads() const;
+
+
+        /***
+         * 4. Running
+         ***/
+        // Calls task( i ) for every i in [0, nTasks), in any order and
+        // thread, and waits for all of them. If any task throws, the first
+        // exception is rethrown once the batch is finished. Not reentrant.
+        void run( unsigned int nTasks, const std::function< void( unsigned int ) >& task );
+
+
+    private:
+        /***
+         * 5. Auxiliar methods
+         ***/
+        void work();
+        // Runs tasks of the current batch until there are no more left.
+        void runPendingTasks();
+
+
+        /***
+         * Attributes
+         ***/
+        std::vector< std::thread > workers_;
+
+        std::mutex mutex_;
+        std::condition_variable batchStarted_;
+        std::condition_variable batchFinished_;
+        unsigned int batch_;
+        unsigned int nBusyWorkers_;
+        bool stopping_;
+
+        const std::function< void( unsigned int ) >* task_;
+        unsigned int nTasks_;
+        std::atomic< unsigned int > nextTask_;
+        std::exception_ptr exception_;
+};
+
+} // namespace m2g
+
+#endif // THREAD_POOL_HPP
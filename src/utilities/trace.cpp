@@ -0,0 +1,248 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace m2g {
+
+namespace {
+
+struct TraceEvent
+{
+    const char* name;
+    std::uint64_t startNs;
+    std::uint64_t durationNs;
+};
+
+
+// Single producer ring buffer: only its thread writes events, readers use
+// nWritten to know which slots are valid.
+struct TraceBuffer
+{
+    TraceBuffer( unsigned int threadId ) :
+        threadId( threadId ),
+        events( TRACE_BUFFER_CAPACITY ),
+        nWritten( 0 ),
+        firstValid( 0 ),
+        alive( true )
+    {}
+
+    const unsigned int threadId;
+    std::vector< TraceEvent > events;
+    std::atomic< std::uint64_t > nWritten;
+    std::atomic< std::uint64_t > firstValid;
+    // False once its thread exited (and won't write anymore).
+    std::atomic< bool > alive;
+};
+
+
+// Buffers outlive their threads so their events can still be exported, and
+// are dropped by the next export (or clear). The mutex is only taken when a
+// thread records its first event and when exporting.
+std::mutex buffersMutex;
+std::vector< std::shared_ptr< TraceBuffer > > buffers;
+unsigned int nextThreadId = 1;
+
+
+// Retires the buffer of its thread when the thread exits.
+struct ThreadBufferHolder
+{
+    ~ThreadBufferHolder()
+    {
+        if( buffer ){
+            buffer->alive.store( false, std::memory_order_release );
+        }
+    }
+
+    std::shared_ptr< TraceBuffer > buffer;
+};
+
+
+TraceBuffer& threadBuffer()
+{
+    thread_local ThreadBufferHolder holder;
+
+    if( !holder.buffer ){
+        std::lock_guard< std::mutex > lock( buffersMutex );
+        holder.buffer = std::make_shared< TraceBuffer >( nextThreadId++ );
+        buffers.push_back( holder.buffer );
+    }
+
+    return *( holder.buffer );
+}
+
+
+// Drops the buffers of exited threads. Call it with buffersMutex locked.
+void dropDeadBuffers( const std::vector< std::shared_ptr< TraceBuffer > >& deadBuffers )
+{
+    buffers.erase( std::remove_if( buffers.begin(), buffers.end(),
+                                   [&]( const std::shared_ptr< TraceBuffer >& buffer ){
+                                       return std::find( deadBuffers.begin(),
+                                                         deadBuffers.end(),
+                                                         buffer ) != deadBuffers.end();
+                                   }),
+                   buffers.end() );
+}
+
+} // namespace
+
+
+/***
+ * 1. Recording
+ ***/
+
+std::uint64_t Trace::now()
+{
+    typedef std::chrono::steady_clock Clock;
+    static const Clock::time_point epoch = Clock::now();
+
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( Clock::now() - epoch ).count();
+}
+
+
+void Trace::record( const char* name,
+                    std::uint64_t startNs,
+                    std::uint64_t durationNs )
+{
+    TraceBuffer& buffer = threadBuffer();
+    const std::uint64_t index = buffer.nWritten.load( std::memory_order_relaxed );
+
+    TraceEvent& event = buffer.events[index % TRACE_BUFFER_CAPACITY];
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+
+    buffer.nWritten.store( index + 1, std::memory_order_release );
+}
+
+
+/***
+ * 2. Export
+ ***/
+
+void Trace::writeChromeTrace( std::ostream& out )
+{
+    std::lock_guard< std::mutex > lock( buffersMutex );
+    bool firstEvent = true;
+
+    out << "{\"traceEvents\":[" << std::endl;
+    out << std::fixed << std::setprecision( 3 );
+
+    std::vector< std::shared_ptr< TraceBuffer > > deadBuffers;
+    for( const std::shared_ptr< TraceBuffer >& buffer : buffers ){
+        // Checked first: buffers of exited threads can't change while they
+        // are copied.
+        const bool alive = buffer->alive.load( std::memory_order_acquire );
+        if( !alive ){
+            deadBuffers.push_back( buffer );
+        }
+        const std::uint64_t end = buffer->nWritten.load( std::memory_order_acquire );
+        std::uint64_t begin = buffer->firstValid.load( std::memory_order_relaxed );
+        if( end - begin > TRACE_BUFFER_CAPACITY ){
+            begin = end - TRACE_BUFFER_CAPACITY;
+        }
+
+        std::vector< TraceEvent > events;
+        for( std::uint64_t i = begin; i < end; i++ ){
+            events.push_back( buffer->events[i % TRACE_BUFFER_CAPACITY] );
+        }
+
+        // Skip the events the thread could have overwritten while we were
+        // copying them, including the slot it may be writing right now.
+        const std::uint64_t endAfterCopy =
+                buffer->nWritten.load( std::memory_order_acquire ) + ( alive ? 1 : 0 );
+        std::uint64_t nOverwritten = 0;
+        if( endAfterCopy - begin > TRACE_BUFFER_CAPACITY ){
+            nOverwritten = std::min< std::uint64_t >( endAfterCopy - begin - TRACE_BUFFER_CAPACITY,
+                                                      events.size() );
+        }
+
+        for( std::uint64_t i = nOverwritten; i < events.size(); i++ ){
+            const TraceEvent& event = events[i];
+            if( !firstEvent ){
+                out << "," << std::endl;
+            }
+            firstEvent = false;
+
+            out << "{\"name\":\"" << event.name << "\","
+                << "\"cat\":\"m2g\","
+                << "\"ph\":\"X\","
+                << "\"ts\":" << event.startNs / 1000.0 << ","
+                << "\"dur\":" << event.durationNs / 1000.0 << ","
+                << "\"pid\":1,"
+                << "\"tid\":" << buffer->threadId << "}";
+        }
+    }
+
+    out << std::endl << "]}" << std::endl;
+    dropDeadBuffers( deadBuffers );
+}
+
+
+void Trace::saveChromeTrace( const std::string& filePath )
+{
+    std::ofstream file( filePath );
+    if( !file.is_open() ){
+        throw std::runtime_error( "Couldn't write trace file [" + filePath + "]" );
+    }
+    writeChromeTrace( file );
+}
+
+
+void Trace::clear()
+{
+    std::lock_guard< std::mutex > lock( buffersMutex );
+
+    std::vector< std::shared_ptr< TraceBuffer > > deadBuffers;
+    for( const std::shared_ptr< TraceBuffer >& buffer : buffers ){
+        if( !buffer->alive.load( std::memory_order_acquire ) ){
+            deadBuffers.push_back( buffer );
+        }
+        buffer->firstValid.store( buffer->nWritten.load( std::memory_order_acquire ),
+                                  std::memory_order_relaxed );
+    }
+    dropDeadBuffers( deadBuffers );
+}
+
+
+/***
+ * TraceScope
+ ***/
+
+TraceScope::TraceScope( const char* name ) :
+    name_( name ),
+    startNs_( Trace::now() )
+{}
+
+
+TraceScope::~TraceScope()
+{
+    Trace::record( name_, startNs_, Trace::now() - startNs_ );
+}
+
+} // namespace m2g
@@ -0,0 +1,103 @@
+/***
+ * Copyright 2013 - 2015 Moises J. Bonilla Caraballo (Neodivert)
+ *
+ * This file is part of M2G.
+ *
+ * M2G is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * M2G is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with M2G.  If not, see <http://www.gnu.org/licenses/>.
+***/
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// Scoped trace zones. They are compiled out unless M2G_TRACE is defined
+// (cmake -DTRACE=1), so they cost nothing in regular builds. Zone names must
+// be string literals (only the pointer is recorded).
+#ifdef M2G_TRACE
+#define M2G_TRACE_CONCAT_IMPL( a, b ) a##b
+#define M2G_TRACE_CONCAT( a, b ) M2G_TRACE_CONCAT_IMPL( a, b )
+#define M2G_TRACE_SCOPE( name ) \
+    m2g::TraceScope M2G_TRACE_CONCAT( m2gTraceScope, __LINE__ )( name )
+#else
+#define M2G_TRACE_SCOPE( name ) static_cast< void >( 0 )
+#endif
+
+namespace m2g {
+
+// Number of events kept per thread. When a thread records more events,
+// the oldest ones are overwritten.
+const unsigned int TRACE_BUFFER_CAPACITY = 16384;
+
+// Records trace zones into per-thread ring buffers. Every thread only writes
+// to its own buffer, so recording takes no locks.
+class Trace
+{
+    public:
+        /***
+         * 1. Recording
+         ***/
+        // Nanoseconds since the first call to now().
+        static std::uint64_t now();
+        static void record( const char* name,
+                            std::uint64_t startNs,
+                            std::uint64_t durationNs );
+
+
+        /***
+         * 2. Export
+         ***/
+        // Writes the recorded zones in Chrome's trace event format
+        // (chrome://tracing, Perfetto). Events their thread may overwrite
+        // while exporting are skipped. Events of threads which exited are
+        // only exported once.
+        static void writeChromeTrace( std::ostream& out );
+        static void saveChromeTrace( const std::string& filePath );
+
+        // Discards every event recorded so far.
+        static void clear();
+};
+
+
+// Records a zone lasting from its construction to its destruction.
+class TraceScope
+{
+    public:
+        /***
+         * 1. Construction
+         ***/
+        explicit TraceScope( const char* name );
+        TraceScope( const TraceScope& ) = delete;
+        TraceScope& operator = ( const TraceScope& ) = delete;
+
+
+        /***
+         * 2. Destruction
+         ***/
+        ~TraceScope();
+
+
+    private:
+        /***
+         * Attributes
+         ***/
+        const char* name_;
+        std::uint64_t startNs_;
+};
+
+} // namespace m2g
+
+#endif // TRACE_HPP